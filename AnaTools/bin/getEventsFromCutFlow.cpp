@@ -1,9 +1,17 @@
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <map>
 #include <string>
 #include <sstream>
 #include <cstdlib>
 #include <iomanip>
+#include <thread>
+#include <vector>
 
+#include <unistd.h>
+
+#include "RVersion.h"
 #include "TFile.h"
 #include "TDirectoryFile.h"
 #include "TKey.h"
@@ -11,22 +19,62 @@
 #include "TAxis.h"
 #include "TTree.h"
 
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+  #include "TROOT.h"
+#endif
+
 using namespace std;
 
+struct CutFlowSummary
+{
+  bool hasEventCounter;
+  bool hasCutFlow;
+  double eventCounter;
+  vector<string> labels;
+  vector<double> contents;
+
+  CutFlowSummary () : hasEventCounter (false), hasCutFlow (false), eventCounter (0.0) {};
+};
+
+struct FileSummary
+{
+  bool valid;
+  bool edm;
+  double edmEvents;
+  double totalEvents;
+  vector<pair<string, CutFlowSummary> > cutFlows;
+
+  FileSummary () : valid (false), edm (false), edmEvents (0.0), totalEvents (0.0) {};
+};
+
 void printHelp (const string &);
+void parseOptions (int, char *[], map<string, string> &, vector<string> &);
 unsigned isEDM (TFile *, bool &);
+int summarizeFiles (const vector<string> &, const string &, const string &, unsigned);
+void summarizeFile (const string &, const string &, const string &, FileSummary &);
+void printJSON (const vector<string> &, const vector<FileSummary> &);
+void printCutFlow (const CutFlowSummary &, const string &);
+string jsonString (const string &);
 
 int
 main (int argc, char *argv[])
 {
-  if (argc != 3)
+  map<string, string> opt;
+  vector<string> argVector;
+  parseOptions (argc, argv, opt, argVector);
+  if (opt.count ("json") && !opt.count ("help") && !argVector.empty ())
+    {
+      unsigned nJobs = opt.count ("jobs") ? atoi (opt.at ("jobs").c_str ()) : sysconf (_SC_NPROCESSORS_ONLN);
+      return summarizeFiles (argVector, opt.count ("dir") ? opt.at ("dir") : "CutFlow", opt.count ("hist") ? opt.at ("hist") : "cutFlow", nJobs);
+    }
+  if (argVector.size () != 2 || opt.size ())
     {
       printHelp (argv[0]);
       return 0;
     }
-  string fileName = argv[1],
-         histName = argv[2],
-         HistName = argv[2];
+  string fileName = argVector.at (0),
+         histName = argVector.at (1),
+         HistName = argVector.at (1);
   TFile *fin;
   HistName[0] = toupper (HistName[0]);
   if (!(fin = TFile::Open (fileName.c_str ())))
@@ -120,8 +168,47 @@ void
 printHelp (const string &exeName)
 {
   printf ("Usage: %s FILE HIST\n", exeName.c_str ());
+  printf ("   or: %s --json [OPTION]... FILE...\n", exeName.c_str ());
   printf ("Prints the total number of events based on the cutflow in HIST from the given\n");
   printf ("ROOT file.\n");
+  printf ("\n");
+  printf ("With --json, reads the cut flows, or the number of events in EDM files, from\n");
+  printf ("each FILE in parallel, and prints them, along with their sums, as JSON.\n");
+  printf ("\n");
+  printf ("  -d, --dir PATTERN  read the directories whose names contain PATTERN\n");
+  printf ("                     (default: CutFlow)\n");
+  printf ("  -H, --hist NAME    name of the cut-flow histograms (default: cutFlow)\n");
+  printf ("  -j, --jobs N       read at most N files at once (default: number of CPUs)\n");
+  printf ("  -h, --help         print this help\n");
+}
+
+void
+parseOptions (int argc, char *argv[], map<string, string> &opt, vector<string> &argVector)
+{
+  for (int i = 1; i < argc; i++)
+    {
+      if (argv[i][0] != '-')
+        {
+          argVector.push_back (argv[i]);
+          continue;
+        }
+      int offset = 1;
+      if (argv[i][1] == '-')
+        offset++;
+      string key = argv[i] + offset,
+             value = "";
+      if (key == "h")
+        key = "help";
+      if (key == "d")
+        key = "dir";
+      if (key == "H")
+        key = "hist";
+      if (key == "j")
+        key = "jobs";
+      if ((key == "dir" || key == "hist" || key == "jobs") && i + 1 < argc)
+        value = argv[++i];
+      opt[key] = value;
+    }
 }
 
 unsigned
@@ -141,3 +228,244 @@ isEDM (TFile *f, bool &fileIsEDM)
     return events->GetEntries ();
   return 0;
 }
+
+int
+summarizeFiles (const vector<string> &fileNames, const string &dirPattern, const string &histName, unsigned nJobs)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Each worker takes the next file that has not been read yet. Reading
+  // different files in different threads is only safe in ROOT 6, so the files
+  // are read one at a time in ROOT 5.
+  //////////////////////////////////////////////////////////////////////////////
+  vector<FileSummary> summaries (fileNames.size ());
+  atomic<unsigned> nextFile (0);
+  auto worker = [&] ()
+    {
+      for (unsigned i; (i = nextFile++) < fileNames.size (); )
+        summarizeFile (fileNames.at (i), dirPattern, histName, summaries.at (i));
+    };
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+  nJobs = max (min (nJobs, (unsigned) fileNames.size ()), 1u);
+  if (nJobs > 1)
+    ROOT::EnableThreadSafety ();
+#else
+  nJobs = 1;
+#endif
+  vector<thread> workers;
+  for (unsigned i = 1; i < nJobs; i++)
+    workers.emplace_back (worker);
+  worker ();
+  for (auto &t : workers)
+    t.join ();
+  //////////////////////////////////////////////////////////////////////////////
+
+  printJSON (fileNames, summaries);
+  return 0;
+}
+
+void
+summarizeFile (const string &fileName, const string &dirPattern, const string &histName, FileSummary &summary)
+{
+  TFile *fin = TFile::Open (fileName.c_str ());
+  if (!fin || fin->IsZombie ())
+    {
+      delete fin;
+      return;
+    }
+  summary.valid = true;
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Only the keys are checked for the EDM trees, and only the header of the
+  // Events tree is read.
+  //////////////////////////////////////////////////////////////////////////////
+  summary.edm = true;
+  for (const auto &treeName : {"MetaData", "ParameterSets", "Parentage", "Events", "LuminosityBlocks", "Runs"})
+    summary.edm = summary.edm && fin->GetKey (treeName);
+  if (summary.edm)
+    {
+      TTree *events = (TTree *) fin->Get ("Events");
+      summary.edmEvents = events ? events->GetEntries () : 0.0;
+      delete events;
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Only the event counter and the cut flow are read from each matching
+  // directory. As in mergeUtilities.py, the total number of events is taken
+  // from the last directory with both, since they all have the same event
+  // counter.
+  //////////////////////////////////////////////////////////////////////////////
+  TIter next (fin->GetListOfKeys ());
+  TKey *key;
+  while ((key = (TKey *) next ()))
+    {
+      string dirName = key->GetName ();
+      if (string (key->GetClassName ()) != "TDirectoryFile" || dirName.find (dirPattern) == string::npos)
+        continue;
+
+      summary.cutFlows.push_back (make_pair (dirName, CutFlowSummary ()));
+      CutFlowSummary &cutFlow = summary.cutFlows.back ().second;
+      TH1 *eventCounter = NULL, *cutFlowHist = NULL;
+      fin->GetObject ((dirName + "/eventCounter").c_str (), eventCounter);
+      fin->GetObject ((dirName + "/" + histName).c_str (), cutFlowHist);
+
+      summary.totalEvents = 0.0;
+      if (eventCounter)
+        {
+          cutFlow.hasEventCounter = true;
+          cutFlow.eventCounter = eventCounter->GetBinContent (1);
+        }
+      if (cutFlowHist)
+        {
+          cutFlow.hasCutFlow = true;
+          for (int i = 1; i <= cutFlowHist->GetNbinsX (); i++)
+            {
+              cutFlow.labels.push_back (cutFlowHist->GetXaxis ()->GetBinLabel (i));
+              cutFlow.contents.push_back (cutFlowHist->GetBinContent (i));
+            }
+        }
+      if (eventCounter && cutFlowHist)
+        summary.totalEvents = cutFlow.eventCounter;
+
+      delete eventCounter;
+      delete cutFlowHist;
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  fin->Close ();
+  delete fin;
+}
+
+void
+printJSON (const vector<string> &fileNames, const vector<FileSummary> &summaries)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // The cut flows with the same directory name are summed bin by bin over all
+  // the files, with the labels taken from the first file that has them.
+  //////////////////////////////////////////////////////////////////////////////
+  vector<pair<string, CutFlowSummary> > sums;
+  map<string, unsigned> sumIndices;
+  vector<string> badFiles;
+  double totalEvents = 0.0, edmEvents = 0.0;
+  for (unsigned i = 0; i < summaries.size (); i++)
+    {
+      const FileSummary &summary = summaries.at (i);
+      if (!summary.valid)
+        badFiles.push_back (fileNames.at (i));
+      totalEvents += summary.totalEvents;
+      edmEvents += summary.edmEvents;
+      for (const auto &cutFlow : summary.cutFlows)
+        {
+          if (!sumIndices.count (cutFlow.first))
+            {
+              sumIndices[cutFlow.first] = sums.size ();
+              sums.push_back (make_pair (cutFlow.first, CutFlowSummary ()));
+            }
+          CutFlowSummary &sum = sums.at (sumIndices.at (cutFlow.first)).second;
+          if (cutFlow.second.hasEventCounter)
+            {
+              sum.hasEventCounter = true;
+              sum.eventCounter += cutFlow.second.eventCounter;
+            }
+          if (cutFlow.second.hasCutFlow)
+            {
+              if (!sum.hasCutFlow)
+                sum.labels = cutFlow.second.labels;
+              sum.hasCutFlow = true;
+              sum.contents.resize (max (sum.contents.size (), cutFlow.second.contents.size ()), 0.0);
+              for (unsigned j = 0; j < cutFlow.second.contents.size (); j++)
+                sum.contents.at (j) += cutFlow.second.contents.at (j);
+            }
+        }
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  cout << setprecision (16);
+  cout << "{" << endl;
+  cout << "  \"files\": {" << endl;
+  for (unsigned i = 0; i < summaries.size (); i++)
+    {
+      const FileSummary &summary = summaries.at (i);
+      cout << "    " << jsonString (fileNames.at (i)) << ": {" << endl;
+      cout << "      \"valid\": " << (summary.valid ? "true" : "false") << "," << endl;
+      cout << "      \"edm\": " << (summary.edm ? "true" : "false") << "," << endl;
+      cout << "      \"edmEvents\": " << summary.edmEvents << "," << endl;
+      cout << "      \"totalEvents\": " << summary.totalEvents << "," << endl;
+      cout << "      \"cutFlows\": {";
+      for (unsigned j = 0; j < summary.cutFlows.size (); j++)
+        {
+          cout << (j ? "," : "") << endl << "        " << jsonString (summary.cutFlows.at (j).first) << ": ";
+          printCutFlow (summary.cutFlows.at (j).second, "        ");
+        }
+      cout << (summary.cutFlows.empty () ? "" : "\n      ") << "}" << endl;
+      cout << "    }" << (i + 1 < summaries.size () ? "," : "") << endl;
+    }
+  cout << "  }," << endl;
+  cout << "  \"badFiles\": [";
+  for (unsigned i = 0; i < badFiles.size (); i++)
+    cout << (i ? ", " : "") << jsonString (badFiles.at (i));
+  cout << "]," << endl;
+  cout << "  \"edmEvents\": " << edmEvents << "," << endl;
+  cout << "  \"totalEvents\": " << totalEvents << "," << endl;
+  cout << "  \"cutFlows\": {";
+  for (unsigned i = 0; i < sums.size (); i++)
+    {
+      cout << (i ? "," : "") << endl << "    " << jsonString (sums.at (i).first) << ": ";
+      printCutFlow (sums.at (i).second, "    ");
+    }
+  cout << (sums.empty () ? "" : "\n  ") << "}" << endl;
+  cout << "}" << endl;
+}
+
+void
+printCutFlow (const CutFlowSummary &cutFlow, const string &indent)
+{
+  cout << "{" << endl;
+  cout << indent << "  \"eventCounter\": ";
+  if (cutFlow.hasEventCounter)
+    cout << cutFlow.eventCounter;
+  else
+    cout << "null";
+  cout << "," << endl;
+  cout << indent << "  \"labels\": ";
+  if (cutFlow.hasCutFlow)
+    {
+      cout << "[";
+      for (unsigned i = 0; i < cutFlow.labels.size (); i++)
+        cout << (i ? ", " : "") << jsonString (cutFlow.labels.at (i));
+      cout << "]";
+    }
+  else
+    cout << "null";
+  cout << "," << endl;
+  cout << indent << "  \"cutFlow\": ";
+  if (cutFlow.hasCutFlow)
+    {
+      cout << "[";
+      for (unsigned i = 0; i < cutFlow.contents.size (); i++)
+        cout << (i ? ", " : "") << cutFlow.contents.at (i);
+      cout << "]";
+    }
+  else
+    cout << "null";
+  cout << endl << indent << "}";
+}
+
+string
+jsonString (const string &s)
+{
+  stringstream ss;
+  ss << "\"";
+  for (const auto &c : s)
+    {
+      if (c == '"' || c == '\\')
+        ss << '\\' << c;
+      else if ((unsigned char) c < 0x20)
+        ss << "\\u" << hex << setw (4) << setfill ('0') << (int) c << dec;
+      else
+        ss << c;
+    }
+  ss << "\"";
+  return ss.str ();
+}
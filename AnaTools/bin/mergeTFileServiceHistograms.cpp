@@ -4,6 +4,7 @@
 #include <TH1.h>
 #include <TH2.h>
 #include <TH3.h>
+#include <TTree.h>
 #include <TDirectory.h>
 #include <TList.h>
 #include <TMath.h>
@@ -11,6 +12,7 @@
 #include <boost/program_options.hpp>
 #include <string>
 #include <vector>
+#include <set>
 #include <iostream>
 #include <algorithm>
 #include <cassert>
@@ -185,6 +187,7 @@ void make(TDirectory & out, TObject * o) {
   TH2D * th2d;
   TH3F * th3f;
   TH3D * th3d;
+  TTree * tree;
   out.cd();
   if (!dir && exists)
     return;
@@ -236,6 +239,11 @@ void make(TDirectory & out, TObject * o) {
     h->Reset();
     h->Sumw2();
     h->SetDirectory(&out);
+  } else if((tree = dynamic_cast<TTree*>(o)) != 0) {
+    // Trees, e.g., the selection trees of CutCalculator, are concatenated,
+    // without weights.
+    TTree *t = tree->CloneTree(0);
+    t->SetDirectory(&out);
   }
 }
 
@@ -247,6 +255,7 @@ void fill(TDirectory & out, TObject * o, double w) {
   TH2D * th2d;
   TH3F * th3f;
   TH3D * th3d;
+  TTree * tree;
   if((dir  = dynamic_cast<TDirectory*>(o)) != 0) {
     const char * name = dir->GetName();
     TDirectory * outDir = dynamic_cast<TDirectory*>(out.Get(name));
@@ -254,11 +263,19 @@ void fill(TDirectory & out, TObject * o, double w) {
       cerr << "can't find directory " << name << " in output file" << endl;
       exit(-1);
     }
+    // The histograms written by ModuleTimer hold total times and numbers of
+    // calls, which are summed without the cross-section weight.
+    if(string(name) == "Timing")
+      w = 1.0;
     TIter next(dir->GetListOfKeys());
     TKey *key;
+    set<string> treeNames;
     while( (key = dynamic_cast<TKey*>(next())) ) {
       string className(key->GetClassName());
       string name(key->GetName());
+      // Get always returns the highest cycle, so each tree is only copied once.
+      if(className == "TTree" && !treeNames.insert(name).second)
+        continue;
       TObject * obj = dir->Get(name.c_str());
       if(obj == 0) {
         cerr <<"error: key " << name << " not found in directory " << dir->GetName() << endl;
@@ -338,6 +355,14 @@ void fill(TDirectory & out, TObject * o, double w) {
     TList *list = new TList();
     list->Add(th3d);
     outTh3d->Merge(list);
+  } else if((tree = dynamic_cast<TTree*>(o)) != 0) {
+    const char * name = tree->GetName();
+    TTree * outTree = dynamic_cast<TTree*>(out.Get(name));
+    if(outTree == 0) {
+      cerr <<"error: tree " << name << " not found in directory " << out.GetName() << endl;
+      exit(-1);
+    }
+    outTree->CopyEntries(tree);
   }
 }
 
@@ -0,0 +1,170 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+
+#include "FWCore/FWLite/interface/FWLiteEnabler.h"
+
+#include "OSUT3Analysis/AnaTools/interface/ValueLookupTree.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+// Checks cut strings, or any other expressions given to ValueLookupTree, with
+// the same checks done by CutCalculator and Plotter when they are constructed,
+// without having to start a cmsRun job. Each expression is given together with
+// its input collections, either on the command line or in a file, and the
+// first problem found in each is printed.
+////////////////////////////////////////////////////////////////////////////////
+
+struct Expression
+{
+  vector<string> inputCollections;
+  string expression;
+};
+
+bool readExpressions (const string &, vector<Expression> &);
+vector<string> splitCollections (const string &);
+string trim (const string &);
+void printHelp (const string &);
+void parseOptions (int, char *[], map<string, string> &, vector<string> &);
+
+int
+main (int argc, char *argv[])
+{
+  map<string, string> opt;
+  vector<string> argVector;
+  parseOptions (argc, argv, opt, argVector);
+  if (opt.count ("help") || (argVector.empty () && !opt.count ("file")) || (!argVector.empty () && !opt.count ("collections")))
+    {
+      printHelp (argv[0]);
+      return 0;
+    }
+
+  vector<Expression> expressions;
+  for (const auto &arg : argVector)
+    expressions.push_back ({splitCollections (opt.at ("collections")), arg});
+  if (opt.count ("file") && !readExpressions (opt.at ("file"), expressions))
+    {
+      cerr << "Failed to read \"" << opt.at ("file") << "\"!" << endl;
+      return 1;
+    }
+
+  // Needed so that the dictionaries of the OSU classes can be found.
+  FWLiteEnabler::enable ();
+
+  unsigned nErrors = 0;
+  for (const auto &expression : expressions)
+    {
+      string message;
+      ValueLookupTree valueLookupTree (expression.expression, expression.inputCollections);
+      if (valueLookupTree.validate (message))
+        cout << "OK     " << expression.expression << endl;
+      else
+        {
+          cout << "ERROR  " << expression.expression << endl
+               << "       " << message << endl;
+          nErrors++;
+        }
+    }
+
+  if (nErrors)
+    cout << endl << nErrors << " of " << expressions.size () << " expressions are invalid" << endl;
+  return (nErrors ? 1 : 0);
+}
+
+bool
+readExpressions (const string &fileName, vector<Expression> &expressions)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Each line has the form "muons, jets: deltaR (muon, jet) > 0.5". Empty lines
+  // and everything after a "#" are ignored.
+  //////////////////////////////////////////////////////////////////////////////
+  ifstream fin (fileName);
+  if (!fin.is_open ())
+    return false;
+
+  string line;
+  while (getline (fin, line))
+    {
+      line = trim (line.substr (0, line.find ('#')));
+      if (line.empty ())
+        continue;
+      size_t colon = line.find (':');
+      if (colon == string::npos)
+        {
+          cerr << "Missing input collections in line \"" << line << "\"!" << endl;
+          return false;
+        }
+      expressions.push_back ({splitCollections (line.substr (0, colon)), trim (line.substr (colon + 1))});
+    }
+  return true;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+vector<string>
+splitCollections (const string &s)
+{
+  vector<string> collections;
+  stringstream ss (s);
+  string collection;
+  while (getline (ss, collection, ','))
+    {
+      collection = trim (collection);
+      if (!collection.empty ())
+        collections.push_back (collection);
+    }
+  return collections;
+}
+
+string
+trim (const string &s)
+{
+  size_t first = s.find_first_not_of (" \t"),
+         last = s.find_last_not_of (" \t");
+  return (first == string::npos ? "" : s.substr (first, last - first + 1));
+}
+
+void
+printHelp (const string &exeName)
+{
+  printf ("Usage: %s [OPTION]... [EXPRESSION]...\n", exeName.c_str ());
+  printf ("Checks each EXPRESSION, given the input collections, the same way as\n");
+  printf ("CutCalculator and Plotter do when they are constructed.\n");
+  printf ("\n");
+  printf ("%-29s%s\n", "  -h, --help", "print this help message");
+  printf ("%-29s%s\n", "  -c, --collections LIST", "comma-separated input collections of each");
+  printf ("%-29s%s\n", "", "EXPRESSION, e.g., muons,jets");
+  printf ("%-29s%s\n", "  -f, --file FILE", "also check the expressions in FILE, one per line");
+  printf ("%-29s%s\n", "", "in the form \"COLLECTIONS: EXPRESSION\"");
+}
+
+void
+parseOptions (int argc, char *argv[], map<string, string> &opt, vector<string> &argVector)
+{
+  for (int i = 1; i < argc; i++)
+    {
+      if (argv[i][0] != '-')
+        {
+          argVector.push_back (argv[i]);
+          continue;
+        }
+      int offset = 1;
+      if (argv[i][1] == '-')
+        offset++;
+      string key = argv[i] + offset;
+      if (key == "h")
+        key = "help";
+      else if (key == "c")
+        key = "collections";
+      else if (key == "f")
+        key = "file";
+      if (key != "help" && i + 1 < argc)
+        opt[key] = argv[++i];
+      else
+        opt[key] = "";
+    }
+}
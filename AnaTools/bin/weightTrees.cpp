@@ -1,7 +1,15 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
+
+#include <glob.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "TFile.h"
 #include "TDirectoryFile.h"
@@ -11,7 +19,9 @@
 
 using namespace std;
 
-void weightTrees (TDirectoryFile *, const double, vector<TTree *> &);
+void findTrees (TDirectoryFile *, const string &, vector<string> &);
+bool weightTrees (const string &, const double);
+void expandFiles (const vector<string> &, vector<string> &);
 void printHelp (const string &);
 void parseOptions (int, char *[], map<string, string> &, vector<string> &);
 
@@ -21,45 +31,148 @@ main (int argc, char *argv[])
   map<string, string> opt;
   vector<string> argVector;
   parseOptions (argc, argv, opt, argVector);
-  if (argVector.size () != 2 || opt.count ("help"))
+  if (argVector.size () < 2 || opt.count ("help"))
     {
       printHelp (argv[0]);
       return 0;
     }
 
-  TFile *fin = TFile::Open (argVector.at (0).c_str (), "update");
-  vector<TTree *> trees;
-  weightTrees (fin, atof (argVector.at (1).c_str ()), trees);
-  fin->Write (0, TObject::kOverwrite);
-  fin->Close ();
+  const double w = atof (argVector.back ().c_str ());
+  vector<string> files;
+  argVector.pop_back ();
+  expandFiles (argVector, files);
+  if (files.empty ())
+    {
+      clog << "ERROR: no files matching the given names were found." << endl;
+      return 1;
+    }
+
+  unsigned nJobs = opt.count ("jobs") ? atoi (opt.at ("jobs").c_str ()) : sysconf (_SC_NPROCESSORS_ONLN);
+  nJobs = max (min (nJobs, (unsigned) files.size ()), 1u);
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Each file is weighted in its own child process, with at most nJobs running
+  // at once, so that no ROOT objects are shared between workers.
+  //////////////////////////////////////////////////////////////////////////////
+  set<pid_t> workers;
+  bool success = true;
+  for (unsigned i = 0; i < files.size () || !workers.empty (); )
+    {
+      if (i < files.size () && workers.size () < nJobs)
+        {
+          pid_t pid = fork ();
+          if (pid == 0)
+            _exit (weightTrees (files.at (i), w) ? 0 : 1);
+          if (pid < 0)
+            {
+              clog << "ERROR: could not start a worker for " << files.at (i) << "." << endl;
+              success = false;
+            }
+          else
+            workers.insert (pid);
+          i++;
+          continue;
+        }
+
+      int status;
+      pid_t pid = wait (&status);
+      if (pid < 0)
+        break;
+      workers.erase (pid);
+      success = success && WIFEXITED (status) && !WEXITSTATUS (status);
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  return (success ? 0 : 1);
 }
 
 void
-weightTrees (TDirectoryFile *fin, const double w, vector<TTree *> &trees)
+findTrees (TDirectoryFile *fin, const string &path, vector<string> &treePaths)
 {
   TIter next (fin->GetListOfKeys ());
   TKey *key;
+  set<string> names;
   while ((key = (TKey *) next ()))
     {
+      // Only the highest cycle of each key is used, as with TDirectory::Get.
+      if (!names.insert (key->GetName ()).second)
+        continue;
       if (string (key->GetClassName ()) == "TDirectoryFile")
         {
           TDirectoryFile *dir = (TDirectoryFile *) fin->Get (key->GetName ());
-          weightTrees (dir, w, trees);
+          findTrees (dir, path + key->GetName () + "/", treePaths);
         }
       else if (string (key->GetClassName ()) == "TTree")
+        treePaths.push_back (path + key->GetName ());
+    }
+}
+
+bool
+weightTrees (const string &fileName, const double w)
+{
+  TFile *fin = TFile::Open (fileName.c_str (), "update");
+  if (!fin || fin->IsZombie ())
+    {
+      clog << "ERROR: could not open " << fileName << "." << endl;
+      return false;
+    }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Each file is walked on its own, so that every tree in it is weighted even
+  // if the files do not all have the same trees. Walking the file only reads
+  // the lists of keys of its directories, not the trees.
+  //////////////////////////////////////////////////////////////////////////////
+  vector<string> treePaths;
+  findTrees (fin, "", treePaths);
+  vector<TTree *> trees;
+  for (const auto &treePath : treePaths)
+    trees.push_back ((TTree *) fin->Get (treePath.c_str ()));
+  //////////////////////////////////////////////////////////////////////////////
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Only the header of each tree, which holds its weight, is written back, so
+  // none of its baskets are read or rewritten. It is written to the directory
+  // of the tree, since TTree::Write would write to the current directory.
+  //////////////////////////////////////////////////////////////////////////////
+  for (const auto &tree : trees)
+    {
+      tree->SetWeight (w);
+      tree->GetDirectory ()->WriteTObject (tree, 0, "Overwrite");
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  fin->Close ();
+  delete fin;
+  return true;
+}
+
+void
+expandFiles (const vector<string> &patterns, vector<string> &files)
+{
+  for (const auto &pattern : patterns)
+    {
+      glob_t globbuf;
+      if (glob (pattern.c_str (), 0, NULL, &globbuf) == 0)
         {
-          TTree *tree = (TTree *) fin->Get (key->GetName ());
-          tree->SetWeight (w);
-          trees.push_back (tree);
+          for (unsigned i = 0; i < globbuf.gl_pathc; i++)
+            files.push_back (globbuf.gl_pathv[i]);
         }
+      else if (pattern.find_first_of ("*?[") == string::npos)
+        files.push_back (pattern);
+      else
+        clog << "WARNING: no files match " << pattern << "." << endl;
+      globfree (&globbuf);
     }
 }
 
 void
 printHelp (const string &exeName)
 {
-  printf ("Usage: %s FILE WEIGHT\n", exeName.c_str ());
-  printf ("Weights each TTree in FILE with WEIGHT.\n");
+  printf ("Usage: %s [OPTION]... FILE... WEIGHT\n", exeName.c_str ());
+  printf ("Weights each TTree in each FILE with WEIGHT. FILE may be a quoted glob pattern.\n");
+  printf ("\n");
+  printf ("  -j, --jobs N   weight at most N files at once (default: number of CPUs)\n");
+  printf ("  -h, --help     print this help\n");
 }
 
 void
@@ -79,6 +192,10 @@ parseOptions (int argc, char *argv[], map<string, string> &opt, vector<string> &
              value = "";
       if (key == "h")
         key = "help";
+      if (key == "j")
+        key = "jobs";
+      if (key == "jobs" && i + 1 < argc)
+        value = argv[++i];
       opt[key] = value;
     }
 }
@@ -5,6 +5,12 @@
 
 #include "DataFormats/Common/interface/Handle.h"
 
+#include "OSUT3Analysis/AnaTools/interface/CollectionRegistry.h"
+#include "OSUT3Analysis/AnaTools/interface/EventVariableTable.h"
+#include "OSUT3Analysis/AnaTools/interface/MemberValueCache.h"
+#include "OSUT3Analysis/AnaTools/interface/SubexpressionCache.h"
+#include "OSUT3Analysis/AnaTools/interface/UserVariableTable.h"
+
 #include "OSUT3Analysis/Collections/interface/Basicjet.h"
 #include "OSUT3Analysis/Collections/interface/Beamspot.h"
 #include "OSUT3Analysis/Collections/interface/Bjet.h"
@@ -65,6 +71,7 @@ struct CutCalculatorPayload
   bool            triggerDecision;
   bool            triggerFilterDecision;
   bool            metFilterDecision;
+  bool            shortCircuit;        // whether cuts after the first failing one are skipped, so their individual flags are not computed
   Cuts            cuts;
   vector<bool>    cumulativeEventFlags;
   vector<bool>    individualEventFlags;
@@ -128,6 +135,10 @@ struct Node
   Node            *parent;
   string          value;
   vector<Node *>  branches;
+  int             slot; // slot in the EventVariableTable, or -1 if the node is not an event variable
+  CollectionId    collection; // collection of a "." node with a single member, or COLLECTION_INVALID
+  int             member; // identifier in the MemberValueCache of the member looked up by the node, or -1
+  int             expression; // identifier in the SubexpressionCache of the subtree, or -1
 };
 
 struct Collections
@@ -155,10 +166,18 @@ struct Collections
   edm::Handle<vector<osu::SecondaryTrack> > secondaryTracks;
   edm::Handle<vector<osu::PileUpInfo> >     pileupinfos;
   vector<edm::Handle<osu::Uservariable> >   uservariables;
+  UserVariableTable                         uservariableTable;
   vector<edm::Handle<osu::Eventvariable> >  eventvariables;
+  vector<edm::Handle<EventVariableRecord> > eventvariableRecords;
+  EventVariableTable                        eventvariableTable;
+  MemberValueCache                          memberValueCache;
+  SubexpressionCache                        subexpressionCache;
 
   edm::Handle<TYPE(triggers)>                 triggers;
   edm::Handle<vector<TYPE(trigobjs)> >        trigobjs;
+#if IS_VALID(trigobjs)
+  edm::Handle<osu::TrigobjFilterIndex>        trigobjFilterIndex;
+#endif
   edm::Handle<TYPE(prescales)>                prescales;
   edm::Handle<TYPE(generatorweights)>         generatorweights;
   edm::Handle<TYPE(triggers)>                 metFilters;
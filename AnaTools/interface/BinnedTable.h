@@ -0,0 +1,75 @@
+#ifndef BINNED_TABLE
+
+#define BINNED_TABLE
+
+#include <string>
+#include <vector>
+
+#include "TH1.h"
+
+using namespace std;
+
+// Values, with up and down errors, in the bins of a histogram with any number
+// of axes, copied once from a ROOT histogram or read from a text table, e.g.,
+// in AnaTools/data/scaleFactors, so that each lookup is a few comparisons and
+// array reads, with no ROOT calls. The bins are numbered as in ROOT, i.e., bin
+// 0 and bin nBins + 1 of each axis are the underflow and overflow bins, and
+// the global bin is found the same way as with TH1::FindBin. If the table is
+// clamped, values outside the axes are instead taken from the nearest bin, as
+// is done for some of the scale factors.
+//
+// The text tables have one line per axis, in order, of the form
+//   axis edge_0 edge_1 ... edge_nBins
+// then, optionally, the value and errors of every bin not listed, of the form
+//   default value [errorUp [errorDown]]
+// and then one line per bin, of the form
+//   bin_axis0 bin_axis1 ... value [errorUp [errorDown]]
+// where a missing down error is the same as the up error. Edges may be "inf"
+// and everything after a "#" is ignored.
+class BinnedTable
+  {
+    public:
+      BinnedTable () : clamp_ (false) {};
+      BinnedTable (const TH1 &, const bool clamp = false);
+      BinnedTable (const string &, const bool clamp = false);
+      BinnedTable (const vector<vector<double> > &, const vector<double> &, const vector<double> &, const vector<double> &, const bool clamp = false);
+      ~BinnedTable () {};
+
+      bool empty () const { return values_.empty (); };
+      unsigned nAxes () const { return edges_.size (); };
+
+      // Return the global bin containing the given point.
+      unsigned findBin (const double &) const;
+      unsigned findBin (const double &, const double &) const;
+      unsigned findBin (const vector<double> &) const;
+
+      double value (const unsigned &bin) const { return values_[bin]; };
+      double errorUp (const unsigned &bin) const { return errorsUp_[bin]; };
+      double errorDown (const unsigned &bin) const { return errorsDown_[bin]; };
+
+      // Return the value at the given point shifted by the up (down) error
+      // times shiftUpDown if it is positive (negative).
+      double at (const double &x, const int &shiftUpDown = 0) const { return shifted (findBin (x), shiftUpDown); };
+      double at (const double &x, const double &y, const int &shiftUpDown = 0) const { return shifted (findBin (x, y), shiftUpDown); };
+
+    private:
+      bool clamp_;
+
+      // Edges of each axis, and whether its bins are all the same width, in
+      // which case the bin is computed directly, as in TAxis::FindBin.
+      vector<vector<double> > edges_;
+      vector<bool> uniform_;
+
+      // Number of global bins between consecutive bins of each axis.
+      vector<unsigned> strides_;
+
+      vector<double> values_;
+      vector<double> errorsUp_;
+      vector<double> errorsDown_;
+
+      void setAxes (const vector<vector<double> > &);
+      unsigned findAxisBin (const unsigned, const double &) const;
+      double shifted (const unsigned &bin, const int &shiftUpDown) const { return values_[bin] + shiftUpDown * (shiftUpDown > 0 ? errorsUp_[bin] : errorsDown_[bin]); };
+  };
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef COLLECTION_REGISTRY
+
+#define COLLECTION_REGISTRY
+
+#include <string>
+
+using namespace std;
+
+// Identifiers for every collection which can be retrieved by
+// anatools::getRequiredCollections. The object collections, which may appear
+// in the expressions given to ValueLookupTree, come first.
+enum CollectionId
+  {
+    COLLECTION_BEAMSPOTS,
+    COLLECTION_BXLUMIS,
+    COLLECTION_CSCHITS,
+    COLLECTION_CSCSEGS,
+    COLLECTION_DTSEGS,
+    COLLECTION_ELECTRONS,
+    COLLECTION_EVENTS,
+    COLLECTION_GENJETS,
+    COLLECTION_GENERATORWEIGHTS,
+    COLLECTION_BASICJETS,
+    COLLECTION_JETS,
+    COLLECTION_BJETS,
+    COLLECTION_MCPARTICLES,
+    COLLECTION_METS,
+    COLLECTION_MUONS,
+    COLLECTION_PHOTONS,
+    COLLECTION_PRIMARYVERTEXS,
+    COLLECTION_RPCHITS,
+    COLLECTION_SUPERCLUSTERS,
+    COLLECTION_TAUS,
+    COLLECTION_TRACKS,
+    COLLECTION_SECONDARYTRACKS,
+    COLLECTION_PILEUPINFOS,
+    COLLECTION_USERVARIABLES,
+    COLLECTION_EVENTVARIABLES,
+    COLLECTION_TRIGGERS,
+    COLLECTION_METFILTERS,
+    COLLECTION_PRESCALES,
+    COLLECTION_TRIGOBJS,
+    N_COLLECTIONS,
+    COLLECTION_INVALID = N_COLLECTIONS
+  };
+
+namespace anatools
+{
+  // Maps a collection name, e.g., "muons", to its identifier, or to
+  // COLLECTION_INVALID if the name is unknown. The map is built once, the
+  // first time this is called.
+  CollectionId getCollectionId (const string &);
+
+  // Returns true if the collection is an object collection, i.e., it may be
+  // used in a ValueLookupTree expression, and it is valid in the current data
+  // format.
+  bool isObjectCollection (const CollectionId);
+
+  // Return the name of the collection and the C++ type of its objects, or
+  // empty strings if there is none.
+  const string &getCollectionName (const CollectionId);
+  const string &getCollectionType (const CollectionId);
+}
+
+#endif
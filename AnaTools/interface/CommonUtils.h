@@ -7,6 +7,7 @@
 #ifndef COMMON_UTILS
 #define COMMON_UTILS
 
+#include <bitset>
 #include <iostream>
 #include <map>
 #include <unordered_set>
@@ -56,107 +57,132 @@ struct Tokens
   edm::EDGetTokenT<TYPE(prescales)> prescales;
   edm::EDGetTokenT<TYPE(triggers)> triggers;
   edm::EDGetTokenT<vector<TYPE(trigobjs)> > trigobjs;
+#if IS_VALID(trigobjs)
+  edm::EDGetTokenT<osu::TrigobjFilterIndex> trigobjFilterIndex;
+#endif
   edm::EDGetTokenT<TYPE(triggers)> metFilters;
 
   vector<edm::EDGetTokenT<osu::Uservariable> > uservariables;
   vector<edm::EDGetTokenT<osu::Eventvariable> > eventvariables;
+  vector<edm::EDGetTokenT<EventVariableRecord> > eventvariableRecords;
 };
 
 namespace anatools
 {
-  // Return a (hopefully) unique hashed integer for an object
-  template <class T> int getObjectHash (const T &);
+  // Return the index of an object within the collection of the same type in
+  // the given Collections object, or -1 if it is not an element of it, and
+  // set the ProductID of that collection.
+  template <class T> int getObjectIndex (const T &, const edm::Handle<vector<T> > &, edm::ProductID &);
 
 #if IS_VALID(beamspots)
   string getObjectType (const osu::Beamspot &);
   string getObjectClass (const osu::Beamspot &);
+  int getObjectIndex (const osu::Beamspot &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(bxlumis)
   string getObjectType (const osu::Bxlumi &);
   string getObjectClass (const osu::Bxlumi &);
+  int getObjectIndex (const osu::Bxlumi &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(cschits)
   string getObjectType (const osu::Cschit &);
   string getObjectClass (const osu::Cschit &);
+  int getObjectIndex (const osu::Cschit &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(cscsegs)
   string getObjectType (const osu::Cscseg &);
   string getObjectClass (const osu::Cscseg &);
+  int getObjectIndex (const osu::Cscseg &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(dtsegs)
   string getObjectType (const osu::Dtseg &);
   string getObjectClass (const osu::Dtseg &);
+  int getObjectIndex (const osu::Dtseg &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(electrons)
   string getObjectType (const osu::Electron &);
   string getObjectClass (const osu::Electron &);
+  int getObjectIndex (const osu::Electron &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(events)
   string getObjectType (const osu::Event &);
   string getObjectClass (const osu::Event &);
-  template<> int getObjectHash<osu::Event> (const osu::Event &);
+  int getObjectIndex (const osu::Event &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(genjets)
   string getObjectType (const osu::Genjet &);
   string getObjectClass (const osu::Genjet &);
+  int getObjectIndex (const osu::Genjet &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(basicjets)
   string getObjectType  (const osu::Basicjet &);
   string getObjectClass (const osu::Basicjet &);
+  int getObjectIndex (const osu::Basicjet &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(jets)
   string getObjectType (const osu::Jet &);
   string getObjectClass (const osu::Jet &);
+  int getObjectIndex (const osu::Jet &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(bjets)
   string getObjectType (const osu::Bjet &);
   string getObjectClass (const osu::Bjet &);
+  int getObjectIndex (const osu::Bjet &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(mcparticles)
   string getObjectType (const osu::Mcparticle &);
   string getObjectClass (const osu::Mcparticle &);
+  int getObjectIndex (const osu::Mcparticle &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(mets)
   string getObjectType (const osu::Met &);
   string getObjectClass (const osu::Met &);
-  template<> int getObjectHash<osu::Met> (const osu::Met &);
+  int getObjectIndex (const osu::Met &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(muons)
   string getObjectType (const osu::Muon &);
   string getObjectClass (const osu::Muon &);
+  int getObjectIndex (const osu::Muon &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(photons)
   string getObjectType (const osu::Photon &);
   string getObjectClass (const osu::Photon &);
+  int getObjectIndex (const osu::Photon &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(primaryvertexs)
   string getObjectType (const osu::Primaryvertex &);
   string getObjectClass (const osu::Primaryvertex &);
-  template<> int getObjectHash<osu::Primaryvertex> (const osu::Primaryvertex &);
+  int getObjectIndex (const osu::Primaryvertex &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(rpchits)
   string getObjectType (const osu::Rpchit &);
   string getObjectClass (const osu::Rpchit &);
+  int getObjectIndex (const osu::Rpchit &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(superclusters)
   string getObjectType (const osu::Supercluster &);
   string getObjectClass (const osu::Supercluster &);
+  int getObjectIndex (const osu::Supercluster &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(taus)
   string getObjectType (const osu::Tau &);
   string getObjectClass (const osu::Tau &);
+  int getObjectIndex (const osu::Tau &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(tracks)
   string getObjectType (const osu::Track &);
   string getObjectClass (const osu::Track &);
+  int getObjectIndex (const osu::Track &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(secondaryTracks)
   string getObjectType (const osu::SecondaryTrack &);
   string getObjectClass (const osu::SecondaryTrack &);
+  int getObjectIndex (const osu::SecondaryTrack &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(pileupinfos)
   string getObjectType (const osu::PileUpInfo &);
   string getObjectClass (const osu::PileUpInfo &);
+  int getObjectIndex (const osu::PileUpInfo &, const Collections &, edm::ProductID &);
 #endif
 #if IS_VALID(uservariables)
   // user-defined cases
@@ -211,6 +237,12 @@ namespace anatools
 #ifdef ROOT6
   anatools::ObjectWithDict * getMember (const anatools::TypeWithDict &tDerived, const anatools::TypeWithDict &t, const anatools::ObjectWithDict &o, const string &member, string &memberType, map<pair<string, string>, pair<string, void (*) (void *, int, void **, void *)> > *);
   anatools::ObjectWithDict * invoke (const string &returnType, const anatools::ObjectWithDict &o, const anatools::FunctionWithDict &f);
+
+  // Return the type of a member from the dictionaries alone, without an
+  // object, following the same rules as getMember, or an empty string if the
+  // member cannot be found.
+  string getMemberType (const string &type, const string &member);
+  string getMemberType (const anatools::TypeWithDict &t, const string &member);
 #else
   const Reflex::Object * const getMember (const Reflex::Type &t, const Reflex::Object &o, const string &member, string &memberType);
   const Reflex::Object * const invoke (const string &returnType, const Reflex::Object &o, const string &member);
@@ -238,21 +270,23 @@ anatools::getMember(const T &obj, const string &member)
 }
 
 /**
- * Returns a hash value representing the given object.
+ * Returns the index of the given object within the given collection.
  *
- * This version applies to objects with a momentum three-vector, and simply
- * returns the sum of the Cartesian coordinates of this vector.
+ * The object must be a reference to an element of the collection, not a copy,
+ * since the index is found from its address.
  *
- * @param  object object whose hash value will be calculated
- * @return hash value corresponding to the object
+ * @param  object object whose index will be found
+ * @param  collection handle to the collection containing the object
+ * @param  productId set to the ProductID of the collection
+ * @return index of the object, or -1 if it is not in the collection
  */
 template <class T> int
-anatools::getObjectHash(const T& object){
-    int px_mev, py_mev, pz_mev;
-    px_mev = abs(int(1000 * getMember (object, "px")));
-    py_mev = abs(int(1000 * getMember (object, "py")));
-    pz_mev = abs(int(1000 * getMember (object, "pz")));
-    return px_mev + py_mev + pz_mev;
+anatools::getObjectIndex(const T& object, const edm::Handle<vector<T> > &collection, edm::ProductID &productId){
+    if (!collection.isValid () || collection->empty ())
+      return -1;
+    productId = collection.id ();
+    ptrdiff_t index = &object - &collection->front ();
+    return ((index >= 0 && index < (ptrdiff_t) collection->size ()) ? index : -1);
 }
 
 template<class T> bool
@@ -50,6 +50,7 @@
 #include <vector>
 #include "boost/config.hpp"
 #include "RVersion.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
 
 #if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
   #define ROOT6
@@ -63,9 +64,9 @@
 
 using namespace std;
 
-// type to hold list of hashed indices corresponding to objects
-// string - object type
-// int - object hash
+// type to hold list of objects associated with a user variable
+// string - object type, e.g., "muon"
+// int - index of the object in the corresponding collection
 typedef multimap <string, int>  ObjectList;
 
 // struct to connect objects to the calculated variable's value
@@ -73,6 +74,7 @@ struct UserVariable
 {
   double value;
   ObjectList objects;
+  map<string, edm::ProductID> collections; // collection in which the indices of each object type are taken
 
   UserVariable ()
     {
@@ -95,6 +97,21 @@ typedef map<string, vector<UserVariable> > VariableProducerPayload;
 //   double - value of variable for the event
 typedef map<string, double > EventVariableProducerPayload;
 
+// EventVariableRecord type:
+//   layout - the variables declared by the producer, in order, as
+//            space-separated name:type:size fields, where type is d, i or b
+//   values - each variable takes size consecutive elements of the values of
+//            its type, in the order of the layout
+//   isSet  - whether each variable was set in the event
+struct EventVariableRecord
+{
+  string          layout;
+  vector<double>  doubleValues;
+  vector<int>     intValues;
+  vector<char>    boolValues;
+  vector<char>    isSet;
+};
+
 // define some macros with meaningful names for the ANSI color codes
 // https://en.wikipedia.org/wiki/ANSI_escape_code#Colors
 
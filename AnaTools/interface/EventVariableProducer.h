@@ -10,6 +10,22 @@
 #include "OSUT3Analysis/AnaTools/interface/AnalysisTypes.h"
 #include "OSUT3Analysis/AnaTools/interface/CommonUtils.h"
 
+// Types of the variables which can be declared with declareEventVar. Any of
+// them can be declared as a fixed-size vector by giving a size larger than 1.
+enum EventVarType
+{
+  EVENT_VAR_DOUBLE,
+  EVENT_VAR_INT,
+  EVENT_VAR_BOOL
+};
+
+struct EventVarDeclaration
+{
+  string name;
+  EventVarType type;
+  unsigned size;
+  unsigned offset; // offset in the record of the corresponding type
+};
 
 class EventVariableProducer : public edm::EDProducer
   {
@@ -29,8 +45,30 @@ class EventVariableProducer : public edm::EDProducer
       unordered_set<string> objectsToGet_;
       unique_ptr<EventVariableProducerPayload> eventvariables;
 
+      // Methods
+
+      ////////////////////////////////////////////////////////////////////////
+      // Variables declared in the constructor of the derived class are
+      // written with setEventVar into a dense, typed record, indexed by the
+      // slot returned by declareEventVar, so that setting them hashes no
+      // strings. The record is put in the event as an EventVariableRecord,
+      // which is what the EventVariableTable reads, and vector variables
+      // appear to the ValueLookupTree as name_0, name_1, etc. Variables which
+      // are not set in a given event are invalid, as before. Writing directly
+      // into eventvariables is still supported for names only known per
+      // event, and these are the only variables left in the map.
+      ////////////////////////////////////////////////////////////////////////
+      unsigned declareEventVar (const string &name, const EventVarType type = EVENT_VAR_DOUBLE, const unsigned size = 1);
+      void setEventVar (const unsigned slot, const double value, const unsigned index = 0);
+      ////////////////////////////////////////////////////////////////////////
+
     private:
 
+      // Variables
+
+      vector<EventVarDeclaration> declarations_;
+      EventVariableRecord record_;
+
       // Methods
 
       virtual void AddVariables(const edm::Event &) = 0;
@@ -0,0 +1,69 @@
+#ifndef EVENT_VARIABLE_TABLE
+
+#define EVENT_VARIABLE_TABLE
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DataFormats/Common/interface/Handle.h"
+
+#include "OSUT3Analysis/Collections/interface/Eventvariable.h"
+
+using namespace std;
+
+// Merged, read-only view of the event variables from all the producers in the
+// current event. Variable names are resolved to dense slots with getSlot when
+// the ValueLookupTree objects are built, so a lookup in the event loop is just
+// an array read. The slots are shared by every module in the job, and the
+// values are filled once per event by anatools::getRequiredCollections, and
+// those of slots registered later in the event are filled when first read. If
+// several producers give the same variable, the first one wins.
+//
+// The values are taken from the typed EventVariableRecord of each producer,
+// whose layout is resolved to slots only when it changes, and from its map
+// of names to doubles, which holds the variables that were not declared and
+// is the only product in events written before the records existed.
+class EventVariableTable
+  {
+    public:
+      EventVariableTable () {};
+      ~EventVariableTable () {};
+
+      static unsigned getSlot (const string &);
+      static int findSlot (const string &);
+
+      void fill (const vector<edm::Handle<osu::Eventvariable> > &, const vector<edm::Handle<EventVariableRecord> > &);
+      double get (const unsigned &slot) const;
+      double get (const string &) const;
+
+    private:
+      struct RecordEntry
+      {
+        unsigned slot;
+        char type;
+        unsigned offset;      // in the values of the given type
+        unsigned declaration; // index in the layout
+      };
+
+      struct RecordLayout
+      {
+        RecordLayout () : nSlots (0) {};
+
+        string layout;
+        unsigned nSlots;              // size of the registry when resolved
+        vector<RecordEntry> entries;  // only those with a slot
+      };
+
+      static unordered_map<string, unsigned> &slots ();
+
+      void fillSlots () const;
+      void resolveLayout (const string &, RecordLayout &) const;
+
+      vector<edm::Handle<osu::Eventvariable> > handles_;
+      vector<edm::Handle<EventVariableRecord> > recordHandles_;
+      mutable vector<RecordLayout> layouts_; // one per producer
+      mutable vector<double> values_; // indexed by slot
+  };
+
+#endif
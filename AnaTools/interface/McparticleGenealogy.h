@@ -0,0 +1,49 @@
+#ifndef MCPARTICLE_GENEALOGY
+
+#define MCPARTICLE_GENEALOGY
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "OSUT3Analysis/AnaTools/interface/DataFormat.h"
+
+using namespace std;
+
+// Finds, in a single pass over the hard-interaction mcparticles of an event,
+// which of them have one of the configured PDG IDs, up to the sign, and are
+// the original particle with that PDG ID, i.e., no particle in their chain of
+// first mothers has exactly the same PDG ID. The result for each particle is
+// computed once from that of its mother, so every chain is only walked once.
+class McparticleGenealogy
+  {
+    public:
+      McparticleGenealogy (const vector<int> &);
+      ~McparticleGenealogy () {};
+
+      void update (const vector<TYPE(hardInteractionMcparticles)> &);
+
+      // Indices in the configured PDG IDs of the ones matched by the given
+      // particle if it is an original particle, and an empty vector otherwise.
+      const vector<unsigned> &originalPdgIdIndices (const unsigned i) const { return originalPdgIdIndices_.at (i) >= 0 ? pdgIdIndices_.at (originalPdgIdIndices_.at (i)) : noIndices_; };
+
+    private:
+      // Maps each configured PDG ID, without sign, to its position in
+      // pdgIdIndices_, which holds the indices of the configured PDG IDs it
+      // matches. Each signed PDG ID is given its own bit in the ancestor masks.
+      unordered_map<int, unsigned> pdgIds_;
+      vector<vector<unsigned> > pdgIdIndices_;
+      const vector<unsigned> noIndices_;
+
+      // Per-particle results for the current event. The ancestor mask has the
+      // bits of the configured PDG IDs found among the ancestors.
+      vector<uint64_t> ancestorMasks_;
+      vector<int> originalPdgIdIndices_;
+      vector<unsigned char> states_;
+      vector<unsigned> chain_;
+
+      uint64_t getBit (const int) const;
+      uint64_t getAncestorMask (const reco::Candidate &) const;
+  };
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef MEMBER_VALUE_CACHE
+
+#define MEMBER_VALUE_CACHE
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "OSUT3Analysis/AnaTools/interface/CollectionRegistry.h"
+
+using namespace std;
+
+// Per-event cache of the object members found with anatools::getMember, shared
+// by all the ValueLookupTree objects which use the same Collections object.
+// Member names, e.g., "pt" or "innerTrack.pt", are resolved to dense
+// identifiers with getMemberId when the trees are built, and the values are
+// keyed by the collection, the index of the object within it, and the member.
+// The cache is cleared for each event by anatools::getRequiredCollections.
+class MemberValueCache
+  {
+    public:
+      MemberValueCache () {};
+      ~MemberValueCache () {};
+
+      static unsigned getMemberId (const string &);
+
+      void clear () { values_.clear (); };
+      bool find (const CollectionId, const unsigned index, const unsigned member, double &value) const;
+      void insert (const CollectionId, const unsigned index, const unsigned member, const double value);
+
+    private:
+      static unordered_map<string, unsigned> &memberIds ();
+      static uint64_t key (const CollectionId, const unsigned, const unsigned);
+
+      unordered_map<uint64_t, double> values_;
+  };
+
+#endif
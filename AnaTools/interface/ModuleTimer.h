@@ -0,0 +1,63 @@
+#ifndef MODULE_TIMER
+
+#define MODULE_TIMER
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+
+#include "TH1D.h"
+
+using namespace std;
+
+// Opt-in accumulator of the wall time spent in, and the number of calls to,
+// named sections of a module. Sections are registered once with addSection,
+// which returns the slot to be given to a ScopedTimer inside the event loop.
+// The totals are written with write as two histograms with one labeled bin per
+// section, so that mergeTFileServiceHistograms sums them across jobs.
+class ModuleTimer
+  {
+    public:
+      ModuleTimer () : enabled_ (false) {};
+      ModuleTimer (const bool enabled) : enabled_ (enabled) {};
+      ~ModuleTimer () {};
+
+      bool enabled () const { return enabled_; };
+      unsigned addSection (const string &);
+      void add (const unsigned &section, const double &seconds) { seconds_[section] += seconds; calls_[section]++; };
+      void write (TFileDirectory &) const;
+
+    private:
+      bool enabled_;
+      vector<string> names_;
+      vector<double> seconds_;
+      vector<double> calls_;
+  };
+
+// Adds the wall time between its construction and its destruction to one
+// section of a ModuleTimer. Does nothing if the timer is disabled.
+class ScopedTimer
+  {
+    public:
+      ScopedTimer (ModuleTimer &timer, const unsigned &section) :
+        timer_ (timer.enabled () ? &timer : NULL),
+        section_ (section)
+      {
+        if (timer_)
+          start_ = chrono::steady_clock::now ();
+      };
+      ~ScopedTimer ()
+      {
+        if (timer_)
+          timer_->add (section_, chrono::duration<double> (chrono::steady_clock::now () - start_).count ());
+      };
+
+    private:
+      ModuleTimer *timer_;
+      unsigned section_;
+      chrono::steady_clock::time_point start_;
+  };
+
+#endif
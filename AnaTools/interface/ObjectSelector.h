@@ -9,8 +9,10 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
 
 #include "OSUT3Analysis/AnaTools/interface/CommonUtils.h"
+#include "OSUT3Analysis/AnaTools/interface/ModuleTimer.h"
 
 #define EXIT_CODE 2
 
@@ -22,6 +24,7 @@ class ObjectSelector : public edm::EDFilter
     ~ObjectSelector ();
 
     bool filter (edm::Event &, const edm::EventSetup &);
+    void endJob ();
 
   private:
     ////////////////////////////////////////////////////////////////////////////
@@ -55,6 +58,10 @@ class ObjectSelector : public edm::EDFilter
     // Payload for this EDFilter.
     unique_ptr<vector<T> >  pl_;
     unique_ptr<vector<TO> > plO_; // original format
+
+    // Optional timing of this EDFilter.
+    ModuleTimer  timer_;
+    unsigned     filterTimerSection_;
 };
 
 template<class T, class TO>
@@ -63,7 +70,8 @@ ObjectSelector<T, TO>::ObjectSelector (const edm::ParameterSet &cfg) :
   collectionToFilter_  (cfg.getParameter<string>             ("collectionToFilter")),
   originalCollection_  (cfg.getParameter<edm::InputTag>      ("originalCollection")),
   cutDecisions_        (cfg.getParameter<edm::InputTag>      ("cutDecisions")),
-  firstEvent_          (true)
+  firstEvent_          (true),
+  timer_               (cfg.getUntrackedParameter<bool>      ("timing", false))
 {
   // Retrieve the InputTag for the collection which is to be filtered.
   collection_ = collections_.getParameter<edm::InputTag> (collectionToFilter_);
@@ -74,6 +82,8 @@ ObjectSelector<T, TO>::ObjectSelector (const edm::ParameterSet &cfg) :
   collectionToken_ = consumes<vector<T> > (collection_);
   collectionOrigToken_ = consumes<vector<TO> > (originalCollection_);
   cutDecisionsToken_ = consumes<CutCalculatorPayload> (cutDecisions_);
+
+  filterTimerSection_ = timer_.addSection ("filter");
 }
 
 template<class T, class TO>
@@ -84,6 +94,8 @@ template<class T, class TO>
 template<class T, class TO> bool
   ObjectSelector<T, TO>::filter (edm::Event &event, const edm::EventSetup &setup)
 {
+  ScopedTimer filterTimer (timer_, filterTimerSection_);
+
   //////////////////////////////////////////////////////////////////////////////
   // Get the collection and cut decisions from the event and print a warning if
   // there is a problem.
@@ -153,4 +165,14 @@ template<class T, class TO> bool
   return (cutDecisions.isValid () ? cutDecisions->eventDecision : true);
 }
 
+template<class T, class TO> void
+  ObjectSelector<T, TO>::endJob ()
+{
+  if (timer_.enabled ())
+    {
+      edm::Service<TFileService> fs;
+      timer_.write (*fs);
+    }
+}
+
 #endif
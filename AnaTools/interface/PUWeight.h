@@ -2,6 +2,7 @@
 
 #define PU_WEIGHT
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <map>
@@ -13,17 +14,46 @@
 
 using namespace std;
 
+// Ratio of the pileup distribution in data to that in MC, computed once in
+// the constructor and stored as a flat table with one weight per bin of the
+// data distribution, including the underflow and overflow bins, so that each
+// lookup is a single array read. The distributions are read either from a
+// ROOT file, e.g., pu.root, or from the text table written alongside it by
+// makePU.py and addPUHists.py, e.g., pu.txt, so that standalone tools do not
+// need to open ROOT files. A default-constructed PUWeight always gives 1.
 class PUWeight
   {
     public:
-      PUWeight () {};
-      PUWeight (const string &, const string &, const string &);
-      ~PUWeight ();
-      double operator[] (const unsigned &pu) { return puWeight_->GetBinContent (puWeight_->FindBin (pu)); };
-      double at (const unsigned &pu) { return (*this)[pu]; };
+      PUWeight () : nBins_ (0), xMin_ (0.0), xMax_ (0.0) {};
+      PUWeight (const string &, const string &, const string &, const bool normalize = true);
+      ~PUWeight () {};
+      double operator[] (const double &pu) const
+      {
+        if (weights_.empty ())
+          return 1.0;
+        unsigned bin;
+        if (!(pu >= xMin_))
+          bin = 0;
+        else if (pu >= xMax_)
+          bin = nBins_ + 1;
+        else if (edges_.empty ())
+          bin = min ((unsigned) (nBins_ * (pu - xMin_) / (xMax_ - xMin_)) + 1, nBins_);
+        else
+          bin = upper_bound (edges_.begin (), edges_.end (), pu) - edges_.begin ();
+        return weights_[bin];
+      };
+      double at (const double &pu) const { return (*this)[pu]; };
 
     private:
-      TH1D *puWeight_;
+      unsigned nBins_;
+      double xMin_;
+      double xMax_;
+
+      // Only filled if the bins of the data distribution are not all the same
+      // width, in which case the bin is found with a binary search.
+      vector<double> edges_;
+
+      vector<double> weights_;
   };
 
 #endif
@@ -16,19 +16,25 @@
 #include "TGraphAsymmErrors.h"
 #include "TFile.h"
 
+#include "OSUT3Analysis/AnaTools/interface/BinnedTable.h"
+
 using namespace std;
 
+// Each of the classes below copies its scale factors once, in the
+// constructor, into a BinnedTable, so that no ROOT histograms are used in the
+// event loop.
+
 
 
 class TrackSFWeight
 {
  public:
-  TrackSFWeight () {};
+  TrackSFWeight ();
   ~TrackSFWeight ();
   double at (const double &, const int &shiftUpDown = 0);
 
  private:
-  double *trackSFWeight_;
+  BinnedTable trackSFWeight_;
 };
 
 
@@ -41,7 +47,13 @@ class MuonSFWeight
       double at (const double &, const double &, const int &shiftUpDown = 0);
 
     private:
-      TH2 *muonSFWeight_;
+      BinnedTable muonSFWeight_;
+
+      // Points used instead of those outside of the histogram.
+      double etaMax_;
+      double etaHigh_;
+      double ptHigh_;
+      double ptHighBarrel_;
   };
 
 
@@ -58,7 +70,12 @@ class ElectronSFWeight
       string cmsswRelease_;
       string id_;
 
-      TH2F *electronSFWeight_;
+      // From a histogram, whose axes may be either (eta, pt) or (pt, eta), or
+      // else, for 53X, from a table in AnaTools/data/scaleFactors as a
+      // function of (|eta|, pt).
+      BinnedTable electronSFWeight_;
+      bool fromHistogram_;
+      bool swapAxes_;
   };
 
 
@@ -71,7 +88,7 @@ class TriggerMetSFWeight
       double at (const double &Met, const int &shiftUpDown = 0);
 
     private:
-      TH1F *triggerMetSFWeight_;
+      BinnedTable triggerMetSFWeight_;
   };
 
 class TrackNMissOutSFWeight
@@ -83,7 +100,7 @@ class TrackNMissOutSFWeight
       double at (const double &NMissOut, const int &shiftUpDown = 0);
 
     private:
-      TH1F *trackNMissOutSFWeight_;
+      BinnedTable trackNMissOutSFWeight_;
   };
 
 class EcaloVarySFWeight
@@ -95,7 +112,7 @@ class EcaloVarySFWeight
   double at (const double &EcaloVary, const int &shiftUpDown = 0);
 
  private:
-  TH1F *EcaloVarySFWeight_;
+  BinnedTable EcaloVarySFWeight_;
 };
 
 
@@ -109,7 +126,7 @@ class IsrVarySFWeight
       double at (const double &ptSusy, const int &shiftUpDown = 0);
 
     private:
-      TH1F *isrVarySFWeight_;
+      BinnedTable isrVarySFWeight_;
   };
 
 class MuonCutWeight
@@ -121,7 +138,7 @@ class MuonCutWeight
       double at (const double &pt);
 
     private:
-      TH1F *muonCutWeight_;
+      BinnedTable muonCutWeight_;
   };
 
 
@@ -134,7 +151,7 @@ class ElectronCutWeight
       double at (const double &d0);
 
     private:
-      TH1F *electronCutWeight_;
+      BinnedTable electronCutWeight_;
   };
 
 
@@ -147,7 +164,7 @@ class RecoElectronWeight
       double at (const double &d0);
 
     private:
-      TH1F *recoElectronWeight_;
+      BinnedTable recoElectronWeight_;
   };
 
 
@@ -160,7 +177,7 @@ class RecoMuonWeight
       double at (const double &d0);
 
     private:
-      TH1F *recoMuonWeight_;
+      BinnedTable recoMuonWeight_;
   };
 
 
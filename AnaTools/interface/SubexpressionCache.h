@@ -0,0 +1,46 @@
+#ifndef SUBEXPRESSION_CACHE
+
+#define SUBEXPRESSION_CACHE
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Per-event cache of the values of subexpressions which appear in more than
+// one place among the ValueLookupTree objects of a module, e.g., the same
+// deltaR (muon, jet) in a muon-jet cut and in a muon-jet histogram. Each
+// module has its own cache, in its Collections object. Each non-trivial
+// subtree is registered with getExpressionId the first time its tree is given
+// the collections of a module, using a canonical form of the subtree together
+// with the input collections of the tree, so that identical subtrees within
+// the module share an identifier and a use count. Trees which take the same
+// collection more than once, e.g., for muon-muon pairs, are not registered, so
+// none of their subtrees are shared. The values of shared subexpressions are
+// keyed by the identifier and the index of the combination of objects, and
+// the cache is cleared for each event by anatools::getRequiredCollections.
+// Since the registry belongs to a single module, neither registering nor
+// evaluating takes a lock.
+class SubexpressionCache
+  {
+    public:
+      SubexpressionCache () {};
+      ~SubexpressionCache () {};
+
+      unsigned getExpressionId (const string &);
+      bool isShared (const int expression) const { return (expression >= 0 && (unsigned) expression < useCounts_.size () && useCounts_[expression] > 1); };
+
+      void clear () { values_.clear (); };
+      bool find (const unsigned expression, const unsigned combination, double &value) const;
+      void insert (const unsigned expression, const unsigned combination, const double value);
+
+    private:
+      unordered_map<string, unsigned> expressionIds_;
+      vector<unsigned> useCounts_; // indexed by expression
+
+      unordered_map<uint64_t, double> values_;
+  };
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef USER_VARIABLE_TABLE
+
+#define USER_VARIABLE_TABLE
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DataFormats/Common/interface/Handle.h"
+
+#include "OSUT3Analysis/Collections/interface/Uservariable.h"
+
+using namespace std;
+
+// Per-event view of the user variables from all the producers. A variable
+// associated with a single object is stored as a dense column aligned with
+// the collection of that object, so a lookup is an array read at the index of
+// the object. Variables associated with several objects are keyed by the
+// indices of those objects. The indices are only meaningful for the
+// collections given by getCollections. The table is filled once per event by
+// anatools::getRequiredCollections. If several producers give the same
+// variable, the first one wins.
+class UserVariableTable
+  {
+    public:
+      UserVariableTable () {};
+      ~UserVariableTable () {};
+
+      void fill (const vector<edm::Handle<osu::Uservariable> > &);
+
+      // Returns the types of the objects associated with the given variable,
+      // e.g., {"muon", "muon"}, sorted, or NULL if the variable is not in
+      // this event.
+      const vector<string> *getTypes (const string &) const;
+
+      // Returns the ProductID of the collection in which the index of each of
+      // the objects given by getTypes is taken, or NULL if the variable is not
+      // in this event. The ProductID is invalid if the producer did not record
+      // it.
+      const vector<edm::ProductID> *getCollections (const string &) const;
+
+      // Returns the value of the given variable for the objects with the given
+      // indices, in the order of getTypes, or INVALID_VALUE if there is none.
+      double get (const string &, const vector<int> &) const;
+      double get (const string &, const int index) const;
+
+    private:
+      struct Column
+      {
+        bool filled;
+        vector<string> types;
+        vector<edm::ProductID> collections;   // same order as types
+        vector<double> values;                // for zero or one associated objects
+        map<vector<int>, double> combinations; // for several associated objects
+      };
+
+      unordered_map<string, Column> columns_;
+  };
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef VALUE_LOOKUP_TREE
 #define VALUE_LOOKUP_TREE
 
+#include <bitset>
 #include <map>
 #include <set>
 #include <unordered_map>
@@ -109,6 +110,17 @@ class ValueLookupTree
     bool evaluationError () const;
     ////////////////////////////////////////////////////////////////////////////
 
+    // Checks, before any events are processed, that every operator is given
+    // operands of the right kind and that every member exists and is numeric.
+    // Returns false and describes the first problem in the argument otherwise.
+    bool validate (string &) const;
+
+    // Trees over a single collection are evaluated one column at a time when
+    // possible. Turning this off evaluates them one object at a time instead,
+    // which is only useful to check that both give the same values.
+    void setColumnarEvaluation (const bool);
+    bool columnarEvaluation () const;
+
     ////////////////////////////////////////////////////////////////////////////
     // Methods for inserting an expression into the tree and for evaluating the
     // expression.  The evaluate() function returns values for each of the
@@ -129,6 +141,15 @@ class ValueLookupTree
     ////////////////////////////////////////////////////////////////////////////
 
   private:
+    ////////////////////////////////////////////////////////////////////////////
+    // Versions of the above which take the identifier of a collection that was
+    // resolved when the tree was built.
+    ////////////////////////////////////////////////////////////////////////////
+    unsigned getCollectionSize (const CollectionId) const;
+    bool collectionIsFound (const CollectionId) const;
+    void exitMissingCollection (const string &) const;
+    ////////////////////////////////////////////////////////////////////////////
+
     // Method for destroying an entire tree, including all of its children.
     void destroy (Node * const) const;
 
@@ -142,6 +163,50 @@ class ValueLookupTree
     void pruneDots_ (Node * const) const;
     ////////////////////////////////////////////////////////////////////////////
 
+    // Replaces operators whose operands are all numbers with their values.
+    void foldConstants (Node * const);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Recursive methods used by validate ().
+    ////////////////////////////////////////////////////////////////////////////
+    bool validate_ (const Node * const, bool &, string &) const;
+    bool validateMember (const CollectionId, const string &, string &) const;
+    ////////////////////////////////////////////////////////////////////////////
+
+    // Resolves the event variables in the tree to slots in the
+    // EventVariableTable, so that they can be read without any string lookup.
+    void resolveSlots (Node * const) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Methods for resolving the input collections, and the collection of each
+    // collection.member node in the tree, to their identifiers.
+    ////////////////////////////////////////////////////////////////////////////
+    void resolveCollections ();
+    void resolveCollections_ (Node * const) const;
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Methods for finding the subtrees when the tree is built, and registering
+    // them in the SubexpressionCache of a module, so that those shared with
+    // other trees of the module are evaluated once per combination.
+    ////////////////////////////////////////////////////////////////////////////
+    void findSubexpressions ();
+    string findSubexpressions_ (Node * const, const string &);
+    void registerSubexpressions (SubexpressionCache &);
+    ////////////////////////////////////////////////////////////////////////////
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Methods for evaluating trees over a single collection one column of
+    // values at a time, for all the objects at once.
+    ////////////////////////////////////////////////////////////////////////////
+    void initializeColumns ();
+    bool isColumnar (const Node * const) const;
+    unsigned columnDepth (const Node * const) const;
+    void evaluateColumns ();
+    void evaluateColumn_ (const Node * const, const unsigned, const unsigned);
+    void applyColumnOperator (const string &, double * const, const double * const, const unsigned) const;
+    ////////////////////////////////////////////////////////////////////////////
+
     ////////////////////////////////////////////////////////////////////////////
     // Recursive methods for inserting an expression into the tree and then
     // evaluating it.
@@ -161,13 +226,10 @@ class ValueLookupTree
     // Methods for retrieving and deleting an object from a collection.
     // i is the local index
     ////////////////////////////////////////////////////////////////////////////
-    void *getObject (const string &name, const unsigned i);
+    void *getObject (const CollectionId collection, const unsigned i);
+    edm::ProductID getProductId (const CollectionId collection) const;
     ////////////////////////////////////////////////////////////////////////////
 
-    // Returns the C++ type associated with the collection named in the first
-    // argument.
-    string getCollectionType (const string &name) const;
-
     ////////////////////////////////////////////////////////////////////////////
     // Methods which returns true if the first argument looks like a collection
     // name or a number, respectively. The second argument of isNumber receives
@@ -207,26 +269,40 @@ class ValueLookupTree
     ////////////////////////////////////////////////////////////////////////////
     // Methods for retrieving values from objects.
     ////////////////////////////////////////////////////////////////////////////
-    double valueLookup (const string &collection, const ObjMap &objs, const string &variable, const bool iterateObj = true);
+    double valueLookup (const string &collection, const ObjMap &objs, const string &variable, const bool iterateObj = true, const int member = -1);
+    double valueLookup (const CollectionId collection, const ObjMap &objs, const string &variable, const bool iterateObj = true, const int member = -1);
+    double userVariableLookup (const ObjMap &objs, const string &variable) const;
+    bool userVariableCollectionsMatch (const string &variable) const;
+    double getMemberValue (const CollectionId collection, const unsigned index, void * const obj, const string &variable, const int member);
     ////////////////////////////////////////////////////////////////////////////
 
     Node            *root_;
     vector<string>  inputCollections_;
+    vector<CollectionId>  inputCollectionIds_; // same order as inputCollections_
     bool            evaluationError_;
+    mutable unordered_set<string>  mismatchedUserVariables_; // user variables already warned about
+
+    // Identifiers in the MemberValueCache of the members used by the
+    // kinematic operators, e.g., deltaR, resolved when the tree is built.
+    enum {KINEMATIC_ENERGY, KINEMATIC_ETA, KINEMATIC_PHI, KINEMATIC_PT, KINEMATIC_PX, KINEMATIC_PY, KINEMATIC_PZ, N_KINEMATIC_MEMBERS};
+    int             kinematicMembers_[N_KINEMATIC_MEMBERS];
 
     Collections                                    *handles_;
-    unordered_map<string, ObjMap::const_iterator>  objIterators_;  // defined for each collection
-    unordered_map<string, bool>                    shouldIterate_; // defined for each collection
+    ObjMap::const_iterator                         objIterators_[N_COLLECTIONS];  // indexed by collection
+    bool                                           shouldIterate_[N_COLLECTIONS]; // indexed by collection
+    bitset<N_COLLECTIONS>                          objIteratorsSet_; // whether the above are defined for each collection
     vector<Leaf>                                   values_;
     vector<unsigned>                               collectionSizes_; // vector index corresponds to collection index
     vector<unsigned>                               nCombinations_;   // vector index corresponds to collection index
     bool                                           allCollectionsNonEmpty_;
+    unsigned                                       combination_;  // index of the combination being evaluated
+    bool                                           columnar_;     // whether the tree is evaluated by evaluateColumns
+    vector<pair<Node *, string> >                  subexpressions_;    // canonical form of each subtree which may be shared
+    const Collections                              *registeredHandles_; // collections whose cache the subtrees are registered in
+    vector<vector<double> >                        columns_;      // scratch columns used by evaluateColumn_
     // nCombinations[i] specifies the number of combinations that can be formed from objects
     // in collections i to N, where N is the number of collections
 
-    vector<void *> uservariablesToDelete_;
-    vector<void *> eventvariablesToDelete_;
-
     const int                                      verbose_ = 0;  // verbosity levels:  0, 1, ...
     // Typically you want to use verbosity of 1 when running over a single event.
 
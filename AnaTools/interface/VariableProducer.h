@@ -6,6 +6,7 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include "OSUT3Analysis/AnaTools/interface/AnalysisTypes.h"
 #include "OSUT3Analysis/AnaTools/interface/CommonUtils.h"
@@ -32,8 +33,8 @@ class VariableProducer : public edm::EDProducer
       // Methods
 
       template<typename... Objects> void addUserVar (const string &varName, double value, const Objects &... objs);
-      void addUserVar (const string &varName, double value, const ObjectList &objects);
-      template<typename Object, typename... Objects> void addUserVar (const string &varName, double value, const ObjectList &objects, const Object &obj, const Objects &... objs);
+      void addUserVar (const string &varName, UserVariable &userVariable);
+      template<typename Object, typename... Objects> void addUserVar (const string &varName, UserVariable &userVariable, const Object &obj, const Objects &... objs);
 
     private:
 
@@ -50,34 +51,40 @@ class VariableProducer : public edm::EDProducer
 // http://en.cppreference.com/w/cpp/language/parameter_pack
 
 
-// This version of addUserVar(), with no argument for "hashes",
+// This version of addUserVar(), with no argument for the object list,
 // should be called in MyVariableProducer.cc.
 template<typename... Objects> void VariableProducer::addUserVar (const string &varName, double value, const Objects &... objs) {
-  ObjectList objects;
-  addUserVar(varName, value, objects, objs...);  // Now call the recursive function.
+  UserVariable userVariable (value, ObjectList ());
+  addUserVar(varName, userVariable, objs...);  // Now call the recursive function.
 }
 
 
 // This is the recursive version.
-template<typename Object, typename... Objects> void VariableProducer::addUserVar (const string &varName, double value, const ObjectList &objects, const Object &obj, const Objects &... objs) {
+template<typename Object, typename... Objects> void VariableProducer::addUserVar (const string &varName, UserVariable &userVariable, const Object &obj, const Objects &... objs) {
   // "obj" is the first object in the list
-  // calculate it's type and hash
-  // and add them into the list to save
+  // find its type and its index in the corresponding collection of handles_
+  // and add them into the list to save, along with the ProductID of that
+  // collection, so that the index is only used with the same collection
+  // "obj" must be a reference to an element of that collection, not a copy
   auto type = anatools::getObjectType(obj);
-  auto hash = anatools::getObjectHash(obj);
-  objects.emplace(type, hash);
+  edm::ProductID productId;
+  auto index = anatools::getObjectIndex(obj, handles_, productId);
+  if (index < 0)
+    throw cms::Exception ("FatalError") << "\"" << varName << "\" is associated with a " << type << " which is not an element of the " << type << "s collection. Pass a reference to the element rather than a copy.\n";
+  userVariable.objects.emplace(type, index);
+  userVariable.collections[type] = productId;
 
   // Recursively call itself until the size of objs is 0.
   // Then the non-recursive function will be called once.
-  addUserVar(varName, value, objects, objs...);
+  addUserVar(varName, userVariable, objs...);
 }
 
 
 // This is the non-recursive version.
-void VariableProducer::addUserVar (const string &varName, double value, const ObjectList &objects) {
-  // Now there are no more objects to put into hashes,
+inline void VariableProducer::addUserVar (const string &varName, UserVariable &userVariable) {
+  // Now there are no more objects to put into the list,
   // so the new variable is created.
-  (*uservariables)[varName].emplace_back(value, objects);
+  (*uservariables)[varName].push_back(std::move(userVariable));
 }
 
 
@@ -1,21 +1,31 @@
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <set>
 #include <unordered_map>
 
 #include "FWCore/Common/interface/TriggerNames.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
 
 #include "OSUT3Analysis/AnaTools/interface/CommonUtils.h"
 #include "OSUT3Analysis/AnaTools/interface/ValueLookupTree.h"
 #include "OSUT3Analysis/AnaTools/plugins/CutCalculator.h"
 
+#include "TNamed.h"
+
 #define EXIT_CODE 1
 
 CutCalculator::CutCalculator (const edm::ParameterSet &cfg) :
   collections_    (cfg.getParameter<edm::ParameterSet>  ("collections")),
   cuts_           (cfg.getParameter<edm::ParameterSet>  ("cuts")),
   triggersInMenu_ (true),
-  firstEvent_     (true)
+  firstEvent_     (true),
+  shortCircuit_   (cfg.getUntrackedParameter<bool> ("shortCircuit", false)),
+  adaptiveOrdering_       (cfg.getUntrackedParameter<bool>      ("adaptiveOrdering", false)),
+  adaptiveOrderingWarmUp_ (cfg.getUntrackedParameter<unsigned>  ("adaptiveOrderingWarmUp", 1000)),
+  nEvents_        (0),
+  timer_          (cfg.getUntrackedParameter<bool> ("timing", false)),
+  selectionTree_  (NULL)
 {
 
   //////////////////////////////////////////////////////////////////////////////
@@ -28,9 +38,80 @@ CutCalculator::CutCalculator (const edm::ParameterSet &cfg) :
     }
   //////////////////////////////////////////////////////////////////////////////
 
+  //////////////////////////////////////////////////////////////////////////////
+  // Parse the cut strings into ValueLookupTree objects and check them before
+  // any events are processed, so that a mistake in a cut is reported when the
+  // job starts rather than as invalid values in the event loop.
+  //////////////////////////////////////////////////////////////////////////////
+  for (auto &cut : unpackedCuts_)
+    {
+      string message;
+      cut.valueLookupTree = new ValueLookupTree (cut);
+      if (!cut.valueLookupTree->validate (message))
+        {
+          clog << "ERROR: invalid cut \"" << cut.name << "\" (\"" << cut.cutString << "\"): " << message << ". Quitting..." << endl;
+          exit (EXIT_CODE);
+        }
+      if (cut.arbitration != "")
+        {
+          cut.arbitrationTree = new ValueLookupTree (cut.arbitration != "random" ? cut.arbitration : "0.0", cut.inputCollections);
+          if (!cut.arbitrationTree->validate (message))
+            {
+              clog << "ERROR: invalid arbitration for cut \"" << cut.name << "\" (\"" << cut.arbitration << "\"): " << message << ". Quitting..." << endl;
+              exit (EXIT_CODE);
+            }
+        }
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
   triggerNamesPSetID_.reset ();
   triggerIndices_.clear ();
 
+  //////////////////////////////////////////////////////////////////////////////
+  // Adaptive ordering only makes sense if the evaluation stops at the first
+  // failing cut, so it implies short-circuit mode.
+  //////////////////////////////////////////////////////////////////////////////
+  if (adaptiveOrdering_ && !shortCircuit_)
+    {
+      clog << "WARNING: adaptive ordering of the cuts requires short-circuit mode, which is being turned on." << endl;
+      shortCircuit_ = true;
+    }
+  cutRejections_.assign (unpackedCuts_.size (), 0);
+  cutSeconds_.assign (unpackedCuts_.size (), 0.0);
+  //////////////////////////////////////////////////////////////////////////////
+
+  produceTimerSection_ = timer_.addSection ("produce");
+  for (const auto &cut : unpackedCuts_)
+    cutTimerSections_.push_back (timer_.addSection ("cut: " + cut.name));
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Book the optional selection tree. Each cut gets an alias, "cut0", "cut1",
+  // etc., for its bit, so that, e.g., tree->Draw ("event", "cut3") works, and
+  // the name of each cut is stored in the user info of the tree under the
+  // same alias. The bits include the trigger, trigger filter, and MET filter
+  // decisions in either mode, and the mode is stored under "shortCircuit".
+  //////////////////////////////////////////////////////////////////////////////
+  if (cfg.getUntrackedParameter<bool> ("writeSelection", false))
+    {
+      edm::Service<TFileService> fs;
+      unsigned nWords = max ((unsigned) (unpackedCuts_.size () + 63) / 64, 1u);
+      selectionFlags_.assign (nWords, 0);
+      selectionTree_ = fs->make<TTree> ("selection", "cumulative event flags");
+      selectionTree_->Branch ("run", &selectionRun_, "run/i");
+      selectionTree_->Branch ("lumi", &selectionLumi_, "lumi/i");
+      selectionTree_->Branch ("event", &selectionEvent_, "event/l");
+      selectionTree_->Branch ("eventDecision", &selectionEventDecision_, "eventDecision/O");
+      selectionTree_->Branch ("cumulativeFlags", selectionFlags_.data (), ("cumulativeFlags[" + to_string (nWords) + "]/l").c_str ());
+      for (unsigned cutIndex = 0; cutIndex < unpackedCuts_.size (); cutIndex++)
+        {
+          string alias = "cut" + to_string (cutIndex);
+          selectionTree_->SetAlias (alias.c_str (), ("((cumulativeFlags[" + to_string (cutIndex / 64) + "] >> " + to_string (cutIndex % 64) + ") & 1)").c_str ());
+          selectionTree_->GetUserInfo ()->Add (new TNamed (alias.c_str (), unpackedCuts_.at (cutIndex).name.c_str ()));
+        }
+      selectionTree_->GetUserInfo ()->Add (new TNamed ("shortCircuit", shortCircuit_ ? "true" : "false"));
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
   anatools::getAllTokens (collections_, consumesCollector (), tokens_);
 
   produces<CutCalculatorPayload> ("cutDecisions");
@@ -51,11 +132,11 @@ CutCalculator::~CutCalculator ()
 void
 CutCalculator::produce (edm::Event &event, const edm::EventSetup &setup)
 {
+  ScopedTimer produceTimer (timer_, produceTimerSection_);
+
   anatools::getRequiredCollections (objectsToGet_, handles_, event, tokens_);
   //////////////////////////////////////////////////////////////////////////////
-  // Set all the private variables in the ValueLookup object before using it,
-  // and parse the cut strings in the unpacked cuts into ValueLookupTree
-  // objects.
+  // Set all the private variables in the ValueLookup object before using it.
   //////////////////////////////////////////////////////////////////////////////
   if (!initializeValueLookupForest (unpackedCuts_, &handles_))
     {
@@ -69,6 +150,7 @@ CutCalculator::produce (edm::Event &event, const edm::EventSetup &setup)
   //////////////////////////////////////////////////////////////////////////////
   pl_ = unique_ptr<CutCalculatorPayload> (new CutCalculatorPayload);
   pl_->isValid = true;
+  pl_->shortCircuit = shortCircuit_;
   pl_->cuts = unpackedCuts_;
   pl_->triggers = unpackedTriggers_;
   pl_->triggersToVeto = unpackedTriggersToVeto_;
@@ -87,10 +169,46 @@ CutCalculator::produce (edm::Event &event, const edm::EventSetup &setup)
 
   vector<string> listOfObjects = getListOfObjects(pl_->cuts);
 
+  //////////////////////////////////////////////////////////////////////////////
+  // In short-circuit mode, the trigger, trigger filter, and MET filter
+  // decisions are made first, since none of the cuts need to be evaluated if
+  // any of these fail. Otherwise they are made after the cuts.
+  //////////////////////////////////////////////////////////////////////////////
+  bool eventPasses = true;
+  if (shortCircuit_)
+    {
+      evaluateTriggers (event);
+      evaluateTriggerFilters (event);
+      evaluateMETFilters (event);
+      eventPasses = pl_->triggerDecision && pl_->triggerFilterDecision && pl_->metFilterDecision;
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  //////////////////////////////////////////////////////////////////////////////
+  // After the warm-up in adaptive ordering mode, the cuts which reject the
+  // most events per unit time are tried first. If one of them rejects the
+  // event, only the cuts before it in the configured order are evaluated,
+  // stopping at the first which the event fails, and the rest are skipped.
+  // The cut flow is therefore exact, and the cuts after the rejecting one are
+  // skipped just as if the event had failed it in the configured order.
+  //////////////////////////////////////////////////////////////////////////////
+  unsigned nCutsToEvaluate = pl_->cuts.size ();
+  if (adaptiveOrdering_ && nEvents_ == adaptiveOrderingWarmUp_)
+    updatePrescreenOrder ();
+  if (eventPasses && adaptiveOrdering_ && nEvents_ >= adaptiveOrderingWarmUp_)
+    nCutsToEvaluate = prescreenCuts ();
+  nEvents_++;
+  //////////////////////////////////////////////////////////////////////////////
+
   // Loop over cuts to set flags for each object indicating whether it passed
-  // the cut.
-  for (unsigned currentCutIndex = 0; pl_->isValid && currentCutIndex != pl_->cuts.size (); currentCutIndex++)
+  // the cut. In short-circuit mode, the loop stops at the first cut which the
+  // event fails, or at the cut which rejected it in the prescreening.
+  pl_->cutsDecision = true;
+  unsigned currentCutIndex;
+  for (currentCutIndex = 0; pl_->isValid && currentCutIndex != nCutsToEvaluate && eventPasses; currentCutIndex++)
     {
+      ScopedTimer cutTimer (timer_, cutTimerSections_.at (currentCutIndex));
+      auto start = chrono::steady_clock::now ();
       Cut currentCut = pl_->cuts.at (currentCutIndex);
 
       // Sets the flags for the current cut only for the objects which are
@@ -108,8 +226,25 @@ CutCalculator::produce (edm::Event &event, const edm::EventSetup &setup)
 
       // Set flags for all collections unrelated to the cut equal to true
       pl_->isValid = setOtherCollectionsFlags (currentCut, currentCutIndex, listOfObjects);
+
+      // Decide whether the event passes the current cut by counting the number
+      // of objects passing it
+      if (!setEventFlags (currentCut, currentCutIndex) && shortCircuit_)
+        eventPasses = false;
+
+      // Collect the statistics used for ordering the cuts.
+      if (adaptiveOrdering_ && nEvents_ <= adaptiveOrderingWarmUp_)
+        {
+          cutRejections_.at (currentCutIndex) += !pl_->individualEventFlags.back ();
+          cutSeconds_.at (currentCutIndex) += chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+        }
     }
 
+  // Fill the flags for any cuts which were skipped in short-circuit mode,
+  // including the one which rejected the event in the prescreening.
+  if (currentCutIndex < pl_->cuts.size () && pl_->cumulativeEventFlags.size () < pl_->cuts.size ())
+    setSkippedCutFlags (currentCutIndex, listOfObjects);
+
   //////////////////////////////////////////////////////////////////////////////
   // Quit if there was a problem setting the flags for any of the objects.
   //////////////////////////////////////////////////////////////////////////////
@@ -122,20 +257,57 @@ CutCalculator::produce (edm::Event &event, const edm::EventSetup &setup)
 
   // Decide whether the event passes the triggers specified by the user and
   // store the decision in the payload.
-  evaluateTriggers (event);
-  evaluateTriggerFilters (event);
-  evaluateMETFilters (event);
+  if (!shortCircuit_)
+    {
+      evaluateTriggers (event);
+      evaluateTriggerFilters (event);
+      evaluateMETFilters (event);
+    }
+
+  // AND together the cut and trigger decisions.
+  pl_->eventDecision = (pl_->triggerDecision && pl_->triggerFilterDecision && pl_->metFilterDecision && pl_->cutsDecision);
 
-  // Decide whether the event passes each cut
-  // by counting the number of objects passing the cut
-  // also AND together cut and trigger decision
-  setEventFlags ();
+  if (selectionTree_)
+    fillSelectionTree (event);
 
   event.put (std::move (pl_), "cutDecisions");
   pl_.reset ();
   firstEvent_ = false;
 }
 
+void
+CutCalculator::endJob ()
+{
+  if (timer_.enabled ())
+    {
+      edm::Service<TFileService> fs;
+      timer_.write (*fs);
+    }
+}
+
+void
+CutCalculator::fillSelectionTree (const edm::Event &event)
+{
+  selectionRun_ = event.id ().run ();
+  selectionLumi_ = event.id ().luminosityBlock ();
+  selectionEvent_ = event.id ().event ();
+  selectionEventDecision_ = pl_->eventDecision;
+
+  // In short-circuit mode, the cumulative flags are all false if the event
+  // fails the triggers or filters, since no cuts are evaluated, while
+  // otherwise they depend on the cuts alone. They are masked with these
+  // decisions here so that the bits have the same meaning in either mode.
+  bool passesTriggersAndFilters = pl_->triggerDecision && pl_->triggerFilterDecision && pl_->metFilterDecision;
+  fill (selectionFlags_.begin (), selectionFlags_.end (), 0);
+  for (unsigned cutIndex = 0; cutIndex < pl_->cumulativeEventFlags.size (); cutIndex++)
+    {
+      if (passesTriggersAndFilters && pl_->cumulativeEventFlags.at (cutIndex))
+        selectionFlags_.at (cutIndex / 64) |= 1ULL << (cutIndex % 64);
+    }
+
+  selectionTree_->Fill ();
+}
+
 bool
 CutCalculator::setInputCollectionFlags (const Cut &currentCut, unsigned currentCutIndex) const
 {
@@ -831,30 +1003,51 @@ CutCalculator::evaluateTriggerFilters (const edm::Event &event) const
   bool triggerFilterDecision = !pl_->triggerFilters.size ();
   pl_->triggerFilterFlags.resize (pl_->triggerFilters.size (), false);
 
-  if (handles_.triggers.isValid () && handles_.trigobjs.isValid ())
+#if IS_VALID(trigobjs)
+  //////////////////////////////////////////////////////////////////////////////
+  // If the trigger objects were produced by OSUTrigobjProducer, their filter
+  // labels have already been unpacked and indexed, so each filter is a single
+  // lookup. Otherwise, the filter labels of each trigger object are unpacked
+  // once and collected before checking the filters.
+  //////////////////////////////////////////////////////////////////////////////
+  if (handles_.trigobjFilterIndex.isValid ())
     {
-#if DATA_FORMAT == MINI_AOD || DATA_FORMAT == MINI_AOD_CUSTOM
-      const edm::TriggerNames &triggerNames = event.triggerNames (*handles_.triggers);
-#endif
       for (unsigned i = 0; i < pl_->triggerFilters.size (); i++)
         {
+          pl_->triggerFilterFlags.at (i) = handles_.trigobjFilterIndex->passed (pl_->triggerFilters.at (i));
+          triggerFilterDecision = triggerFilterDecision || pl_->triggerFilterFlags.at (i);
+        }
+    }
+  else if (handles_.triggers.isValid () && handles_.trigobjs.isValid ())
+    {
 #if DATA_FORMAT == MINI_AOD || DATA_FORMAT == MINI_AOD_CUSTOM
+      unordered_set<string> filterLabels;
+      if (pl_->triggerFilters.size ())
+        {
+#if CMSSW_VERSION_CODE < CMSSW_VERSION(9,2,0)
+          const edm::TriggerNames &triggerNames = event.triggerNames (*handles_.triggers);
+#endif
           for (auto trigobj : *handles_.trigobjs)
             {
+#if CMSSW_VERSION_CODE >= CMSSW_VERSION(9,2,0)
+              trigobj.unpackNamesAndLabels (event, *handles_.triggers);
+#else
               trigobj.unpackPathNames (triggerNames);
-              for (const auto &filter : trigobj.filterLabels ())
-                {
-                  pl_->triggerFilterFlags.at (i) = (pl_->triggerFilters.at (i) == filter);
-                  if (pl_->triggerFilterFlags.at (i))
-                    break;
-                }
-              if (pl_->triggerFilterFlags.at (i))
-                break;
+#endif
+              filterLabels.insert (trigobj.filterLabels ().begin (), trigobj.filterLabels ().end ());
             }
+        }
+#endif
+      for (unsigned i = 0; i < pl_->triggerFilters.size (); i++)
+        {
+#if DATA_FORMAT == MINI_AOD || DATA_FORMAT == MINI_AOD_CUSTOM
+          pl_->triggerFilterFlags.at (i) = filterLabels.count (pl_->triggerFilters.at (i));
 #endif
           triggerFilterDecision = triggerFilterDecision || pl_->triggerFilterFlags.at (i);
         }
     }
+  //////////////////////////////////////////////////////////////////////////////
+#endif
 
   return (pl_->triggerFilterDecision = triggerFilterDecision);
 }
@@ -920,109 +1113,188 @@ CutCalculator::evaluateMETFilters (const edm::Event &event)
 }
 
 bool
-CutCalculator::setEventFlags () const
+CutCalculator::setEventFlags (const Cut &currentCut, unsigned currentCutIndex) const
 {
-  pl_->cutsDecision = true;
+  int numberPassing = 0;
+  int numberPassingPrev = 0;
+  int numberPassingIndividual = 0;
 
-  // Loop over the cuts, storing the event-wide decision for each in the
-  // payload.
-  for (unsigned currentCutIndex = 0; currentCutIndex != pl_->cuts.size (); currentCutIndex++)
+  //////////////////////////////////////////////////////////////////////////////
+  // Count the number of objects passing the current cut and all previous cuts
+  // in the collection on which this cut acts.
+  //////////////////////////////////////////////////////////////////////////////
+  for (const auto &flag : pl_->cumulativeObjectFlags.at (currentCutIndex).at (currentCut.inputLabel))
     {
-      Cut currentCut = pl_->cuts.at (currentCutIndex);
-      int numberPassing = 0;
-      int numberPassingPrev = 0;
-      int numberPassingIndividual = 0;
+      if (flag.second && flag.first)
+        numberPassing++;
+    }
+  //////////////////////////////////////////////////////////////////////////////
 
-      //////////////////////////////////////////////////////////////////////////
-      // Count the number of objects passing the current cut and all previous
-      // cuts in the collection on which this cut acts.
-      //////////////////////////////////////////////////////////////////////////
-      for (const auto &flag : pl_->cumulativeObjectFlags.at (currentCutIndex).at (currentCut.inputLabel))
-        {
-          if (flag.second && flag.first)
-            numberPassing++;
-        }
-      //////////////////////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////////////////////////
+  // Count the number of objects passing the current cut independently.
+  //////////////////////////////////////////////////////////////////////////////
+  for (const auto &flag : pl_->individualObjectFlags.at (currentCutIndex).at (currentCut.inputLabel))
+    {
+      if (flag.second && flag.first)
+        numberPassingIndividual++;
+    }
+  //////////////////////////////////////////////////////////////////////////////
 
-      //////////////////////////////////////////////////////////////////////////
-      // Count the number of objects passing the current cut independently.
-      //////////////////////////////////////////////////////////////////////////
-      for (const auto &flag : pl_->individualObjectFlags.at (currentCutIndex).at (currentCut.inputLabel))
+  //////////////////////////////////////////////////////////////////////////////
+  // Decide if the event passes this cut. If the cut is a veto, we have to test
+  // the number of objects which failed this cut but which passed all previous
+  // cuts. Remember, the object flags are inverted in the case of a veto.
+  //////////////////////////////////////////////////////////////////////////////
+  bool cutDecision;
+  bool cutDecisionIndividual;
+  if (!currentCut.isVeto)
+    {
+    cutDecision = evaluateComparison (numberPassing, currentCut.eventComparativeOperator, currentCut.numberRequired);
+    cutDecisionIndividual = evaluateComparison (numberPassingIndividual, currentCut.eventComparativeOperator, currentCut.numberRequired);
+    }
+  else
+    {
+      int numberTotalObjects = pl_->cumulativeObjectFlags.at (currentCutIndex).at (currentCut.inputLabel).size();
+      if (currentCutIndex > 0)
         {
-          if (flag.second && flag.first)
-            numberPassingIndividual++;
+          for (const auto &flag : pl_->cumulativeObjectFlags.at (currentCutIndex - 1).at (currentCut.inputLabel))
+            (flag.second && flag.first) && numberPassingPrev++;
         }
-      //////////////////////////////////////////////////////////////////////////
-
-      //////////////////////////////////////////////////////////////////////////
-      // Decide if the event passes this cut. If the cut is a veto, we have to
-      // test the number of objects which failed this cut but which passed all
-      // previous cuts. Remember, the object flags are inverted in the case of a
-      // veto.
-      //////////////////////////////////////////////////////////////////////////
-      bool cutDecision;
-      bool cutDecisionIndividual;
-      if (!currentCut.isVeto)
+      else
         {
-        cutDecision = evaluateComparison (numberPassing, currentCut.eventComparativeOperator, currentCut.numberRequired);
-        cutDecisionIndividual = evaluateComparison (numberPassingIndividual, currentCut.eventComparativeOperator, currentCut.numberRequired);
+          numberPassingPrev = numberTotalObjects;
         }
-      else
+      int numberFailIndividual = numberTotalObjects - numberPassingIndividual;
+      int numberFailCumulative = numberPassingPrev - numberPassing;
+      //          cout << "numberFailIndividual: " <<  numberFailIndividual << endl;
+      //          cout << "numberFailCumulative: " << numberFailCumulative << endl;
+      cutDecision = evaluateComparison (numberFailCumulative, currentCut.eventComparativeOperator, currentCut.numberRequired);
+      cutDecisionIndividual = evaluateComparison (numberFailIndividual, currentCut.eventComparativeOperator, currentCut.numberRequired);
+    }
+
+  // cout << "cutDecision: " << cutDecision << endl;
+  // cout << "cutDecisionIndividual: " << cutDecisionIndividual << endl;
+  //////////////////////////////////////////////////////////////////////////////
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Store the decision for this cut in the payload and update the global cut
+  // decision flag.
+  //////////////////////////////////////////////////////////////////////////////
+  pl_->cumulativeEventFlags.push_back (cutDecision);
+  pl_->cutsDecision = pl_->cutsDecision && cutDecision;
+  pl_->individualEventFlags.push_back (cutDecisionIndividual);
+  //////////////////////////////////////////////////////////////////////////////
+
+  // Return whether the event passes this cut and all previous cuts.
+  return pl_->cutsDecision;
+}
+
+bool
+CutCalculator::setSkippedCutFlags (unsigned firstSkippedCutIndex, const vector<string> &listOfObjects) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // For each cut which was not evaluated in short-circuit mode, the object
+  // flags are marked as invalid and the event flags as failing, so that the
+  // payload has the same structure as when all cuts are evaluated. The event
+  // has already failed a previous cut, so the cumulative flags are correct,
+  // but the individual flags of these cuts are not computed, which is marked
+  // by the shortCircuit member of the payload.
+  //////////////////////////////////////////////////////////////////////////////
+  for (unsigned currentCutIndex = firstSkippedCutIndex; currentCutIndex < pl_->cuts.size (); currentCutIndex++)
+    {
+      const Cut &currentCut = pl_->cuts.at (currentCutIndex);
+
+      if (currentCutIndex >= pl_->individualObjectFlags.size ())
+        pl_->individualObjectFlags.resize (currentCutIndex + 1);
+      if (currentCutIndex >= pl_->cumulativeObjectFlags.size ())
+        pl_->cumulativeObjectFlags.resize (currentCutIndex + 1);
+
+      for (const auto &inputType : listOfObjects)
         {
-          int numberTotalObjects = pl_->cumulativeObjectFlags.at (currentCutIndex).at (currentCut.inputLabel).size();
-          if (currentCutIndex > 0)
-            {
-              for (const auto &flag : pl_->cumulativeObjectFlags.at (currentCutIndex - 1).at (currentCut.inputLabel))
-                (flag.second && flag.first) && numberPassingPrev++;
-            }
-          else
-            {
-              numberPassingPrev = numberTotalObjects;
-            }
-          int numberFailIndividual = numberTotalObjects - numberPassingIndividual;
-          int numberFailCumulative = numberPassingPrev - numberPassing;
-          //          cout << "numberFailIndividual: " <<  numberFailIndividual << endl;
-          //          cout << "numberFailCumulative: " << numberFailCumulative << endl;
-          cutDecision = evaluateComparison (numberFailCumulative, currentCut.eventComparativeOperator, currentCut.numberRequired);
-          cutDecisionIndividual = evaluateComparison (numberFailIndividual, currentCut.eventComparativeOperator, currentCut.numberRequired);
+          vector<string> singleObjects = anatools::getSingleObjects (inputType);
+          int totalSize = 1;
+          for (const auto &singleObject : singleObjects)
+            totalSize *= currentCut.valueLookupTree->getCollectionSize (singleObject);
+
+          pl_->individualObjectFlags.at (currentCutIndex)[inputType] = vector<pair<bool, bool> > (totalSize, make_pair (false, false));
+          pl_->cumulativeObjectFlags.at (currentCutIndex)[inputType] = vector<pair<bool, bool> > (totalSize, make_pair (false, false));
         }
 
-      // cout << "cutDecision: " << cutDecision << endl;
-      // cout << "cutDecisionIndividual: " << cutDecisionIndividual << endl;
-      //////////////////////////////////////////////////////////////////////////
+      pl_->cumulativeEventFlags.push_back (false);
+      pl_->individualEventFlags.push_back (false);
+      pl_->cutsDecision = false;
+    }
+  //////////////////////////////////////////////////////////////////////////////
 
-      //////////////////////////////////////////////////////////////////////////
-      // Store the decision for this cut in the payload and update the global
-      // cut decision flag.
-      //////////////////////////////////////////////////////////////////////////
-      pl_->cumulativeEventFlags.push_back (cutDecision);
-      pl_->cutsDecision = pl_->cutsDecision && cutDecision;
-      pl_->individualEventFlags.push_back (cutDecisionIndividual);
-      //////////////////////////////////////////////////////////////////////////
+  return true;
+}
+
+unsigned
+CutCalculator::prescreenCuts () const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Evaluate the cuts in prescreenOrder_ independently of the others, and
+  // return the index of the first which the event fails, or the number of
+  // cuts if it fails none of them. The values are cached in the
+  // ValueLookupTree objects, so they are not recomputed if the cuts are later
+  // evaluated in the configured order.
+  //////////////////////////////////////////////////////////////////////////////
+  for (const auto &cutIndex : prescreenOrder_)
+    {
+      const Cut &cut = pl_->cuts.at (cutIndex);
+      int numberPassing = 0;
+      for (const auto &cutDecision : cut.valueLookupTree->evaluate ())
+        {
+          double value = boost::get<double> (cutDecision);
+          if (value && !IS_INVALID(value))
+            numberPassing++;
+        }
+      if (!evaluateComparison (numberPassing, cut.eventComparativeOperator, cut.numberRequired))
+        return cutIndex;
     }
+  return pl_->cuts.size ();
+  //////////////////////////////////////////////////////////////////////////////
+}
 
-  // Store the logical AND of the trigger decision and the global cut decision
-  // as the global event decision in the payload and return it.
-  return (pl_->eventDecision = (pl_->triggerDecision && pl_->triggerFilterDecision && pl_->metFilterDecision && pl_->cutsDecision));
+void
+CutCalculator::updatePrescreenOrder ()
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Only cuts for which failing independently implies failing cumulatively
+  // can be evaluated out of order, i.e., cuts on a single collection which
+  // require a minimum number of passing objects and which are neither vetoes
+  // nor arbitrated. These are sorted by the number of events they rejected
+  // per second spent evaluating them during the warm-up.
+  //////////////////////////////////////////////////////////////////////////////
+  prescreenOrder_.clear ();
+  for (unsigned cutIndex = 0; cutIndex < unpackedCuts_.size (); cutIndex++)
+    {
+      const Cut &cut = unpackedCuts_.at (cutIndex);
+      if (cut.isVeto || cut.arbitration != "" || cut.inputCollections.size () != 1)
+        continue;
+      if (cut.eventComparativeOperator != ">=" && cut.eventComparativeOperator != ">")
+        continue;
+      if (!cutRejections_.at (cutIndex))
+        continue;
+      prescreenOrder_.push_back (cutIndex);
+    }
+  sort (prescreenOrder_.begin (), prescreenOrder_.end (), [&](unsigned a, unsigned b) -> bool {
+    return cutRejections_.at (a) * cutSeconds_.at (b) > cutRejections_.at (b) * cutSeconds_.at (a);
+  });
+  //////////////////////////////////////////////////////////////////////////////
 }
 
 bool
 CutCalculator::initializeValueLookupForest (Cuts &cuts, Collections * const handles)
 {
   //////////////////////////////////////////////////////////////////////////////
-  // For each cut, parse its cut string into a new ValueLookupTree object which
-  // is stored in the cut structure.
+  // For each cut, point the ValueLookupTree objects built in the constructor
+  // to the collections for the current event.
   //////////////////////////////////////////////////////////////////////////////
   for (auto &cut : cuts)
     {
-      if (firstEvent_)
-        {
-          cut.valueLookupTree = new ValueLookupTree (cut);
-          if (cut.arbitration != "")
-            cut.arbitrationTree = new ValueLookupTree (cut.arbitration != "random" ? cut.arbitration : "0.0", cut.inputCollections);
-          if (!cut.valueLookupTree->isValid ())
-            return false;
-        }
+      if (!cut.valueLookupTree->isValid ())
+        return false;
       cut.valueLookupTree->setCollections (handles);
       if (cut.arbitration != "")
         cut.arbitrationTree->setCollections (handles);
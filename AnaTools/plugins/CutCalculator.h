@@ -9,6 +9,9 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
 #include "OSUT3Analysis/AnaTools/interface/AnalysisTypes.h"
+#include "OSUT3Analysis/AnaTools/interface/ModuleTimer.h"
+
+#include "TTree.h"
 
 // Declaration of the CutCalculator EDProducer which produces various flags
 // indicating whether the event and each object passed the user-defined cuts.
@@ -19,6 +22,7 @@ class CutCalculator : public edm::EDProducer
     ~CutCalculator ();
 
     void produce (edm::Event &, const edm::EventSetup &);
+    void endJob ();
 
   private:
     ////////////////////////////////////////////////////////////////////////////
@@ -37,7 +41,10 @@ class CutCalculator : public edm::EDProducer
     bool evaluateTriggers (const edm::Event &);
     bool evaluateTriggerFilters (const edm::Event &) const;
     bool evaluateMETFilters (const edm::Event &);
-    bool setEventFlags () const;
+    bool setEventFlags (const Cut &, unsigned) const;
+    bool setSkippedCutFlags (unsigned, const vector<string> &) const;
+    unsigned prescreenCuts () const;
+    void updatePrescreenOrder ();
     vector<string> getListOfObjects (const Cuts &);
     bool isUniqueCase (const Cut &, unsigned, string) const;
 
@@ -50,6 +57,9 @@ class CutCalculator : public edm::EDProducer
     edm::ParameterSet  cuts_;
     bool               triggersInMenu_;
     bool               firstEvent_;
+    bool               shortCircuit_;
+    bool               adaptiveOrdering_;
+    unsigned           adaptiveOrderingWarmUp_;
     ////////////////////////////////////////////////////////////////////////////
 
     ////////////////////////////////////////////////////////////////////////////
@@ -74,9 +84,42 @@ class CutCalculator : public edm::EDProducer
     Collections handles_;
     Tokens tokens_;
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Statistics for each cut, in the configured order, which are collected
+    // during the warm-up of the adaptive ordering mode, and the order in which
+    // the cuts are evaluated before the others once the warm-up is over.
+    ////////////////////////////////////////////////////////////////////////////
+    unsigned long          nEvents_;
+    vector<unsigned long>  cutRejections_;
+    vector<double>         cutSeconds_;
+    vector<unsigned>       prescreenOrder_;
+    ////////////////////////////////////////////////////////////////////////////
+
     // Payload for this EDProducer.
     unique_ptr<CutCalculatorPayload>  pl_;
 
+    // Optional timing of the module and of each cut, with the timer slot of
+    // each cut in the same order as unpackedCuts_.
+    ModuleTimer       timer_;
+    unsigned          produceTimerSection_;
+    vector<unsigned>  cutTimerSections_;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Optional tree with one entry per event, holding the run, lumi, and event
+    // numbers, the event decision, and the cumulative event flags packed into
+    // 64-bit words, with bit i % 64 of word i / 64 for cut i. Bit i is set if
+    // the event passes the triggers, the filters, and cuts 0 through i.
+    ////////////////////////////////////////////////////////////////////////////
+    TTree                       *selectionTree_;
+    unsigned                    selectionRun_;
+    unsigned                    selectionLumi_;
+    unsigned long long          selectionEvent_;
+    bool                        selectionEventDecision_;
+    vector<unsigned long long>  selectionFlags_;
+    ////////////////////////////////////////////////////////////////////////////
+
+    void fillSelectionTree (const edm::Event &);
+
     // Function for initializing the ValueLookupTree objects, one for each cut.
     bool initializeValueLookupForest (Cuts &, Collections * const);
 };
@@ -17,12 +17,13 @@ CutFlowPlotter::CutFlowPlotter (const edm::ParameterSet &cfg) :
 {
   //////////////////////////////////////////////////////////////////////////////
   // Create a directory for this channel and book the cut flow histograms
-  // within.
+  // within. The histogram of the individual cut decisions is booked in the
+  // first event, since it is not filled if the cut calculator is in
+  // short-circuit mode.
   //////////////////////////////////////////////////////////////////////////////
   TH1::SetDefaultSumw2 ();
   oneDHists_["eventCounter"]  =  fs_->make<TH1D>  ("eventCounter",  ";;events",          1,  0.0,  1.0);
   oneDHists_["cutFlow"]       =  fs_->make<TH1D>  ("cutFlow",       ";;passing events",  1,  0.0,  1.0);
-  oneDHists_["selection"]     =  fs_->make<TH1D>  ("selection",     ";;passing events",  1,  0.0,  1.0);
   //  oneDHists_["minusOne"]      =  fs_->make<TH1D>  ("minusOne",      ";;passing events",  1,  0.0,  1.0);
   //////////////////////////////////////////////////////////////////////////////
 
@@ -38,7 +39,7 @@ CutFlowPlotter::~CutFlowPlotter ()
   // module_label_ = channel + module_type_  (module_type_ = "CutFlowPlotter")
 
   TH1D* cutFlow_   = oneDHists_["cutFlow"];
-  TH1D* selection_ = oneDHists_["selection"];
+  TH1D* selection_ = oneDHists_.count ("selection") ? oneDHists_.at ("selection") : NULL;
   //  TH1D* minusOne_  = oneDHists_["minusOne"];
 
   // Print all the cutflow information stored in histograms when this class is destroyed.
@@ -66,13 +67,17 @@ CutFlowPlotter::~CutFlowPlotter ()
   totalEvents = cutFlow_->GetBinContent (1);
   for (int i = 1; i <= cutFlow_->GetNbinsX(); i++) {
     double cutFlow   =   cutFlow_->GetBinContent (i);
-    double selection = selection_->GetBinContent (i);
+    double selection = selection_ ? selection_->GetBinContent (i) : 0.0;
     //    double minusOne  =  minusOne_->GetBinContent (i);
     //    minusOne *= 1.0; // Dummy statement to avoid compilation error for unused variable.
     TString name = cutFlow_->GetXaxis()->GetBinLabel(i);
     clog << setw (longestCutName) << left << name << right << setw (10) << setprecision(1) << cutFlow
-         << setw (15) << setprecision(3) << 100.0 * (cutFlow   / (double) totalEvents) << "%"
-         << setw (15) << setprecision(3) << 100.0 * (selection / (double) totalEvents) << "%"
+         << setw (15) << setprecision(3) << 100.0 * (cutFlow   / (double) totalEvents) << "%";
+    if (selection_)
+      clog << setw (15) << setprecision(3) << 100.0 * (selection / (double) totalEvents) << "%";
+    else
+      clog << setw (16) << "n/a";
+    clog
       //         << setw (15) << setprecision(3) << 100.0 * (minusOne  / (double) totalEvents) << "%"
          << endl;
 
@@ -104,6 +109,8 @@ CutFlowPlotter::~CutFlowPlotter ()
     }
   }
   clog << setw (textWidth+longestCutName) << setfill ('-') << '-' << setfill (' ') << endl;
+  if (!selection_)
+    clog << "Individual efficiencies are not computed in short-circuit mode." << endl;
 
 }
 
@@ -136,6 +143,16 @@ CutFlowPlotter::analyze (const edm::Event &event, const edm::EventSetup &setup)
 bool
 CutFlowPlotter::initializeCutFlow ()
 {
+  //////////////////////////////////////////////////////////////////////////////
+  // In short-circuit mode, the cuts after the first failing one are not
+  // evaluated, so their individual decisions are unknown and the histogram
+  // of them is not booked.
+  //////////////////////////////////////////////////////////////////////////////
+  if (!cutDecisions.isValid () || !cutDecisions->shortCircuit)
+    oneDHists_["selection"]   =  fs_->make<TH1D>  ("selection",     ";;passing events",  1,  0.0,  1.0);
+  TH1D *selection = oneDHists_.count ("selection") ? oneDHists_.at ("selection") : NULL;
+  //////////////////////////////////////////////////////////////////////////////
+
   //////////////////////////////////////////////////////////////////////////////
   // Set the bin label for the first bin, which counts the total number of
   // events. If the cut decisions could not be retrieved from the event, we can
@@ -143,7 +160,8 @@ CutFlowPlotter::initializeCutFlow ()
   //////////////////////////////////////////////////////////////////////////////
   unsigned bin = 1;
   oneDHists_.at ("cutFlow")->GetXaxis    ()->SetBinLabel  (bin,  "total");
-  oneDHists_.at ("selection")->GetXaxis  ()->SetBinLabel  (bin,  "total");
+  if (selection)
+    selection->GetXaxis ()->SetBinLabel  (bin,  "total");
   //  oneDHists_.at ("minusOne")->GetXaxis   ()->SetBinLabel  (bin,  "total");
   bin++;
   if (!cutDecisions.isValid ())
@@ -160,7 +178,8 @@ CutFlowPlotter::initializeCutFlow ()
   cutDecisions->triggerFilters.size () && nCuts++;
   cutDecisions->metFilters.size () && nCuts++;
   oneDHists_.at ("cutFlow")->SetBins    (nCuts + 1,  0.0,  nCuts + 1);
-  oneDHists_.at ("selection")->SetBins  (nCuts + 1,  0.0,  nCuts + 1);
+  if (selection)
+    selection->SetBins  (nCuts + 1,  0.0,  nCuts + 1);
   //  oneDHists_.at ("minusOne")->SetBins   (nCuts + 1,  0.0,  nCuts + 1);
   //////////////////////////////////////////////////////////////////////////////
 
@@ -171,28 +190,32 @@ CutFlowPlotter::initializeCutFlow ()
   if (cutDecisions->triggers.size ())
     {
       oneDHists_.at ("cutFlow")->GetXaxis    ()->SetBinLabel  (bin,  "trigger");
-      oneDHists_.at ("selection")->GetXaxis  ()->SetBinLabel  (bin,  "trigger");
+      if (selection)
+        selection->GetXaxis ()->SetBinLabel  (bin,  "trigger");
       //      oneDHists_.at ("minusOne")->GetXaxis   ()->SetBinLabel  (bin,  "trigger");
       bin++;
     }
   if (cutDecisions->triggerFilters.size ())
     {
       oneDHists_.at ("cutFlow")->GetXaxis    ()->SetBinLabel  (bin,  "trigger filter");
-      oneDHists_.at ("selection")->GetXaxis  ()->SetBinLabel  (bin,  "trigger filter");
+      if (selection)
+        selection->GetXaxis ()->SetBinLabel  (bin,  "trigger filter");
       //      oneDHists_.at ("minusOne")->GetXaxis   ()->SetBinLabel  (bin,  "trigger filter");
       bin++;
     }
   if (cutDecisions->metFilters.size ())
     {
       oneDHists_.at ("cutFlow")->GetXaxis    ()->SetBinLabel  (bin,  "MET filter");
-      oneDHists_.at ("selection")->GetXaxis  ()->SetBinLabel  (bin,  "MET filter");
+      if (selection)
+        selection->GetXaxis ()->SetBinLabel  (bin,  "MET filter");
       //      oneDHists_.at ("minusOne")->GetXaxis   ()->SetBinLabel  (bin,  "trigger filter");
       bin++;
     }
   for (vector<Cut>::const_iterator cut = cutDecisions->cuts.begin (); cut != cutDecisions->cuts.end (); cut++, bin++)
     {
       oneDHists_.at ("cutFlow")->GetXaxis    ()->SetBinLabel  (bin,  cut->name.c_str  ());
-      oneDHists_.at ("selection")->GetXaxis  ()->SetBinLabel  (bin,  cut->name.c_str  ());
+      if (selection)
+        selection->GetXaxis ()->SetBinLabel  (bin,  cut->name.c_str  ());
       //      oneDHists_.at ("minusOne")->GetXaxis   ()->SetBinLabel  (bin,  cut->name.c_str  ());
     }
   //////////////////////////////////////////////////////////////////////////////
@@ -223,9 +246,11 @@ CutFlowPlotter::fillCutFlow (double w)
   //////////////////////////////////////////////////////////////////////////////
   double bin = 0.5;
   bool passes = true;
+  TH1D *selection = oneDHists_.count ("selection") ? oneDHists_.at ("selection") : NULL;
   oneDHists_.at ("eventCounter")->Fill  (bin,  w);
   oneDHists_.at ("cutFlow")->Fill       (bin,  w);
-  oneDHists_.at ("selection")->Fill     (bin,  w);
+  if (selection)
+    selection->Fill                     (bin,  w);
   bin++;
   if (!cutDecisions.isValid ())
     return false;
@@ -238,8 +263,8 @@ CutFlowPlotter::fillCutFlow (double w)
   if (cutDecisions->triggers.size ())
     {
       passes = passes && cutDecisions->triggerDecision;
-      if (cutDecisions->triggerDecision)
-        oneDHists_.at ("selection")->Fill  (bin,  w);
+      if (selection && cutDecisions->triggerDecision)
+        selection->Fill                  (bin,  w);
       if (passes)
         oneDHists_.at ("cutFlow")->Fill    (bin,  w);
       bin++;
@@ -247,8 +272,8 @@ CutFlowPlotter::fillCutFlow (double w)
   if (cutDecisions->triggerFilters.size ())
     {
       passes = passes && cutDecisions->triggerFilterDecision;
-      if (cutDecisions->triggerFilterDecision)
-        oneDHists_.at ("selection")->Fill  (bin,  w);
+      if (selection && cutDecisions->triggerFilterDecision)
+        selection->Fill                  (bin,  w);
       if (passes)
         oneDHists_.at ("cutFlow")->Fill    (bin,  w);
       bin++;
@@ -256,8 +281,8 @@ CutFlowPlotter::fillCutFlow (double w)
   if (cutDecisions->metFilters.size ())
     {
       passes = passes && cutDecisions->metFilterDecision;
-      if (cutDecisions->metFilterDecision)
-        oneDHists_.at ("selection")->Fill  (bin,  w);
+      if (selection && cutDecisions->metFilterDecision)
+        selection->Fill                  (bin,  w);
       if (passes)
         oneDHists_.at ("cutFlow")->Fill    (bin,  w);
       bin++;
@@ -270,10 +295,10 @@ CutFlowPlotter::fillCutFlow (double w)
         oneDHists_.at ("cutFlow")->Fill (bin, w);
     }
   bin = firstBin;  // reset to the first bin with an actual cut
-  for (vector<bool>::const_iterator flag = cutDecisions->individualEventFlags.begin (); flag != cutDecisions->individualEventFlags.end (); flag++, bin++)
+  for (vector<bool>::const_iterator flag = cutDecisions->individualEventFlags.begin (); selection && flag != cutDecisions->individualEventFlags.end (); flag++, bin++)
     {
       if (*flag)
-        oneDHists_.at ("selection")->Fill (bin, w);
+        selection->Fill (bin, w);
     }
   //////////////////////////////////////////////////////////////////////////////
 
@@ -5,11 +5,13 @@
 ISRWeightProducer::ISRWeightProducer (const edm::ParameterSet &cfg) :
   EventVariableProducer(cfg),
   pdgIds_     (cfg.getParameter<vector<int> > ("pdgIds")),
+  genealogy_  (pdgIds_),
   weightFile_ (cfg.getParameter<string> ("weightFile")),
   weightHist_ (cfg.getParameter<string> ("weightHist")),
   weights_    (NULL)
 {
   mcparticlesToken_ = consumes<vector<TYPE(hardInteractionMcparticles)> > (collections_.getParameter<edm::InputTag> ("hardInteractionMcparticles"));
+  isrWeightSlot_ = declareEventVar ("isrWeight");
 }
 
 ISRWeightProducer::~ISRWeightProducer() {
@@ -22,13 +24,13 @@ ISRWeightProducer::AddVariables (const edm::Event &event) {
 
 #if DATA_FORMAT == MINI_AOD_CUSTOM || DATA_FORMAT == MINI_AOD || DATA_FORMAT == AOD
   if(event.isRealData()) {
-    (*eventvariables)["isrWeight"] = 1;
+    setEventVar (isrWeightSlot_, 1);
     return;
   }
 
   edm::Handle<vector<TYPE(hardInteractionMcparticles)> > mcparticles;
   if (!event.getByToken(mcparticlesToken_, mcparticles)) {
-    (*eventvariables)["isrWeight"] = 1;
+    setEventVar (isrWeightSlot_, 1);
     return;
   }
 
@@ -55,32 +57,20 @@ ISRWeightProducer::AddVariables (const edm::Event &event) {
   double px = 0.0;
   double py = 0.0;
 
-  for(const auto &mcparticle : *mcparticles) {
-    for(const auto &pdgId : pdgIds_) {
-      if(abs(mcparticle.pdgId()) == abs(pdgId) && isOriginalParticle(mcparticle, mcparticle.pdgId())) {
-        px += mcparticle.px();
-        py += mcparticle.py();
-      }
-    }
+  genealogy_.update(*mcparticles);
+  for(unsigned i = 0; i < mcparticles->size(); i++) {
+    // a particle matching several of the configured PDG IDs is counted once for each
+    unsigned nMatches = genealogy_.originalPdgIdIndices(i).size();
+    px += nMatches * mcparticles->at(i).px();
+    py += nMatches * mcparticles->at(i).py();
   }
 
   double pt = sqrt(px*px + py*py);
 
-  (*eventvariables)["isrWeight"] = weights_->GetBinContent(weights_->FindBin(pt));
-
-#else
-  (*eventvariables)["isrWeight"] = 1;
-#endif
-}
+  setEventVar (isrWeightSlot_, weights_->GetBinContent(weights_->FindBin(pt)));
 
-bool
-ISRWeightProducer::isOriginalParticle (const TYPE(hardInteractionMcparticles) &mcparticle, const int pdgId) const
-{
-#if DATA_FORMAT == MINI_AOD_CUSTOM || DATA_FORMAT == MINI_AOD || DATA_FORMAT == AOD
-  if(!mcparticle.numberOfMothers () || mcparticle.motherRef ().isNull ()) return true;
-  return(mcparticle.motherRef ()->pdgId () != pdgId) && isOriginalParticle ((TYPE(hardInteractionMcparticles)) *mcparticle.motherRef (), pdgId);
 #else
-  return false;
+  setEventVar (isrWeightSlot_, 1);
 #endif
 }
 
@@ -2,6 +2,7 @@
 #define ISR_WEIGHT_PRODUCER
 
 #include "OSUT3Analysis/AnaTools/interface/EventVariableProducer.h"
+#include "OSUT3Analysis/AnaTools/interface/McparticleGenealogy.h"
 
 #include "TH1D.h"
 #include "TFile.h"
@@ -16,12 +17,14 @@ private:
   edm::EDGetTokenT<vector<TYPE(hardInteractionMcparticles)> > mcparticlesToken_;
 
   vector<int> pdgIds_;
+  McparticleGenealogy genealogy_;
   string weightFile_;
   string weightHist_;
 
   TH1D *weights_;
 
-  bool isOriginalParticle (const TYPE(hardInteractionMcparticles) &, const int) const;
+  unsigned isrWeightSlot_;
+
   void AddVariables(const edm::Event &);
 };
 
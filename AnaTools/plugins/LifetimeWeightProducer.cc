@@ -8,9 +8,11 @@ LifetimeWeightProducer::LifetimeWeightProducer (const edm::ParameterSet &cfg) :
   EventVariableProducer(cfg),
   srcCTau_ (cfg.getParameter<vector<double> > ("srcCTau")),
   dstCTau_ (cfg.getParameter<vector<double> > ("dstCTau")),
-  pdgIds_ (cfg.getParameter<vector<int> > ("pdgIds"))
+  pdgIds_ (cfg.getParameter<vector<int> > ("pdgIds")),
+  genealogy_ (pdgIds_)
 {
   mcparticlesToken_ = consumes<vector<TYPE(hardInteractionMcparticles)> > (collections_.getParameter<edm::InputTag> ("hardInteractionMcparticles"));
+  lifetimeWeightSlot_ = declareEventVar ("lifetimeWeight");
 }
 
 LifetimeWeightProducer::~LifetimeWeightProducer() {}
@@ -22,22 +24,21 @@ LifetimeWeightProducer::AddVariables (const edm::Event &event) {
   edm::Handle<vector<TYPE(hardInteractionMcparticles)> > mcparticles;
   if (!event.getByToken (mcparticlesToken_, mcparticles))
     {
-      (*eventvariables)["lifetimeWeight"] = weight;
+      setEventVar (lifetimeWeightSlot_, weight);
       return;
     }
 
   vector<vector<double> > cTaus;
   cTaus.resize (pdgIds_.size ());
-  for (const auto &mcparticle : *mcparticles)
+  genealogy_.update (*mcparticles);
+  for (unsigned i = 0; i < mcparticles->size (); i++)
     {
-      unsigned iPdgId = 0;
-      for (const auto &pdgId : pdgIds_)
-        {
-          double cTau;
-          if (abs (mcparticle.pdgId ()) == abs (pdgId) && isOriginalParticle (mcparticle, mcparticle.pdgId ()) && (cTau = getCTau (mcparticle)) > 0.0)
-            cTaus.at (iPdgId).push_back (cTau);
-          iPdgId++;
-        }
+      const vector<unsigned> &iPdgIds = genealogy_.originalPdgIdIndices (i);
+      double cTau;
+      if (iPdgIds.empty () || (cTau = getCTau (mcparticles->at (i))) <= 0.0)
+        continue;
+      for (const auto &iPdgId : iPdgIds)
+        cTaus.at (iPdgId).push_back (cTau);
     }
 
   stringstream suffix;
@@ -56,19 +57,7 @@ LifetimeWeightProducer::AddVariables (const edm::Event &event) {
         }
     }
 #endif
-  (*eventvariables)["lifetimeWeight"] = weight;
-}
-
-bool
-LifetimeWeightProducer::isOriginalParticle (const TYPE(hardInteractionMcparticles) &mcparticle, const int pdgId) const
-{
-#if DATA_FORMAT == MINI_AOD_CUSTOM || DATA_FORMAT == MINI_AOD || DATA_FORMAT == AOD
-  if (!mcparticle.numberOfMothers () || mcparticle.motherRef ().isNull ())
-    return true;
-  return (mcparticle.motherRef ()->pdgId () != pdgId) && isOriginalParticle ((TYPE(hardInteractionMcparticles)) *mcparticle.motherRef (), pdgId);
-#else
-  return false;
-#endif
+  setEventVar (lifetimeWeightSlot_, weight);
 }
 
 double
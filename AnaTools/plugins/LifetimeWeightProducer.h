@@ -2,6 +2,7 @@
 #define LIFETIME_WEIGHT_PRODUCER
 
 #include "OSUT3Analysis/AnaTools/interface/EventVariableProducer.h"
+#include "OSUT3Analysis/AnaTools/interface/McparticleGenealogy.h"
 
 class LifetimeWeightProducer : public EventVariableProducer
   {
@@ -15,8 +16,10 @@ class LifetimeWeightProducer : public EventVariableProducer
         vector<double> srcCTau_;
         vector<double> dstCTau_;
         vector<int> pdgIds_;
+        McparticleGenealogy genealogy_;
+
+        unsigned lifetimeWeightSlot_;
 
-        bool isOriginalParticle (const TYPE(hardInteractionMcparticles) &, const int) const;
         double getCTau (const TYPE(hardInteractionMcparticles) &) const;
         void getFinalPosition (const reco::Candidate &, const int, bool, math::XYZPoint &) const;
 
@@ -5,7 +5,10 @@ PDFWeightsPlotter::PDFWeightsPlotter(const edm::ParameterSet &cfg) :
    type_             (cfg.getParameter<string>("type")),
    numPDFWeights_    (cfg.getParameter<uint>("NumPDFWeights")),
    pdfWeightsOffset_ (cfg.getParameter<uint>("PDFWeightsOffset")),
-   firstEvent_       (true)
+   firstEvent_       (true),
+   pdfWeights_       (NULL),
+   sumOfWeights_        (numPDFWeights_ + 1, 0.0),
+   sumOfSquaredWeights_ (numPDFWeights_ + 1, 0.0)
 {
   genInfoProductToken_ = consumes<GenEventInfoProduct> (cfg.getParameter<edm::InputTag> ("GenInfoProduct"));
   lheProductToken_     = consumes<LHEEventProduct> (cfg.getParameter<edm::InputTag> ("LHEProduct"));
@@ -16,7 +19,7 @@ PDFWeightsPlotter::PDFWeightsPlotter(const edm::ParameterSet &cfg) :
     {
       string directoryName = "Generatorweights Plots";
       TFileDirectory subdir = fs_->mkdir(directoryName);
-      subdir.make<TH1D>("PDF Weights", "PDF Weights", numPDFWeights_ + 1, 0, numPDFWeights_ + 1);
+      pdfWeights_ = subdir.make<TH1D>("PDF Weights", "PDF Weights", numPDFWeights_ + 1, 0, numPDFWeights_ + 1);
     }
 }
 PDFWeightsPlotter::~PDFWeightsPlotter() {}
@@ -41,21 +44,36 @@ PDFWeightsPlotter::analyze(const edm::Event &event, const edm::EventSetup &setup
     }
 
   double generatorWeightSign = genInfoProduct->weight()/fabs(genInfoProduct->weight());
-  TH1D *pdfweights = fs_->getObject<TH1D>("PDF Weights", "Generatorweights Plots");
+  double normalization = generatorWeightSign/lheProduct->originalXWGTUP();
 
   if (numPDFWeights_ + pdfWeightsOffset_ > lheProduct->weights().size())
     numPDFWeights_ = lheProduct->weights().size() - pdfWeightsOffset_;
-  pdfweights->SetBinContent(1, pdfweights->GetBinContent(1) + lheProduct->weights()[0].wgt*generatorWeightSign/lheProduct->originalXWGTUP());
 
-  for (uint i = pdfWeightsOffset_; i < numPDFWeights_ + pdfWeightsOffset_; i++) {
-    double oldWeight = pdfweights->GetBinContent(i - pdfWeightsOffset_ + 2);
-    pdfweights->SetBinContent(i - pdfWeightsOffset_ + 2, oldWeight + lheProduct->weights()[i].wgt*generatorWeightSign/lheProduct->originalXWGTUP());
+  double weight = lheProduct->weights()[0].wgt*normalization;
+  sumOfWeights_[0] += weight;
+  sumOfSquaredWeights_[0] += weight*weight;
+
+  const auto &lheWeights = lheProduct->weights();
+  for (uint i = 0; i < numPDFWeights_; i++) {
+    weight = lheWeights[i + pdfWeightsOffset_].wgt*normalization;
+    sumOfWeights_[i + 1] += weight;
+    sumOfSquaredWeights_[i + 1] += weight*weight;
   }
 
   firstEvent_ = false;
 #endif
 }
 
+void
+PDFWeightsPlotter::endJob() {
+  if (!pdfWeights_)
+    return;
+  for (uint bin = 0; bin < sumOfWeights_.size(); bin++) {
+    pdfWeights_->SetBinContent(bin + 1, sumOfWeights_[bin]);
+    pdfWeights_->SetBinError(bin + 1, sqrt(sumOfSquaredWeights_[bin]));
+  }
+}
+
 #if DATA_FORMAT == MINI_AOD_CUSTOM || DATA_FORMAT == MINI_AOD
 #include "FWCore/Framework/interface/MakerMacros.h"
 DEFINE_FWK_MODULE(PDFWeightsPlotter);
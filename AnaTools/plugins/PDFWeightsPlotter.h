@@ -7,6 +7,7 @@
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "OSUT3Analysis/AnaTools/interface/DataFormat.h"
 #include <string>
+#include <vector>
 #include "TH1D.h"
 #include "TFile.h"
 class PDFWeightsPlotter : public edm::EDAnalyzer
@@ -14,6 +15,7 @@ class PDFWeightsPlotter : public edm::EDAnalyzer
     public:
         PDFWeightsPlotter (const edm::ParameterSet &);
         void analyze (const edm::Event &, const edm::EventSetup &);;
+        void endJob ();
         ~PDFWeightsPlotter ();
         edm::Service<TFileService> fs_;
 
@@ -24,5 +26,11 @@ class PDFWeightsPlotter : public edm::EDAnalyzer
         uint numPDFWeights_;
         uint pdfWeightsOffset_;
         bool firstEvent_;
+
+        // The sums of the weights, and of their squares, for each bin of the
+        // histogram, which is only filled in endJob.
+        TH1D *pdfWeights_;
+        vector<double> sumOfWeights_;
+        vector<double> sumOfSquaredWeights_;
 };
 #endif
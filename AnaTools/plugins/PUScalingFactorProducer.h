@@ -3,6 +3,7 @@
 
 #include "OSUT3Analysis/AnaTools/interface/EventVariableProducer.h"
 #include "OSUT3Analysis/AnaTools/interface/DataFormat.h"
+#include "OSUT3Analysis/AnaTools/interface/PUWeight.h"
 #include "OSUT3Analysis/AnaTools/interface/ValueLookupTree.h"
 #include "DataFormats/Math/interface/deltaR.h"
 #include <string>
@@ -21,9 +22,10 @@ class PUScalingFactorProducer : public EventVariableProducer
         string target_;
         string targetUp_;
         string targetDown_;
-        TH1D *puWeight_;
-        TH1D *puWeightUp_;
-        TH1D *puWeightDown_;
+        bool applyPUWeight_;
+        PUWeight puWeight_;
+        PUWeight puWeightUp_;
+        PUWeight puWeightDown_;
         bool isFirstEvent_;
         void AddVariables(const edm::Event &);
 
@@ -21,7 +21,8 @@ Plotter::Plotter (const edm::ParameterSet &cfg) :
   weightDefs_ (cfg.getParameter<vector<edm::ParameterSet> >("weights")),
   histogramSets_ (cfg.getParameter<vector<edm::ParameterSet> >("histogramSets")),
   verbose_ (cfg.getParameter<int> ("verbose")),
-  firstEvent_ (true)
+  firstEvent_ (true),
+  timer_ (cfg.getUntrackedParameter<bool> ("timing", false))
 
 {
   if (verbose_) clog << "Beginning Plotter::Plotter constructor." << endl;
@@ -70,6 +71,9 @@ Plotter::Plotter (const edm::ParameterSet &cfg) :
 
   } // end loop on histogram sets
 
+  // the time for the whole module goes in the first timer slot
+  analyzeTimerSection_ = timer_.addSection("analyze");
+
   // loop over each parsed histogram configuration
   vector<HistoDef>::iterator histogram;
   for(histogram = histogramDefinitions.begin(); histogram != histogramDefinitions.end(); ++histogram){
@@ -77,6 +81,9 @@ Plotter::Plotter (const edm::ParameterSet &cfg) :
     // book a TH1/TH2 in the appropriate folder
     bookHistogram(*histogram);
 
+    // register a timer slot for filling it
+    histogramTimerSections_.push_back(timer_.addSection("histogram: " + histogram->directory + "/" + histogram->name));
+
   } // end loop on parsed histograms
 
   //////////////////////////////////
@@ -98,6 +105,31 @@ Plotter::Plotter (const edm::ParameterSet &cfg) :
     weights.push_back(weight);
   }
 
+  ////////////////////////////////////////////////////////////
+  // parse the input variables and weights into trees and   //
+  // check them before any events are processed             //
+  ////////////////////////////////////////////////////////////
+
+  for(histogram = histogramDefinitions.begin(); histogram != histogramDefinitions.end(); ++histogram){
+    for(vector<string>::const_iterator inputVariable = histogram->inputVariables.begin(); inputVariable != histogram->inputVariables.end(); ++inputVariable){
+      string message;
+      histogram->valueLookupTrees.push_back(new ValueLookupTree(*inputVariable, histogram->inputCollections));
+      if(!histogram->valueLookupTrees.back()->validate(message)){
+        clog << "ERROR: invalid input variable \"" << *inputVariable << "\" of histogram \"" << histogram->name << "\": " << message << ". Quitting..." << endl;
+        exit(EXIT_CODE);
+      }
+    }
+  }
+
+  for(vector<Weight>::iterator weight = weights.begin(); weight != weights.end(); ++weight){
+    string message;
+    weight->valueLookupTree = new ValueLookupTree(weight->inputVariable, weight->inputCollections);
+    if(!weight->valueLookupTree->validate(message)){
+      clog << "ERROR: invalid weight \"" << weight->inputVariable << "\": " << message << ". Quitting..." << endl;
+      exit(EXIT_CODE);
+    }
+  }
+
   anatools::getAllTokens (collections_, consumesCollector (), tokens_);
 }
 
@@ -109,6 +141,8 @@ Plotter::Plotter (const edm::ParameterSet &cfg) :
 void
 Plotter::analyze (const edm::Event &event, const edm::EventSetup &setup)
 {
+  ScopedTimer analyzeTimer (timer_, analyzeTimerSection_);
+
   // get the required collections from the event
   anatools::getRequiredCollections (objectsToGet_, handles_, event, tokens_);
 
@@ -140,14 +174,26 @@ Plotter::analyze (const edm::Event &event, const edm::EventSetup &setup)
   // now we'll loop over the histograms, filling each one as we go
 
   vector<HistoDef>::iterator histogram;
-  for(histogram = histogramDefinitions.begin(); histogram != histogramDefinitions.end(); ++histogram)
+  for(histogram = histogramDefinitions.begin(); histogram != histogramDefinitions.end(); ++histogram){
+    ScopedTimer histogramTimer (timer_, histogramTimerSections_.at(histogram - histogramDefinitions.begin()));
     fillHistogram (*histogram);
+  }
 
   firstEvent_ = false;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
+// write the timing histograms, if requested, once all events are processed
+
+void
+Plotter::endJob ()
+{
+  timer_.write (*fs_);
+}
+
+////////////////////////////////////////////////////////////////////////
+
 Plotter::~Plotter ()
 {
   for (auto &histogram : histogramDefinitions)
@@ -651,21 +697,17 @@ bool
 Plotter::initializeValueLookupForest (vector<HistoDef> &histograms, Collections * const handles)
 {
   //////////////////////////////////////////////////////////////////////////////
-  // For each inputVariable of each histogram, parse it into a new
-  // ValueLookupTree object which is stored in the histogram definition
-  // structure.
+  // For each inputVariable of each histogram, point the ValueLookupTree object
+  // built in the constructor to the collections for the current event.
   //////////////////////////////////////////////////////////////////////////////
   for (vector<HistoDef>::iterator histogram = histograms.begin (); histogram != histograms.end (); histogram++)
     {
-      if (firstEvent_)
+      for (vector<ValueLookupTree *>::iterator tree = histogram->valueLookupTrees.begin (); tree != histogram->valueLookupTrees.end (); tree++)
         {
-          for (vector<string>::const_iterator inputVariable = histogram->inputVariables.begin (); inputVariable != histogram->inputVariables.end (); inputVariable++)
-            histogram->valueLookupTrees.push_back (new ValueLookupTree (*inputVariable, histogram->inputCollections));
-          if (!histogram->valueLookupTrees.back ()->isValid ())
+          if (!(*tree)->isValid ())
             return false;
+          (*tree)->setCollections (handles);
         }
-      for (vector<ValueLookupTree *>::iterator tree = histogram->valueLookupTrees.begin (); tree != histogram->valueLookupTrees.end (); tree++)
-        (*tree)->setCollections (handles);
     }
   return true;
   //////////////////////////////////////////////////////////////////////////////
@@ -676,18 +718,13 @@ bool
 Plotter::initializeValueLookupForest (vector<Weight> &weights, Collections * const handles)
 {
   //////////////////////////////////////////////////////////////////////////////
-  // For each inputVariable of each weight, parse it into a new
-  // ValueLookupTree object which is stored in the weight definition
-  // structure.
+  // For each inputVariable of each weight, point the ValueLookupTree object
+  // built in the constructor to the collections for the current event.
   //////////////////////////////////////////////////////////////////////////////
   for (vector<Weight>::iterator weight = weights.begin (); weight != weights.end (); weight++)
     {
-      if (firstEvent_)
-        {
-          weight->valueLookupTree = new ValueLookupTree (weight->inputVariable, weight->inputCollections);
-          if (!weight->valueLookupTree->isValid ())
-            return false;
-        }
+      if (!weight->valueLookupTree->isValid ())
+        return false;
       weight->valueLookupTree->setCollections (handles);
     }
   return true;
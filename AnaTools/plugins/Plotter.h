@@ -12,6 +12,7 @@
 #include "CommonTools/UtilAlgos/interface/TFileService.h"
 
 #include "OSUT3Analysis/AnaTools/interface/AnalysisTypes.h"
+#include "OSUT3Analysis/AnaTools/interface/ModuleTimer.h"
 
 #include "TH1.h"
 #include "TH2.h"
@@ -24,6 +25,7 @@ class Plotter : public edm::EDAnalyzer
       Plotter (const edm::ParameterSet &);
       ~Plotter ();
       void analyze(const edm::Event&, const edm::EventSetup&);
+      void endJob();
 
     private:
 
@@ -50,6 +52,12 @@ class Plotter : public edm::EDAnalyzer
 
       vector<Weight> weights;
 
+      // optional timing of the module and of each histogram, with the timer
+      // slot of each histogram in the same order as histogramDefinitions
+      ModuleTimer timer_;
+      unsigned analyzeTimerSection_;
+      vector<unsigned> histogramTimerSections_;
+
       string getDirectoryName(const string);
       HistoDef parseHistoDef(const edm::ParameterSet &, const vector<string> &, const string &, const string &);
       void bookHistogram(const HistoDef &);
@@ -6,6 +6,11 @@ PrimaryVtxVarProducer::PrimaryVtxVarProducer(const edm::ParameterSet &cfg) :
   EventVariableProducer(cfg)
 {
   token_ = consumes<vector<TYPE(primaryvertexs)> > (collections_.getParameter<edm::InputTag> ("primaryvertexs"));
+
+  numPVRecoSlot_ = declareEventVar ("numPVReco", EVENT_VAR_INT);
+  leadingPV_xSlot_ = declareEventVar ("leadingPV_x");
+  leadingPV_ySlot_ = declareEventVar ("leadingPV_y");
+  leadingPV_zSlot_ = declareEventVar ("leadingPV_z");
 }
 
 PrimaryVtxVarProducer::~PrimaryVtxVarProducer() {}
@@ -25,10 +30,10 @@ PrimaryVtxVarProducer::AddVariables (const edm::Event &event) {
   double leadingPV_y = pv.y();
   double leadingPV_z = pv.z();
 
-  (*eventvariables)["numPVReco"]       = numPVReco;
-  (*eventvariables)["leadingPV_x"]     = leadingPV_x;
-  (*eventvariables)["leadingPV_y"]     = leadingPV_y;
-  (*eventvariables)["leadingPV_z"]     = leadingPV_z;
+  setEventVar (numPVRecoSlot_,    numPVReco);
+  setEventVar (leadingPV_xSlot_,  leadingPV_x);
+  setEventVar (leadingPV_ySlot_,  leadingPV_y);
+  setEventVar (leadingPV_zSlot_,  leadingPV_z);
 
 }
 
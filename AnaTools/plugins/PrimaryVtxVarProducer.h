@@ -16,6 +16,11 @@ class PrimaryVtxVarProducer : public EventVariableProducer
     private:
         void AddVariables(const edm::Event &);
         edm::EDGetTokenT<vector<TYPE(primaryvertexs)> > token_;
+
+        unsigned numPVRecoSlot_;
+        unsigned leadingPV_xSlot_;
+        unsigned leadingPV_ySlot_;
+        unsigned leadingPV_zSlot_;
   };
 
 #endif
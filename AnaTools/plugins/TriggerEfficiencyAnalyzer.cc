@@ -40,8 +40,14 @@ TriggerEfficiencyAnalyzer::TriggerEfficiencyAnalyzer (const edm::ParameterSet &c
     TriggerHistEffMap  [*triggerType]->GetXaxis()->SetBinLabel (nTriggers+2,"OR of All Triggers");
     effName.ReplaceAll("Eff", " trigger efficiency");
     TriggerHistEffMap  [*triggerType]->SetTitle(effName);
+
+    triggerHistograms_.push_back(TriggerHistogramMap[*triggerType]);
+    orBins_.push_back(nTriggers+1);
   }
 
+  triggerNamesPSetID_.reset();
+  triggerMatches_.clear();
+
   TriggerToken_ = consumes<edm::TriggerResults> (Trigger_);
 }
 
@@ -78,42 +84,51 @@ TriggerEfficiencyAnalyzer::analyze (const edm::Event &event, const edm::EventSet
   event.getByToken (TriggerToken_ , TriggerCollection);
   const edm::TriggerNames &triggerNames = event.triggerNames(*TriggerCollection);
 
-  //initialize maps
-  for(std::vector<string>::const_iterator triggerType = TriggerTypes.begin(); triggerType != TriggerTypes.end(); triggerType++){
-    InclusiveORMap[*triggerType] = false;
+  //find the paths matching the user trigger names only when the trigger menu changes
+  if (triggerNamesPSetID_ != triggerNames.parameterSetID()) {
+    triggerNamesPSetID_ = triggerNames.parameterSetID();
+    matchTriggers(triggerNames);
   }
 
-  int nEvts = 0;
   //fill denominator bin for all trigger types that match generated final state
-  for(std::vector<string>::const_iterator triggerType = TriggerTypes.begin(); triggerType != TriggerTypes.end(); triggerType++) {
-    TriggerHistogramMap[*triggerType]->Fill(0) ;
-    nEvts++;
+  inclusiveOR_.assign(triggerHistograms_.size(), false);
+  for (const auto &histogram : triggerHistograms_)
+    histogram->Fill(0);
+
+  //loop over the trigger paths which match any of the user trigger names
+  for (const auto &triggerMatch : triggerMatches_) {
+    if (!TriggerCollection->accept(triggerMatch.first)) continue;
+    for (const auto &match : triggerMatch.second) {
+      triggerHistograms_.at(match.first)->Fill(match.second);
+      inclusiveOR_.at(match.first) = true;
+    }
   }
 
+  //fill final bin if any triggers were passed
+  for (unsigned iType = 0; iType < triggerHistograms_.size(); iType++)
+    if (inclusiveOR_.at(iType)) triggerHistograms_.at(iType)->Fill(orBins_.at(iType));
+
+} // void TriggerEfficiencyAnalyzer::analyze (const edm::Event &event, const edm::EventSetup &setup)
+
 
-  //loop over all trigger paths in the event
+void
+TriggerEfficiencyAnalyzer::matchTriggers (const edm::TriggerNames &triggerNames)
+{
+  //a path is counted once for each user trigger name it contains
+  triggerMatches_.clear();
   for (unsigned triggerIndex = 0; triggerIndex < triggerNames.size (); triggerIndex++){
-    string name = triggerNames.triggerName(triggerIndex);
-    bool pass = TriggerCollection->accept(triggerIndex);
-    if(pass != 1) continue;
-
-    //loop over the different types of triggers of interest
-    for(std::vector<string>::const_iterator triggerType = TriggerTypes.begin(); triggerType != TriggerTypes.end(); triggerType++){
-      //loop over the different trigger names as specified by the user
-      for(std::vector<string>::const_iterator triggerName = TriggerNameMap[*triggerType].begin(); triggerName != TriggerNameMap[*triggerType].end(); triggerName++){
-        if(name.find(*triggerName)!=std::string::npos){
-          //          cout << name << "  " << *triggerName << " " << name.find(*triggerName) << endl;
-          TriggerHistogramMap[*triggerType]->Fill(triggerName-TriggerNameMap[*triggerType].begin()+1);
-          InclusiveORMap[*triggerType] = true;
-        }
-      }
+    const string &name = triggerNames.triggerName(triggerIndex);
+    vector<pair<unsigned, unsigned> > matches;
+    for (unsigned iType = 0; iType < TriggerTypes.size(); iType++){
+      const vector<string> &userNames = TriggerNameMap[TriggerTypes.at(iType)];
+      for (unsigned iName = 0; iName < userNames.size(); iName++)
+        if (name.find(userNames.at(iName)) != std::string::npos)
+          matches.push_back(make_pair(iType, iName+1));
     }
+    if (!matches.empty())
+      triggerMatches_.push_back(make_pair(triggerIndex, matches));
   }
-  //fill final bin if any triggers were passed
-  for(std::vector<string>::const_iterator triggerType = TriggerTypes.begin(); triggerType != TriggerTypes.end(); triggerType++)
-    if(InclusiveORMap[*triggerType]) TriggerHistogramMap[*triggerType]->Fill(TriggerNameMap[*triggerType].size()+1);
-
-} // void TriggerEfficiencyAnalyzer::analyze (const edm::Event &event, const edm::EventSetup &setup)
+}
 
 
 DEFINE_FWK_MODULE(TriggerEfficiencyAnalyzer);
@@ -32,7 +32,6 @@ class TriggerEfficiencyAnalyzer : public edm::EDAnalyzer
       std::map< string, std::vector<string> > TriggerNameMap;
       std::map< string, TH1D* > TriggerHistogramMap;
       std::map< string, TH1D* > TriggerHistEffMap;
-      std::map< string, bool > InclusiveORMap;
 
       void analyze (const edm::Event &, const edm::EventSetup &);
       const edm::Service<TFileService> fs;
@@ -44,6 +43,20 @@ class TriggerEfficiencyAnalyzer : public edm::EDAnalyzer
       vector<edm::ParameterSet> triggers_;
       TStopwatch* timer;
 
+      // The histogram and bin number of each trigger type, in the same order
+      // as TriggerTypes, and the bin of the OR of all its triggers.
+      vector<TH1D *> triggerHistograms_;
+      vector<unsigned> orBins_;
+
+      // For each trigger path in the current menu which matches at least one
+      // of the user trigger names, its index and the (trigger type, bin) pairs
+      // to fill when it passes. Rebuilt only when the menu changes.
+      edm::ParameterSetID triggerNamesPSetID_;
+      vector<pair<unsigned, vector<pair<unsigned, unsigned> > > > triggerMatches_;
+      vector<bool> inclusiveOR_;
+
+      void matchTriggers (const edm::TriggerNames &);
+
   };
 
 #endif
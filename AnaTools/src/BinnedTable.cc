@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "TAxis.h"
+
+#include "OSUT3Analysis/AnaTools/interface/BinnedTable.h"
+
+BinnedTable::BinnedTable (const TH1 &h, const bool clamp) :
+  clamp_ (clamp)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // The contents and errors of every global bin, including the underflow and
+  // overflow bins, are copied, so the global bins are the same as in ROOT.
+  //////////////////////////////////////////////////////////////////////////////
+  const TAxis * const axes[3] = {h.GetXaxis (), h.GetYaxis (), h.GetZaxis ()};
+  vector<vector<double> > edges (h.GetDimension ());
+  for (unsigned axis = 0; axis < edges.size (); axis++)
+    {
+      for (int bin = 1; bin <= axes[axis]->GetNbins () + 1; bin++)
+        edges.at (axis).push_back (axes[axis]->GetBinLowEdge (bin));
+      edges.at (axis).front () = axes[axis]->GetXmin ();
+      edges.at (axis).back () = axes[axis]->GetXmax ();
+    }
+  setAxes (edges);
+  for (unsigned axis = 0; axis < edges.size (); axis++)
+    uniform_.at (axis) = !axes[axis]->IsVariableBinSize ();
+
+  for (unsigned bin = 0; bin < values_.size (); bin++)
+    {
+      values_.at (bin) = h.GetBinContent (bin);
+      errorsUp_.at (bin) = errorsDown_.at (bin) = h.GetBinError (bin);
+    }
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+BinnedTable::BinnedTable (const string &tableFile, const bool clamp) :
+  clamp_ (clamp)
+{
+  ifstream fin (tableFile);
+  if (!fin.is_open ())
+    {
+      clog << "ERROR [BinnedTable]: Could not find file: " << tableFile << endl;
+      exit (1);
+    }
+
+  vector<vector<double> > edges;
+  vector<vector<double> > bins;
+  vector<double> defaults = {0.0, 0.0, 0.0};
+  string line;
+  while (getline (fin, line))
+    {
+      stringstream ss (line.substr (0, line.find ('#')));
+      string keyword, word;
+      vector<double> numbers;
+      if (!(ss >> keyword))
+        continue;
+      if (keyword != "axis" && keyword != "default")
+        numbers.push_back (strtod (keyword.c_str (), NULL));
+      while (ss >> word)
+        numbers.push_back (strtod (word.c_str (), NULL));
+
+      if (keyword == "axis")
+        edges.push_back (numbers);
+      else if (keyword == "default")
+        {
+          for (unsigned i = 0; i < numbers.size () && i < 3; i++)
+            defaults.at (i) = numbers.at (i);
+          if (numbers.size () == 2)
+            defaults.at (2) = defaults.at (1);
+        }
+      else
+        bins.push_back (numbers);
+    }
+
+  for (const auto &axis : edges)
+    {
+      if (axis.size () < 2 || !is_sorted (axis.begin (), axis.end ()))
+        {
+          clog << "ERROR [BinnedTable]: Invalid axis in " << tableFile << endl;
+          exit (1);
+        }
+    }
+  setAxes (edges);
+  values_.assign (values_.size (), defaults.at (0));
+  errorsUp_.assign (errorsUp_.size (), defaults.at (1));
+  errorsDown_.assign (errorsDown_.size (), defaults.at (2));
+
+  for (const auto &bin : bins)
+    {
+      if (bin.size () < nAxes () + 1 || bin.size () > nAxes () + 3)
+        {
+          clog << "ERROR [BinnedTable]: Invalid bin in " << tableFile << endl;
+          exit (1);
+        }
+      unsigned globalBin = 0;
+      for (unsigned axis = 0; axis < nAxes (); axis++)
+        {
+          unsigned axisBin = bin.at (axis);
+          if (axisBin > edges_.at (axis).size ())
+            {
+              clog << "ERROR [BinnedTable]: Invalid bin in " << tableFile << endl;
+              exit (1);
+            }
+          globalBin += axisBin * strides_.at (axis);
+        }
+      values_.at (globalBin) = bin.at (nAxes ());
+      errorsUp_.at (globalBin) = (bin.size () > nAxes () + 1 ? bin.at (nAxes () + 1) : 0.0);
+      errorsDown_.at (globalBin) = (bin.size () > nAxes () + 2 ? bin.at (nAxes () + 2) : errorsUp_.at (globalBin));
+    }
+}
+
+BinnedTable::BinnedTable (const vector<vector<double> > &edges, const vector<double> &values, const vector<double> &errorsUp, const vector<double> &errorsDown, const bool clamp) :
+  clamp_ (clamp)
+{
+  setAxes (edges);
+  if (values.size () != values_.size () || errorsUp.size () != values_.size () || errorsDown.size () != values_.size ())
+    {
+      clog << "ERROR [BinnedTable]: Expected " << values_.size () << " bins, including the underflow and overflow bins." << endl;
+      exit (1);
+    }
+  values_ = values;
+  errorsUp_ = errorsUp;
+  errorsDown_ = errorsDown;
+}
+
+unsigned
+BinnedTable::findBin (const double &x) const
+{
+  return findAxisBin (0, x);
+}
+
+unsigned
+BinnedTable::findBin (const double &x, const double &y) const
+{
+  return findAxisBin (0, x) + findAxisBin (1, y) * strides_[1];
+}
+
+unsigned
+BinnedTable::findBin (const vector<double> &x) const
+{
+  unsigned bin = 0;
+  for (unsigned axis = 0; axis < nAxes (); axis++)
+    bin += findAxisBin (axis, x.at (axis)) * strides_[axis];
+  return bin;
+}
+
+void
+BinnedTable::setAxes (const vector<vector<double> > &edges)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Each axis has nBins + 2 bins, counting the underflow and overflow bins,
+  // and the first axis varies fastest, as in ROOT. Axes from a text table are
+  // not assumed to have bins of the same width.
+  //////////////////////////////////////////////////////////////////////////////
+  unsigned nBins = 1;
+  edges_ = edges;
+  uniform_.assign (edges.size (), false);
+  strides_.clear ();
+  for (const auto &axis : edges)
+    {
+      strides_.push_back (nBins);
+      nBins *= axis.size () + 1;
+    }
+  values_.assign (nBins, 0.0);
+  errorsUp_.assign (nBins, 0.0);
+  errorsDown_.assign (nBins, 0.0);
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+unsigned
+BinnedTable::findAxisBin (const unsigned axis, const double &x) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Same as TAxis::FindBin, including sending NaN to the overflow bin.
+  //////////////////////////////////////////////////////////////////////////////
+  const vector<double> &edges = edges_[axis];
+  unsigned nBins = edges.size () - 1, bin;
+  if (x < edges.front ())
+    bin = 0;
+  else if (!(x < edges.back ()))
+    bin = nBins + 1;
+  else if (uniform_[axis])
+    bin = 1 + int (nBins * (x - edges.front ()) / (edges.back () - edges.front ()));
+  else
+    bin = upper_bound (edges.begin (), edges.end (), x) - edges.begin ();
+
+  if (clamp_)
+    bin = max (min (bin, nBins), 1u);
+  return bin;
+  //////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,92 @@
+#include <cstring>
+#include <unordered_map>
+
+#include "OSUT3Analysis/AnaTools/interface/CollectionRegistry.h"
+#include "OSUT3Analysis/AnaTools/interface/DataFormat.h"
+
+// An object collection is only valid if its type is defined in the current
+// data format, as in the EQ_VALID macro.
+#define OBJECT_COLLECTION(x, type) {XSTR(x), type, (bool) strcmp (TYPE_STR(x), XSTR(INVALID_TYPE))}
+#define OTHER_COLLECTION(x) {XSTR(x), "", false}
+
+namespace
+{
+  struct CollectionInfo
+  {
+    string name;
+    string type;
+    bool isObjectCollection;
+  };
+
+  // Must be in the same order as the CollectionId enum.
+  const CollectionInfo collectionInfos[N_COLLECTIONS + 1] = {
+    OBJECT_COLLECTION(beamspots, "osu::Beamspot"),
+    OBJECT_COLLECTION(bxlumis, "osu::Bxlumi"),
+    OBJECT_COLLECTION(cschits, "osu::Cschit"),
+    OBJECT_COLLECTION(cscsegs, "osu::Cscseg"),
+    OBJECT_COLLECTION(dtsegs, "osu::Dtseg"),
+    OBJECT_COLLECTION(electrons, "osu::Electron"),
+    OBJECT_COLLECTION(events, "osu::Event"),
+    OBJECT_COLLECTION(genjets, "osu::Genjet"),
+    OBJECT_COLLECTION(generatorweights, "osu::Generatorweight"),
+    OBJECT_COLLECTION(basicjets, "osu::Basicjet"),
+    OBJECT_COLLECTION(jets, "osu::Jet"),
+    OBJECT_COLLECTION(bjets, "osu::Bjet"),
+    OBJECT_COLLECTION(mcparticles, "osu::Mcparticle"),
+    OBJECT_COLLECTION(mets, "osu::Met"),
+    OBJECT_COLLECTION(muons, "osu::Muon"),
+    OBJECT_COLLECTION(photons, "osu::Photon"),
+    OBJECT_COLLECTION(primaryvertexs, "osu::Primaryvertex"),
+    OBJECT_COLLECTION(rpchits, "osu::Rpchit"),
+    OBJECT_COLLECTION(superclusters, "osu::Supercluster"),
+    OBJECT_COLLECTION(taus, "osu::Tau"),
+    OBJECT_COLLECTION(tracks, "osu::Track"),
+    OBJECT_COLLECTION(secondaryTracks, "osu::SecondaryTrack"),
+    OBJECT_COLLECTION(pileupinfos, "osu::PileUpInfo"),
+    OBJECT_COLLECTION(uservariables, "osu::Uservariable"),
+    OBJECT_COLLECTION(eventvariables, "osu::Eventvariable"),
+    OTHER_COLLECTION(triggers),
+    OTHER_COLLECTION(metFilters),
+    OTHER_COLLECTION(prescales),
+    OTHER_COLLECTION(trigobjs),
+    {"", "", false} // COLLECTION_INVALID
+  };
+}
+
+CollectionId
+anatools::getCollectionId (const string &name)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // The map is a function-local static, so it is built exactly once, even if
+  // modules are constructed concurrently.
+  //////////////////////////////////////////////////////////////////////////////
+  static const unordered_map<string, CollectionId> collectionIds = [] ()
+    {
+      unordered_map<string, CollectionId> ids;
+      for (unsigned i = 0; i < N_COLLECTIONS; i++)
+        ids[collectionInfos[i].name] = (CollectionId) i;
+      return ids;
+    } ();
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto id = collectionIds.find (name);
+  return (id != collectionIds.end () ? id->second : COLLECTION_INVALID);
+}
+
+bool
+anatools::isObjectCollection (const CollectionId collection)
+{
+  return collectionInfos[collection].isObjectCollection;
+}
+
+const string &
+anatools::getCollectionName (const CollectionId collection)
+{
+  return collectionInfos[collection].name;
+}
+
+const string &
+anatools::getCollectionType (const CollectionId collection)
+{
+  return collectionInfos[collection].type;
+}
@@ -195,34 +195,48 @@ anatools::getRequiredCollections (const unordered_set<string> &objectsToGet, Col
   // Retrieve each object collection which we need and print a warning if it is
   // missing.
   //////////////////////////////////////////////////////////////////////////////
-  if  (VEC_CONTAINS  (objectsToGet,  "beamspots") && !tokens.beamspots.isUninitialized())         event.getByToken  (tokens.beamspots,         handles.beamspots);
-  if  (VEC_CONTAINS  (objectsToGet,  "bxlumis")   && !tokens.bxlumis.isUninitialized())           event.getByToken  (tokens.bxlumis,           handles.bxlumis);
-  if  (VEC_CONTAINS  (objectsToGet,  "cschits")   && !tokens.cschits.isUninitialized())           event.getByToken  (tokens.cschits,           handles.cschits);
-  if  (VEC_CONTAINS  (objectsToGet,  "cscsegs")   && !tokens.cscsegs.isUninitialized())           event.getByToken  (tokens.cscsegs,           handles.cscsegs);
-  if  (VEC_CONTAINS  (objectsToGet,  "dtsegs")    && !tokens.dtsegs.isUninitialized())            event.getByToken  (tokens.dtsegs,            handles.dtsegs);
-  if  (VEC_CONTAINS  (objectsToGet,  "electrons") && !tokens.electrons.isUninitialized())         event.getByToken  (tokens.electrons,         handles.electrons);
-  if  (VEC_CONTAINS  (objectsToGet,  "events")    && !tokens.events.isUninitialized())            event.getByToken  (tokens.events,            handles.events);
-  if  (VEC_CONTAINS  (objectsToGet,  "genjets")   && !tokens.genjets.isUninitialized())           event.getByToken  (tokens.genjets,           handles.genjets);
-  if  (VEC_CONTAINS  (objectsToGet,  "jets")      && !tokens.jets.isUninitialized())              event.getByToken  (tokens.jets,              handles.jets);
-  if  (VEC_CONTAINS  (objectsToGet,  "bjets")     && !tokens.bjets.isUninitialized())             event.getByToken  (tokens.bjets,             handles.bjets);
-  if  (VEC_CONTAINS  (objectsToGet,  "basicjets") && !tokens.basicjets.isUninitialized())         event.getByToken  (tokens.basicjets,         handles.basicjets);
-  if  (VEC_CONTAINS  (objectsToGet,  "generatorweights") && !tokens.generatorweights.isUninitialized())  event.getByToken  (tokens.generatorweights,  handles.generatorweights);
-  if  (VEC_CONTAINS  (objectsToGet,  "mcparticles")      && !tokens.mcparticles.isUninitialized())       event.getByToken  (tokens.mcparticles,       handles.mcparticles);
-  if  (VEC_CONTAINS  (objectsToGet,  "mets")             && !tokens.mets.isUninitialized())              event.getByToken  (tokens.mets,              handles.mets);
-  if  (VEC_CONTAINS  (objectsToGet,  "muons")            && !tokens.muons.isUninitialized())             event.getByToken  (tokens.muons,             handles.muons);
-  if  (VEC_CONTAINS  (objectsToGet,  "photons")          && !tokens.photons.isUninitialized())           event.getByToken  (tokens.photons,           handles.photons);
-  if  (VEC_CONTAINS  (objectsToGet,  "prescales")        && !tokens.prescales.isUninitialized())         event.getByToken  (tokens.prescales,         handles.prescales);
-  if  (VEC_CONTAINS  (objectsToGet,  "primaryvertexs")   && !tokens.primaryvertexs.isUninitialized())    event.getByToken  (tokens.primaryvertexs,    handles.primaryvertexs);
-  if  (VEC_CONTAINS  (objectsToGet,  "rpchits")          && !tokens.rpchits.isUninitialized())    event.getByToken  (tokens.rpchits,    handles.rpchits);
-  if  (VEC_CONTAINS  (objectsToGet,  "superclusters")    && !tokens.superclusters.isUninitialized())     event.getByToken  (tokens.superclusters,     handles.superclusters);
-  if  (VEC_CONTAINS  (objectsToGet,  "taus")             && !tokens.taus.isUninitialized())              event.getByToken  (tokens.taus,              handles.taus);
-  if  (VEC_CONTAINS  (objectsToGet,  "tracks")           && !tokens.tracks.isUninitialized())            event.getByToken  (tokens.tracks,            handles.tracks);
-  if  (VEC_CONTAINS  (objectsToGet,  "secondaryTracks")  && !tokens.secondaryTracks.isUninitialized())   event.getByToken  (tokens.secondaryTracks,   handles.secondaryTracks);
-  if  (VEC_CONTAINS  (objectsToGet,  "pileupinfos")      && !tokens.pileupinfos.isUninitialized())       event.getByToken  (tokens.pileupinfos,       handles.pileupinfos);
-  if  (VEC_CONTAINS  (objectsToGet,  "triggers")         && !tokens.triggers.isUninitialized())          event.getByToken  (tokens.triggers,          handles.triggers);
-  if  (VEC_CONTAINS  (objectsToGet,  "metFilters")         && !tokens.metFilters.isUninitialized())          event.getByToken  (tokens.metFilters,          handles.metFilters);
-  if  (VEC_CONTAINS  (objectsToGet,  "trigobjs")         && !tokens.trigobjs.isUninitialized())          event.getByToken  (tokens.trigobjs,          handles.trigobjs);
-  if  (VEC_CONTAINS  (objectsToGet,  "uservariables"))
+  handles.memberValueCache.clear ();
+  handles.subexpressionCache.clear ();
+
+  bitset<N_COLLECTIONS> required;
+  for (const auto &object : objectsToGet)
+    {
+      CollectionId collection = getCollectionId (object);
+      if (collection != COLLECTION_INVALID)
+        required.set (collection);
+    }
+
+  if  (required.test  (COLLECTION_BEAMSPOTS)      && !tokens.beamspots.isUninitialized())         event.getByToken  (tokens.beamspots,         handles.beamspots);
+  if  (required.test  (COLLECTION_BXLUMIS)        && !tokens.bxlumis.isUninitialized())           event.getByToken  (tokens.bxlumis,           handles.bxlumis);
+  if  (required.test  (COLLECTION_CSCHITS)        && !tokens.cschits.isUninitialized())           event.getByToken  (tokens.cschits,           handles.cschits);
+  if  (required.test  (COLLECTION_CSCSEGS)        && !tokens.cscsegs.isUninitialized())           event.getByToken  (tokens.cscsegs,           handles.cscsegs);
+  if  (required.test  (COLLECTION_DTSEGS)         && !tokens.dtsegs.isUninitialized())            event.getByToken  (tokens.dtsegs,            handles.dtsegs);
+  if  (required.test  (COLLECTION_ELECTRONS)      && !tokens.electrons.isUninitialized())         event.getByToken  (tokens.electrons,         handles.electrons);
+  if  (required.test  (COLLECTION_EVENTS)         && !tokens.events.isUninitialized())            event.getByToken  (tokens.events,            handles.events);
+  if  (required.test  (COLLECTION_GENJETS)        && !tokens.genjets.isUninitialized())           event.getByToken  (tokens.genjets,           handles.genjets);
+  if  (required.test  (COLLECTION_JETS)           && !tokens.jets.isUninitialized())              event.getByToken  (tokens.jets,              handles.jets);
+  if  (required.test  (COLLECTION_BJETS)          && !tokens.bjets.isUninitialized())             event.getByToken  (tokens.bjets,             handles.bjets);
+  if  (required.test  (COLLECTION_BASICJETS)      && !tokens.basicjets.isUninitialized())         event.getByToken  (tokens.basicjets,         handles.basicjets);
+  if  (required.test  (COLLECTION_GENERATORWEIGHTS)      && !tokens.generatorweights.isUninitialized())  event.getByToken  (tokens.generatorweights,  handles.generatorweights);
+  if  (required.test  (COLLECTION_MCPARTICLES)           && !tokens.mcparticles.isUninitialized())       event.getByToken  (tokens.mcparticles,       handles.mcparticles);
+  if  (required.test  (COLLECTION_METS)                  && !tokens.mets.isUninitialized())              event.getByToken  (tokens.mets,              handles.mets);
+  if  (required.test  (COLLECTION_MUONS)                 && !tokens.muons.isUninitialized())             event.getByToken  (tokens.muons,             handles.muons);
+  if  (required.test  (COLLECTION_PHOTONS)               && !tokens.photons.isUninitialized())           event.getByToken  (tokens.photons,           handles.photons);
+  if  (required.test  (COLLECTION_PRESCALES)             && !tokens.prescales.isUninitialized())         event.getByToken  (tokens.prescales,         handles.prescales);
+  if  (required.test  (COLLECTION_PRIMARYVERTEXS)        && !tokens.primaryvertexs.isUninitialized())    event.getByToken  (tokens.primaryvertexs,    handles.primaryvertexs);
+  if  (required.test  (COLLECTION_RPCHITS)               && !tokens.rpchits.isUninitialized())    event.getByToken  (tokens.rpchits,    handles.rpchits);
+  if  (required.test  (COLLECTION_SUPERCLUSTERS)         && !tokens.superclusters.isUninitialized())     event.getByToken  (tokens.superclusters,     handles.superclusters);
+  if  (required.test  (COLLECTION_TAUS)                  && !tokens.taus.isUninitialized())              event.getByToken  (tokens.taus,              handles.taus);
+  if  (required.test  (COLLECTION_TRACKS)                && !tokens.tracks.isUninitialized())            event.getByToken  (tokens.tracks,            handles.tracks);
+  if  (required.test  (COLLECTION_SECONDARYTRACKS)       && !tokens.secondaryTracks.isUninitialized())   event.getByToken  (tokens.secondaryTracks,   handles.secondaryTracks);
+  if  (required.test  (COLLECTION_PILEUPINFOS)           && !tokens.pileupinfos.isUninitialized())       event.getByToken  (tokens.pileupinfos,       handles.pileupinfos);
+  if  (required.test  (COLLECTION_TRIGGERS)              && !tokens.triggers.isUninitialized())          event.getByToken  (tokens.triggers,          handles.triggers);
+  if  (required.test  (COLLECTION_METFILTERS)              && !tokens.metFilters.isUninitialized())          event.getByToken  (tokens.metFilters,          handles.metFilters);
+  if  (required.test  (COLLECTION_TRIGOBJS)              && !tokens.trigobjs.isUninitialized())          event.getByToken  (tokens.trigobjs,          handles.trigobjs);
+#if IS_VALID(trigobjs)
+  if  (required.test  (COLLECTION_TRIGOBJS)              && !tokens.trigobjFilterIndex.isUninitialized())  event.getByToken  (tokens.trigobjFilterIndex,  handles.trigobjFilterIndex);
+#endif
+  if  (required.test  (COLLECTION_USERVARIABLES))
     {
       handles.uservariables.clear ();
       for (const auto &token : tokens.uservariables)
@@ -230,8 +244,9 @@ anatools::getRequiredCollections (const unordered_set<string> &objectsToGet, Col
           handles.uservariables.resize (handles.uservariables.size () + 1);
           event.getByToken (token, handles.uservariables.back ());
         }
+      handles.uservariableTable.fill (handles.uservariables);
     }
-  if  (VEC_CONTAINS  (objectsToGet,  "eventvariables"))
+  if  (required.test  (COLLECTION_EVENTVARIABLES))
     {
       handles.eventvariables.clear ();
       for (const auto &token : tokens.eventvariables)
@@ -239,6 +254,13 @@ anatools::getRequiredCollections (const unordered_set<string> &objectsToGet, Col
           handles.eventvariables.resize (handles.eventvariables.size () + 1);
           event.getByToken (token, handles.eventvariables.back ());
         }
+      handles.eventvariableRecords.clear ();
+      for (const auto &token : tokens.eventvariableRecords)
+        {
+          handles.eventvariableRecords.resize (handles.eventvariableRecords.size () + 1);
+          event.getByToken (token, handles.eventvariableRecords.back ());
+        }
+      handles.eventvariableTable.fill (handles.eventvariables, handles.eventvariableRecords);
     }
 
   if (firstEvent)
@@ -556,6 +578,66 @@ anatools::getRequiredCollections (const unordered_set<string> &objectsToGet, Col
     return value;
   }
 
+/**
+ * Finds the type of a member of a class from the dictionaries alone, so that
+ * expressions can be checked before any objects exist.
+ *
+ * @param  type string giving the type of the object
+ * @param  member string giving the member, data or function, to evaluate,
+ *         possibly with dots for the members of members
+ * @return string giving the type of the member, or an empty string if it
+ *         cannot be found or is a reference
+ */
+  string
+  anatools::getMemberType (const string &type, const string &member)
+  {
+    anatools::TypeWithDict t = anatools::TypeWithDict::byName (type);
+    if (!t)
+      return "";
+    return getMemberType (t, member);
+  }
+
+  string
+  anatools::getMemberType (const anatools::TypeWithDict &t, const string &member)
+  {
+    string typeName = t.name ();
+    size_t dot = member.find ('.'),
+           asterisk = typeName.rfind ('*');
+
+    if (t.isReference ())
+      return "";
+    if (t.isPointer ())
+      return getMemberType (typeName.substr (0, asterisk) + typeName.substr (asterisk + 1), member);
+    if (dot != string::npos)
+      {
+        string subType = getMemberType (t, member.substr (0, dot));
+        if (subType == "")
+          return "";
+        string memberType = getMemberType (subType, member.substr (dot + 1));
+        if (memberType != "" || member.substr (0, dot) == "operator->")
+          return memberType;
+        return getMemberType (subType, "operator->." + member.substr (dot + 1));
+      }
+
+    anatools::MemberWithDict dataMember = t.dataMemberByName (member);
+    anatools::FunctionWithDict functionMember = t.functionMemberByName (member);
+    if (dataMember)
+      return (dataMember.typeOf ().isReference () ? "" : dataMember.typeOf ().name ());
+    if (functionMember)
+      return (functionMember.finalReturnType ().isReference () ? "" : functionMember.finalReturnType ().name ());
+
+    anatools::TypeBases bases (t);
+    for (auto bi = bases.begin (); bi != bases.end (); ++bi)
+      {
+        anatools::BaseWithDict base (*bi);
+        string memberType = getMemberType (base.typeOf (), member);
+        if (memberType != "")
+          return memberType;
+      }
+
+    return "";
+  }
+
 #else
   #include "Reflex/Base.h"
   #include "Reflex/Member.h"
@@ -735,110 +817,112 @@ anatools::getRequiredCollections (const unordered_set<string> &objectsToGet, Col
 #if IS_VALID(beamspots)
   string  anatools::getObjectType  (const  osu::Beamspot         &obj)  {  return  "beamspot";         }
   string  anatools::getObjectClass  (const  osu::Beamspot         &obj)  {  return  "osu::Beamspot";         }
+  int     anatools::getObjectIndex  (const  osu::Beamspot         &obj, const Collections &handles, edm::ProductID &productId)  {  return  (handles.beamspots.isValid () && &obj == handles.beamspots.product ()) ? (productId = handles.beamspots.id (), 0) : -1;  }
 #endif
 #if IS_VALID(bxlumis)
   string  anatools::getObjectType  (const  osu::Bxlumi         &obj)  {  return  "bxlumi";         }
   string  anatools::getObjectClass  (const  osu::Bxlumi         &obj)  {  return  "osu::Bxlumi";         }
+  int     anatools::getObjectIndex  (const  osu::Bxlumi         &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.bxlumis, productId);  }
 #endif
 #if IS_VALID(cschits)
   string  anatools::getObjectType  (const  osu::Cschit         &obj)  {  return  "cschit";         }
   string  anatools::getObjectClass  (const  osu::Cschit         &obj)  {  return  "osu::Cschit";         }
+  int     anatools::getObjectIndex  (const  osu::Cschit         &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.cschits, productId);  }
 #endif
 #if IS_VALID(cscsegs)
   string  anatools::getObjectType  (const  osu::Cscseg         &obj)  {  return  "cscseg";         }
   string  anatools::getObjectClass  (const  osu::Cscseg         &obj)  {  return  "osu::Cscseg";         }
+  int     anatools::getObjectIndex  (const  osu::Cscseg         &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.cscsegs, productId);  }
 #endif
 #if IS_VALID(dtsegs)
   string  anatools::getObjectType  (const  osu::Dtseg         &obj)  {  return  "dtseg";         }
   string  anatools::getObjectClass  (const  osu::Dtseg         &obj)  {  return  "osu::Dtseg";         }
+  int     anatools::getObjectIndex  (const  osu::Dtseg         &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.dtsegs, productId);  }
 #endif
 #if IS_VALID(electrons)
   string  anatools::getObjectType  (const  osu::Electron       &obj)  {  return  "electron";       }
   string  anatools::getObjectClass  (const  osu::Electron       &obj)  {  return  "osu::Electron";       }
+  int     anatools::getObjectIndex  (const  osu::Electron       &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.electrons, productId);  }
 #endif
 #if IS_VALID(events)
   string  anatools::getObjectType  (const  osu::Event          &obj)  {  return  "event";          }
   string  anatools::getObjectClass  (const  osu::Event          &obj)  {  return  "osu::Event";          }
-  template<> int anatools::getObjectHash<osu::Event> (const osu::Event &object){
-    int run, lumi, evt;
-    run = abs(int(getMember (object, "run")));
-    lumi = abs(int(getMember (object, "lumi")));
-    evt = abs(int(getMember (object, "evt")));
-    return run + lumi + evt;
-  }
+  int     anatools::getObjectIndex  (const  osu::Event          &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.events, productId);  }
 #endif
 #if IS_VALID(genjets)
   string  anatools::getObjectType  (const  osu::Genjet         &obj)  {  return  "genjet";         }
   string  anatools::getObjectClass  (const  osu::Genjet         &obj)  {  return  "osu::Genjet";         }
+  int     anatools::getObjectIndex  (const  osu::Genjet         &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.genjets, productId);  }
 #endif
 #if IS_VALID(jets)
   string  anatools::getObjectType  (const  osu::Jet            &obj)  {  return  "jet";            }
   string  anatools::getObjectClass  (const  osu::Jet            &obj)  {  return  "osu::Jet";            }
+  int     anatools::getObjectIndex  (const  osu::Jet            &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.jets, productId);  }
 #endif
 #if IS_VALID(bjets)
   string  anatools::getObjectType  (const  osu::Bjet            &obj)  {  return  "bjet";            }
   string  anatools::getObjectClass  (const  osu::Bjet            &obj)  {  return  "osu::Bjet";            }
+  int     anatools::getObjectIndex  (const  osu::Bjet            &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.bjets, productId);  }
 #endif
 #if IS_VALID(basicjets) && DATA_FORMAT == AOD
   string  anatools::getObjectType   (const  osu::Basicjet            &obj)  {  return  "basicjet";            }
   string  anatools::getObjectClass  (const  osu::Basicjet            &obj)  {  return  "osu::Basicjet";            }
+  int     anatools::getObjectIndex  (const  osu::Basicjet            &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.basicjets, productId);  }
 #endif
 #if IS_VALID(mcparticles)
   string  anatools::getObjectType  (const  osu::Mcparticle     &obj)  {  return  "mcparticle";     }
   string  anatools::getObjectClass  (const  osu::Mcparticle     &obj)  {  return  "osu::Mcparticle";     }
+  int     anatools::getObjectIndex  (const  osu::Mcparticle     &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.mcparticles, productId);  }
 #endif
 #if IS_VALID(mets)
   string  anatools::getObjectType  (const  osu::Met            &obj)  {  return  "met";            }
   string  anatools::getObjectClass  (const  osu::Met            &obj)  {  return  "osu::Met";            }
-  template<> int anatools::getObjectHash<osu::Met> (const osu::Met& object){
-    int px_mev, py_mev;
-    px_mev = fabs(int(10000 * getMember (object, "px")));
-    py_mev = fabs(int(10000 * getMember (object, "py")));
-    return px_mev + py_mev;
-  }
+  int     anatools::getObjectIndex  (const  osu::Met            &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.mets, productId);  }
 #endif
 #if IS_VALID(muons)
   string  anatools::getObjectType  (const  osu::Muon           &obj)  {  return  "muon";           }
   string  anatools::getObjectClass  (const  osu::Muon           &obj)  {  return  "osu::Muon";           }
+  int     anatools::getObjectIndex  (const  osu::Muon           &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.muons, productId);  }
 #endif
 #if IS_VALID(photons)
   string  anatools::getObjectType  (const  osu::Photon         &obj)  {  return  "photon";         }
   string  anatools::getObjectClass  (const  osu::Photon         &obj)  {  return  "osu::Photon";         }
+  int     anatools::getObjectIndex  (const  osu::Photon         &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.photons, productId);  }
 #endif
 #if IS_VALID(primaryvertexs)
   string  anatools::getObjectType  (const  osu::Primaryvertex  &obj)  {  return  "primaryvertex";  }
   string  anatools::getObjectClass  (const  osu::Primaryvertex  &obj)  {  return  "osu::Primaryvertex";  }
-  template<> int anatools::getObjectHash<osu::Primaryvertex> (const osu::Primaryvertex& object){
-    int x_mum, y_mum, z_mum;
-    x_mum = abs(int(10000 * getMember (object, "x")));
-    y_mum = abs(int(10000 * getMember (object, "y")));
-    z_mum = abs(int(10000 * getMember (object, "z")));
-    return x_mum + y_mum + z_mum;
-  }
+  int     anatools::getObjectIndex  (const  osu::Primaryvertex  &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.primaryvertexs, productId);  }
 #endif
 #if IS_VALID(rpchits)
   string  anatools::getObjectType  (const  osu::Rpchit   &obj)  {  return  "rpchit";   }
   string  anatools::getObjectClass  (const  osu::Rpchit   &obj)  {  return  "osu::Rpchit";   }
+  int     anatools::getObjectIndex  (const  osu::Rpchit   &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.rpchits, productId);  }
 #endif
 #if IS_VALID(superclusters)
   string  anatools::getObjectType  (const  osu::Supercluster   &obj)  {  return  "supercluster";   }
   string  anatools::getObjectClass  (const  osu::Supercluster   &obj)  {  return  "osu::Supercluster";   }
+  int     anatools::getObjectIndex  (const  osu::Supercluster   &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.superclusters, productId);  }
 #endif
 #if IS_VALID(taus)
   string  anatools::getObjectType  (const  osu::Tau            &obj)  {  return  "tau";            }
   string  anatools::getObjectClass  (const  osu::Tau            &obj)  {  return  "osu::Tau";            }
+  int     anatools::getObjectIndex  (const  osu::Tau            &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.taus, productId);  }
 #endif
 #if IS_VALID(tracks)
   string  anatools::getObjectType  (const  osu::Track          &obj)  {  return  "track";          }
   string  anatools::getObjectClass  (const  osu::Track          &obj)  {  return  "osu::Track";          }
+  int     anatools::getObjectIndex  (const  osu::Track          &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.tracks, productId);  }
 #endif
 #if IS_VALID(secondaryTracks)
   string  anatools::getObjectType  (const  osu::SecondaryTrack          &obj)  {  return  "secondaryTrack";          }
   string  anatools::getObjectClass  (const  osu::SecondaryTrack          &obj)  {  return  "osu::SecondaryTrack";          }
+  int     anatools::getObjectIndex  (const  osu::SecondaryTrack          &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.secondaryTracks, productId);  }
 #endif
 #if IS_VALID(pileupinfos)
   string  anatools::getObjectType  (const  osu::PileUpInfo          &obj)  {  return  "pileupinfo";          }
   string  anatools::getObjectClass  (const  osu::PileUpInfo          &obj)  {  return  "osu::PileUpInfo";          }
+  int     anatools::getObjectIndex  (const  osu::PileUpInfo          &obj, const Collections &handles, edm::ProductID &productId)  {  return  getObjectIndex (obj, handles.pileupinfos, productId);  }
 #endif
 
 // user-defined cases
@@ -914,6 +998,11 @@ anatools::getAllTokens (const edm::ParameterSet &collections, edm::ConsumesColle
     tokens.triggers = cc.consumes<TYPE(triggers)> (collections.getParameter<edm::InputTag> ("triggers"));
   if (collections.exists ("trigobjs"))
     tokens.trigobjs = cc.consumes<vector<TYPE(trigobjs)> > (collections.getParameter<edm::InputTag> ("trigobjs"));
+#if IS_VALID(trigobjs)
+  // Only present if the trigger objects were produced by OSUTrigobjProducer.
+  if (collections.exists ("trigobjs"))
+    tokens.trigobjFilterIndex = cc.consumes<osu::TrigobjFilterIndex> (collections.getParameter<edm::InputTag> ("trigobjs"));
+#endif
   if (collections.exists ("metFilters"))
     tokens.metFilters = cc.consumes<TYPE(triggers)> (collections.getParameter<edm::InputTag> ("metFilters"));
 
@@ -926,7 +1015,11 @@ anatools::getAllTokens (const edm::ParameterSet &collections, edm::ConsumesColle
   if (collections.exists ("eventvariables"))
     {
       tokens.eventvariables.clear ();
+      tokens.eventvariableRecords.clear ();
       for (const auto &collection : collections.getParameter<vector<edm::InputTag> > ("eventvariables"))
-        tokens.eventvariables.push_back (cc.consumes<osu::Eventvariable> (collection));
+        {
+          tokens.eventvariables.push_back (cc.consumes<osu::Eventvariable> (collection));
+          tokens.eventvariableRecords.push_back (cc.consumes<EventVariableRecord> (collection));
+        }
     }
 }
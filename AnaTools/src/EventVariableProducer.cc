@@ -1,9 +1,14 @@
+#include <algorithm>
+
 #include "OSUT3Analysis/AnaTools/interface/EventVariableProducer.h"
 
+#define EXIT_CODE 3
+
 EventVariableProducer::EventVariableProducer(const edm::ParameterSet &cfg) :
   collections_  (cfg.getParameter<edm::ParameterSet>  ("collections"))
 {
   produces<EventVariableProducerPayload> ("eventvariables");
+  produces<EventVariableRecord> ("eventvariables");
 }
 
 EventVariableProducer::~EventVariableProducer()
@@ -20,6 +25,7 @@ EventVariableProducer::produce (edm::Event &event, const edm::EventSetup &setup)
   // the vector will have size=1 for each event
 
   eventvariables = unique_ptr<EventVariableProducerPayload> (new EventVariableProducerPayload);
+  record_.isSet.assign (declarations_.size (), false);
 
   ////////////////////////////////////////////////////////////////////////
   AddVariables(event);
@@ -27,4 +33,96 @@ EventVariableProducer::produce (edm::Event &event, const edm::EventSetup &setup)
   // store all of our calculated quantities in the event
   event.put (std::move (eventvariables), "eventvariables");
   eventvariables.reset ();
+  event.put (unique_ptr<EventVariableRecord> (new EventVariableRecord (record_)), "eventvariables");
+}
+
+unsigned
+EventVariableProducer::declareEventVar (const string &name, const EventVarType type, const unsigned size)
+{
+  for (const auto &declaration : declarations_)
+    {
+      if (declaration.name == name)
+        {
+          clog << "ERROR: event variable \"" << name << "\" is declared more than once" << endl;
+          exit (EXIT_CODE);
+        }
+    }
+  if (name.empty () || name.find_first_of (" :") != string::npos)
+    {
+      clog << "ERROR: event variable \"" << name << "\" is not a valid name" << endl;
+      exit (EXIT_CODE);
+    }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Reserve space in the record of the given type and describe the variable in
+  // the layout of the record.
+  //////////////////////////////////////////////////////////////////////////////
+  EventVarDeclaration declaration = {name, type, max (size, 1u), 0};
+  char typeCode;
+  if (type == EVENT_VAR_INT)
+    {
+      declaration.offset = record_.intValues.size ();
+      record_.intValues.resize (record_.intValues.size () + declaration.size);
+      typeCode = 'i';
+    }
+  else if (type == EVENT_VAR_BOOL)
+    {
+      declaration.offset = record_.boolValues.size ();
+      record_.boolValues.resize (record_.boolValues.size () + declaration.size);
+      typeCode = 'b';
+    }
+  else
+    {
+      declaration.offset = record_.doubleValues.size ();
+      record_.doubleValues.resize (record_.doubleValues.size () + declaration.size);
+      typeCode = 'd';
+    }
+  declarations_.push_back (declaration);
+
+  if (!record_.layout.empty ())
+    record_.layout += " ";
+  record_.layout += name + ":" + typeCode + ":" + to_string (declaration.size);
+  //////////////////////////////////////////////////////////////////////////////
+
+  return declarations_.size () - 1;
 }
+
+void
+EventVariableProducer::setEventVar (const unsigned slot, const double value, const unsigned index)
+{
+  const EventVarDeclaration &declaration = declarations_.at (slot);
+  if (index >= declaration.size)
+    {
+      clog << "WARNING: index " << index << " is out of range for event variable \"" << declaration.name << "\"" << endl;
+      return;
+    }
+
+  if (declaration.type == EVENT_VAR_INT)
+    record_.intValues[declaration.offset + index] = value;
+  else if (declaration.type == EVENT_VAR_BOOL)
+    record_.boolValues[declaration.offset + index] = value;
+  else
+    record_.doubleValues[declaration.offset + index] = value;
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The elements of a vector which are not set in this event are invalid.
+  //////////////////////////////////////////////////////////////////////////////
+  if (!record_.isSet[slot] && declaration.size > 1)
+    {
+      for (unsigned i = 0; i < declaration.size; i++)
+        {
+          if (i == index)
+            continue;
+          if (declaration.type == EVENT_VAR_INT)
+            record_.intValues[declaration.offset + i] = INVALID_VALUE;
+          else if (declaration.type == EVENT_VAR_BOOL)
+            record_.boolValues[declaration.offset + i] = false;
+          else
+            record_.doubleValues[declaration.offset + i] = INVALID_VALUE;
+        }
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  record_.isSet[slot] = true;
+}
+
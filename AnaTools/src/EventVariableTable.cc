@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include "OSUT3Analysis/AnaTools/interface/DataFormat.h"
+#include "OSUT3Analysis/AnaTools/interface/EventVariableTable.h"
+
+namespace
+{
+  mutex slotsMutex;
+}
+
+unordered_map<string, unsigned> &
+EventVariableTable::slots ()
+{
+  static unordered_map<string, unsigned> slots;
+  return slots;
+}
+
+unsigned
+EventVariableTable::getSlot (const string &name)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Returns the slot of the given variable, appending a new one if the name has
+  // not been seen before. Modules may be constructed concurrently, so the
+  // registry is locked.
+  //////////////////////////////////////////////////////////////////////////////
+  lock_guard<mutex> lock (slotsMutex);
+  auto slot = slots ().find (name);
+  if (slot != slots ().end ())
+    return slot->second;
+  unsigned newSlot = slots ().size ();
+  slots ()[name] = newSlot;
+  return newSlot;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+int
+EventVariableTable::findSlot (const string &name)
+{
+  lock_guard<mutex> lock (slotsMutex);
+  auto slot = slots ().find (name);
+  return (slot != slots ().end () ? slot->second : -1);
+}
+
+void
+EventVariableTable::fill (const vector<edm::Handle<osu::Eventvariable> > &handles, const vector<edm::Handle<EventVariableRecord> > &recordHandles)
+{
+  handles_ = handles;
+  recordHandles_ = recordHandles;
+  layouts_.resize (recordHandles_.size ());
+  values_.clear ();
+  fillSlots ();
+}
+
+double
+EventVariableTable::get (const unsigned &slot) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Slots may be registered after the table was filled, e.g., by trees which
+  // are built in the first event, so their values are looked up on demand.
+  //////////////////////////////////////////////////////////////////////////////
+  if (slot >= values_.size ())
+    fillSlots ();
+  return (slot < values_.size () ? values_[slot] : INVALID_VALUE);
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+double
+EventVariableTable::get (const string &name) const
+{
+  int slot = findSlot (name);
+  return (slot >= 0 ? get (slot) : INVALID_VALUE);
+}
+
+void
+EventVariableTable::fillSlots () const
+{
+  lock_guard<mutex> lock (slotsMutex);
+  unsigned firstSlot = values_.size ();
+  if (firstSlot == slots ().size ())
+    return;
+  values_.resize (slots ().size (), INVALID_VALUE);
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Fills the slots from firstSlot on. The producers are visited in reverse
+  // order so that the first one giving a variable overwrites any others, as
+  // when the maps were merged with insert, and the map of each producer is
+  // read after its record, so that a variable written directly into the map
+  // wins, as it did when the record was copied into the map. Variables which
+  // no ValueLookupTree refers to are skipped.
+  //////////////////////////////////////////////////////////////////////////////
+  for (int i = (int) max (handles_.size (), recordHandles_.size ()) - 1; i >= 0; i--)
+    {
+      if (i < (int) recordHandles_.size () && recordHandles_.at (i).isValid ())
+        {
+          const EventVariableRecord &record = *recordHandles_.at (i);
+          RecordLayout &layout = layouts_.at (i);
+          if (layout.nSlots != slots ().size () || layout.layout != record.layout)
+            resolveLayout (record.layout, layout);
+          for (const auto &entry : layout.entries)
+            {
+              if (entry.slot < firstSlot || !record.isSet.at (entry.declaration))
+                continue;
+              if (entry.type == 'i')
+                values_[entry.slot] = record.intValues.at (entry.offset);
+              else if (entry.type == 'b')
+                values_[entry.slot] = record.boolValues.at (entry.offset);
+              else
+                values_[entry.slot] = record.doubleValues.at (entry.offset);
+            }
+        }
+#if IS_VALID(eventvariables)
+      if (i < (int) handles_.size () && handles_.at (i).isValid ())
+        {
+          for (const auto &variable : *handles_.at (i))
+            {
+              auto slot = slots ().find (variable.first);
+              if (slot != slots ().end () && slot->second >= firstSlot)
+                values_[slot->second] = variable.second;
+            }
+        }
+#endif
+    }
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+void
+EventVariableTable::resolveLayout (const string &layoutString, RecordLayout &layout) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Parses the name:type:size fields of the layout and finds the slot of each
+  // element, named name_0, name_1, etc. for vectors. The registry is already
+  // locked by fillSlots.
+  //////////////////////////////////////////////////////////////////////////////
+  layout.layout = layoutString;
+  layout.nSlots = slots ().size ();
+  layout.entries.clear ();
+
+  map<char, unsigned> offsets;
+  unsigned declaration = 0;
+  stringstream ss (layoutString);
+  string field;
+  while (ss >> field)
+    {
+      size_t typeColon = field.rfind (':', field.rfind (':') - 1),
+             sizeColon = field.rfind (':');
+      string name = field.substr (0, typeColon);
+      char type = field.at (typeColon + 1);
+      unsigned size = stoul (field.substr (sizeColon + 1));
+
+      for (unsigned index = 0; index < size; index++)
+        {
+          auto slot = slots ().find (size == 1 ? name : name + "_" + to_string (index));
+          if (slot != slots ().end ())
+            layout.entries.push_back ({slot->second, type, offsets[type] + index, declaration});
+        }
+      offsets[type] += size;
+      declaration++;
+    }
+  //////////////////////////////////////////////////////////////////////////////
+}
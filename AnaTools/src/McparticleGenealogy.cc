@@ -0,0 +1,124 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "OSUT3Analysis/AnaTools/interface/McparticleGenealogy.h"
+
+namespace
+{
+  enum GenealogyState
+    {
+      GENEALOGY_UNVISITED,
+      GENEALOGY_VISITING,
+      GENEALOGY_DONE
+    };
+}
+
+McparticleGenealogy::McparticleGenealogy (const vector<int> &pdgIds)
+{
+  for (unsigned i = 0; i < pdgIds.size (); i++)
+    {
+      int pdgId = abs (pdgIds.at (i));
+      if (!pdgIds_.count (pdgId))
+        {
+          pdgIds_[pdgId] = pdgIdIndices_.size ();
+          pdgIdIndices_.push_back (vector<unsigned> ());
+        }
+      pdgIdIndices_.at (pdgIds_.at (pdgId)).push_back (i);
+    }
+
+  // Each PDG ID needs one bit for each sign.
+  if (2 * pdgIdIndices_.size () > 64)
+    {
+      clog << "ERROR: at most 32 different PDG IDs can be given to McparticleGenealogy. Quitting..." << endl;
+      exit (1);
+    }
+}
+
+void
+McparticleGenealogy::update (const vector<TYPE(hardInteractionMcparticles)> &mcparticles)
+{
+  ancestorMasks_.assign (mcparticles.size (), 0);
+  originalPdgIdIndices_.assign (mcparticles.size (), -1);
+  states_.assign (mcparticles.size (), GENEALOGY_UNVISITED);
+#if DATA_FORMAT == MINI_AOD_CUSTOM || DATA_FORMAT == MINI_AOD || DATA_FORMAT == AOD
+  if (mcparticles.empty () || pdgIds_.empty ())
+    return;
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Mothers are usually, but not necessarily, stored before their daughters,
+  // so the chain of first mothers of each particle is followed until a particle
+  // whose mask is already known, and the masks are then filled in on the way
+  // back down. Mothers outside of the collection are handled by walking their
+  // chains directly.
+  //////////////////////////////////////////////////////////////////////////////
+  const TYPE(hardInteractionMcparticles) * const first = &mcparticles.front (),
+                                         * const last = first + mcparticles.size ();
+  for (unsigned i = 0; i < mcparticles.size (); i++)
+    {
+      if (states_.at (i) == GENEALOGY_DONE)
+        continue;
+
+      uint64_t mask = 0;
+      chain_.clear ();
+      for (unsigned j = i; ; )
+        {
+          chain_.push_back (j);
+          states_.at (j) = GENEALOGY_VISITING;
+
+          const TYPE(hardInteractionMcparticles) &mcparticle = mcparticles.at (j);
+          if (!mcparticle.numberOfMothers () || mcparticle.motherRef ().isNull ())
+            break;
+          const TYPE(hardInteractionMcparticles) * const mother = &*mcparticle.motherRef ();
+          if (mother < first || mother >= last)
+            {
+              mask = getBit (mother->pdgId ()) | getAncestorMask (*mother);
+              break;
+            }
+          unsigned k = mother - first;
+          if (states_.at (k) == GENEALOGY_DONE)
+            {
+              mask = getBit (mother->pdgId ()) | ancestorMasks_.at (k);
+              break;
+            }
+          if (states_.at (k) == GENEALOGY_VISITING)
+            break;
+          j = k;
+        }
+
+      for (auto j = chain_.rbegin (); j != chain_.rend (); j++)
+        {
+          if (j != chain_.rbegin ())
+            mask = getBit (mcparticles.at (*(j - 1)).pdgId ()) | ancestorMasks_.at (*(j - 1));
+          ancestorMasks_.at (*j) = mask;
+          states_.at (*j) = GENEALOGY_DONE;
+        }
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  for (unsigned i = 0; i < mcparticles.size (); i++)
+    {
+      int pdgId = mcparticles.at (i).pdgId ();
+      auto index = pdgIds_.find (abs (pdgId));
+      if (index != pdgIds_.end () && !(ancestorMasks_.at (i) & getBit (pdgId)))
+        originalPdgIdIndices_.at (i) = index->second;
+    }
+#endif
+}
+
+uint64_t
+McparticleGenealogy::getBit (const int pdgId) const
+{
+  auto index = pdgIds_.find (abs (pdgId));
+  if (index == pdgIds_.end ())
+    return 0;
+  return (uint64_t) 1 << (2 * index->second + (pdgId < 0));
+}
+
+uint64_t
+McparticleGenealogy::getAncestorMask (const reco::Candidate &mcparticle) const
+{
+  uint64_t mask = 0;
+  for (const reco::Candidate *mother = mcparticle.mother (0); mother; mother = mother->mother (0))
+    mask |= getBit (mother->pdgId ());
+  return mask;
+}
@@ -0,0 +1,62 @@
+#include <mutex>
+
+#include "OSUT3Analysis/AnaTools/interface/MemberValueCache.h"
+
+#define MAX_INDEX 0xFFFFFF
+
+namespace
+{
+  mutex memberIdsMutex;
+}
+
+unordered_map<string, unsigned> &
+MemberValueCache::memberIds ()
+{
+  static unordered_map<string, unsigned> memberIds;
+  return memberIds;
+}
+
+unsigned
+MemberValueCache::getMemberId (const string &name)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Returns the identifier of the given member, appending a new one if the
+  // name has not been seen before. Modules may be constructed concurrently, so
+  // the registry is locked.
+  //////////////////////////////////////////////////////////////////////////////
+  lock_guard<mutex> lock (memberIdsMutex);
+  auto memberId = memberIds ().find (name);
+  if (memberId != memberIds ().end ())
+    return memberId->second;
+  unsigned newMemberId = memberIds ().size ();
+  memberIds ()[name] = newMemberId;
+  return newMemberId;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+bool
+MemberValueCache::find (const CollectionId collection, const unsigned index, const unsigned member, double &value) const
+{
+  if (index > MAX_INDEX)
+    return false;
+  auto cachedValue = values_.find (key (collection, index, member));
+  if (cachedValue == values_.end ())
+    return false;
+  value = cachedValue->second;
+  return true;
+}
+
+void
+MemberValueCache::insert (const CollectionId collection, const unsigned index, const unsigned member, const double value)
+{
+  if (index <= MAX_INDEX)
+    values_[key (collection, index, member)] = value;
+}
+
+uint64_t
+MemberValueCache::key (const CollectionId collection, const unsigned index, const unsigned member)
+{
+  // The collection takes the lowest 8 bits, the object index the next 24, and
+  // the member the highest 32. Objects with larger indices are not cached.
+  return (((uint64_t) member << 32) | ((uint64_t) index << 8) | (uint64_t) collection);
+}
@@ -0,0 +1,44 @@
+#include "OSUT3Analysis/AnaTools/interface/ModuleTimer.h"
+
+unsigned
+ModuleTimer::addSection (const string &name)
+{
+  for (unsigned section = 0; section < names_.size (); section++)
+    {
+      if (names_.at (section) == name)
+        return section;
+    }
+
+  names_.push_back (name);
+  seconds_.push_back (0.0);
+  calls_.push_back (0.0);
+  return names_.size () - 1;
+}
+
+void
+ModuleTimer::write (TFileDirectory &directory) const
+{
+  if (!enabled_ || names_.empty ())
+    return;
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The bin contents are set directly, with no errors, so that adding the
+  // histograms from several jobs gives the total time and number of calls.
+  //////////////////////////////////////////////////////////////////////////////
+  TFileDirectory timingDirectory = directory.mkdir ("Timing");
+  TH1D *wallTime = timingDirectory.make<TH1D> ("wallTime", ";;wall time [s]", names_.size (), 0.0, names_.size ()),
+       *calls = timingDirectory.make<TH1D> ("calls", ";;number of calls", names_.size (), 0.0, names_.size ());
+  for (unsigned section = 0; section < names_.size (); section++)
+    {
+      wallTime->GetXaxis ()->SetBinLabel (section + 1, names_.at (section).c_str ());
+      wallTime->SetBinContent (section + 1, seconds_.at (section));
+      wallTime->SetBinError (section + 1, 0.0);
+
+      calls->GetXaxis ()->SetBinLabel (section + 1, names_.at (section).c_str ());
+      calls->SetBinContent (section + 1, calls_.at (section));
+      calls->SetBinError (section + 1, 0.0);
+    }
+  wallTime->SetEntries (names_.size ());
+  calls->SetEntries (names_.size ());
+  //////////////////////////////////////////////////////////////////////////////
+}
@@ -1,42 +1,153 @@
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
 #include "OSUT3Analysis/AnaTools/interface/PUWeight.h"
 
-PUWeight::PUWeight (const string &puFile, const string &dataPU, const string &mcPU)
+namespace
 {
-  TFile *fin = TFile::Open (puFile.c_str ());
-  if (!fin || fin->IsZombie()) {
-    clog << "ERROR [PUWeight]: Could not find file: " << puFile
-         << "; will cause a seg fault." << endl;
-    exit(1);
-  }
+  // Contents of a pileup distribution, including the underflow and overflow
+  // bins, and the edges of its bins.
+  struct Distribution
+  {
+    vector<double> contents;
+    vector<double> edges;
+  };
 
-  TH1D *mc;
-  fin->GetObject(mcPU.c_str(), mc);
-  fin->GetObject(dataPU.c_str(), puWeight_);
-  if (!mc) {
-    clog << "ERROR [PUWeight]: Could not find histogram: " << mcPU
-         << "; will cause a seg fault." << endl;
-    exit(1);
+  bool
+  isTable (const string &puFile)
+  {
+    return (puFile.size () >= 4 && puFile.substr (puFile.size () - 4) == ".txt");
   }
-  if (!puWeight_) {
-    clog << "ERROR [PUWeight]: Could not find histogram: " << dataPU
-         << "; will cause a seg fault." << endl;
-    exit(1);
+
+  bool
+  getDistribution (TFile * const fin, const string &name, Distribution &distribution)
+  {
+    TH1D *h;
+    fin->GetObject (name.c_str (), h);
+    if (!h)
+      return false;
+    for (int bin = 0; bin <= h->GetNbinsX () + 1; bin++)
+      distribution.contents.push_back (h->GetBinContent (bin));
+    for (int bin = 1; bin <= h->GetNbinsX () + 1; bin++)
+      distribution.edges.push_back (h->GetBinLowEdge (bin));
+    delete h;
+    return true;
   }
 
-  mc->SetDirectory (0);
-  puWeight_->SetDirectory (0);
-  mc->Scale (puWeight_->Integral () / mc->Integral ());
-  TH1D *trimmedMC = new TH1D ("bla", "bla", puWeight_->GetNbinsX(), 0, puWeight_->GetNbinsX());
-  for (int bin = 1; bin <= puWeight_->GetNbinsX(); bin++)
-    trimmedMC->SetBinContent (bin, mc->GetBinContent (bin));
-  puWeight_->Divide (trimmedMC);
-  fin->Close ();
-  delete fin;
-  delete mc;
-  delete trimmedMC;
+  bool
+  getDistribution (ifstream &fin, const string &name, Distribution &distribution)
+  {
+    //////////////////////////////////////////////////////////////////////////////
+    // Each line of the table has the form
+    //   name nBins xMin xMax underflow content_1 ... content_nBins overflow
+    // as written by write_pu_table in processingUtilities.py.
+    //////////////////////////////////////////////////////////////////////////////
+    string line;
+    fin.clear ();
+    fin.seekg (0);
+    while (getline (fin, line))
+      {
+        stringstream ss (line);
+        string lineName;
+        unsigned nBins;
+        double xMin, xMax, content;
+        if (!(ss >> lineName) || lineName != name || !(ss >> nBins >> xMin >> xMax) || !nBins)
+          continue;
+        while (ss >> content)
+          distribution.contents.push_back (content);
+        if (distribution.contents.size () != nBins + 2)
+          return false;
+        for (unsigned bin = 0; bin <= nBins; bin++)
+          distribution.edges.push_back (xMin + bin * (xMax - xMin) / nBins);
+        return true;
+      }
+    return false;
+    //////////////////////////////////////////////////////////////////////////////
+  }
 }
 
-PUWeight::~PUWeight ()
+PUWeight::PUWeight (const string &puFile, const string &dataPU, const string &mcPU, const bool normalize)
 {
-  delete puWeight_;
+  Distribution data, mc;
+  if (isTable (puFile))
+    {
+      ifstream fin (puFile);
+      if (!fin.is_open ()) {
+        clog << "ERROR [PUWeight]: Could not find file: " << puFile
+             << "; will cause a seg fault." << endl;
+        exit(1);
+      }
+      if (!getDistribution (fin, mcPU, mc)) {
+        clog << "ERROR [PUWeight]: Could not find distribution: " << mcPU
+             << "; will cause a seg fault." << endl;
+        exit(1);
+      }
+      if (!getDistribution (fin, dataPU, data)) {
+        clog << "ERROR [PUWeight]: Could not find distribution: " << dataPU
+             << "; will cause a seg fault." << endl;
+        exit(1);
+      }
+    }
+  else
+    {
+      TFile *fin = TFile::Open (puFile.c_str ());
+      if (!fin || fin->IsZombie()) {
+        clog << "ERROR [PUWeight]: Could not find file: " << puFile
+             << "; will cause a seg fault." << endl;
+        exit(1);
+      }
+      if (!getDistribution (fin, mcPU, mc)) {
+        clog << "ERROR [PUWeight]: Could not find histogram: " << mcPU
+             << "; will cause a seg fault." << endl;
+        exit(1);
+      }
+      if (!getDistribution (fin, dataPU, data)) {
+        clog << "ERROR [PUWeight]: Could not find histogram: " << dataPU
+             << "; will cause a seg fault." << endl;
+        exit(1);
+      }
+      fin->Close ();
+      delete fin;
+    }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Same as dividing the data histogram by the MC histogram trimmed to the
+  // same number of bins, after optionally scaling the MC to the integral of the
+  // data. Bins with no MC, and the underflow and overflow bins, get a weight of
+  // 0, as with TH1::Divide.
+  //////////////////////////////////////////////////////////////////////////////
+  nBins_ = data.contents.size () - 2;
+  double dataIntegral = 0.0, mcIntegral = 0.0, scale = 1.0;
+  for (unsigned bin = 1; bin <= nBins_; bin++)
+    dataIntegral += data.contents.at (bin);
+  for (unsigned bin = 1; bin + 1 < mc.contents.size (); bin++)
+    mcIntegral += mc.contents.at (bin);
+  if (normalize)
+    scale = dataIntegral / mcIntegral;
+
+  weights_.assign (nBins_ + 2, 0.0);
+  for (unsigned bin = 1; bin <= nBins_; bin++)
+    {
+      double mcContent = (bin < mc.contents.size () ? mc.contents.at (bin) * scale : 0.0);
+      if (mcContent)
+        weights_.at (bin) = data.contents.at (bin) / mcContent;
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The edges are only kept if the bins are not all the same width.
+  //////////////////////////////////////////////////////////////////////////////
+  xMin_ = data.edges.front ();
+  xMax_ = data.edges.back ();
+  double binWidth = (xMax_ - xMin_) / nBins_;
+  for (unsigned bin = 0; bin <= nBins_; bin++)
+    {
+      if (fabs (data.edges.at (bin) - (xMin_ + bin * binWidth)) > 1.0e-6 * binWidth)
+        {
+          edges_ = data.edges;
+          break;
+        }
+    }
+  //////////////////////////////////////////////////////////////////////////////
 }
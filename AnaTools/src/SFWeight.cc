@@ -1,24 +1,46 @@
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+
 #include "OSUT3Analysis/AnaTools/interface/SFWeight.h"
 
+namespace
+{
+  // Copy the given histogram into a BinnedTable, so that the file can be
+  // closed right away.
+  BinnedTable
+  getTable (const string &sfFile, const string &dataOverMC, const string &caller, const bool clamp = false)
+  {
+    TFile *fin = TFile::Open (sfFile.c_str ());
+    TH1 *dataOverMCHist = fin ? (TH1 *) fin->Get (dataOverMC.c_str ()) : NULL;
+    if (!dataOverMCHist)
+      {
+        cout << "Fatal Error [" << caller << "]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
+        exit (1);
+      }
+    BinnedTable table (*dataOverMCHist, clamp);
+    delete dataOverMCHist;
+    fin->Close ();
+    delete fin;
+    return table;
+  }
+}
+
+
+TrackSFWeight::TrackSFWeight ()
+{
+  // For displaced stuff all the different d_0 are almost equivalent. The
+  // prompt region is used by the whole collaboration and very well know and no
+  // correction from tracking SF are currently applied so we set the error to
+  // be 0.
+  trackSFWeight_ = BinnedTable ({{0.0, 0.02}},
+                                {0.960, 1.0, 0.960},
+                                {0.012, 0.0, 0.012},
+                                {0.012, 0.0, 0.012});
+}
 
 double
 TrackSFWeight::at(const double &correctedD0, const int &shiftUpDown)
 {
-
-  double scaleFactor = 0;
-  double error =0;
-  double crit_value= 0.02; // For displaced stuff all the different d_0 are almost  equivalent
-  if (abs(correctedD0) < crit_value )
-    {
-      scaleFactor = 1;
-      error = 0.0; // The prompt region is used by the whole collaboration and very well know and no correction from tracking SF are currently applied so we set the error to be 0
-    }
-  else
-    {
-      scaleFactor = 0.960;
-      error = 0.012;
-    }
-  return scaleFactor + shiftUpDown * error;
+  return trackSFWeight_.at (abs(correctedD0), shiftUpDown);
 }
 
 TrackSFWeight::~TrackSFWeight ()
@@ -30,9 +52,22 @@ TrackSFWeight::~TrackSFWeight ()
 MuonSFWeight::MuonSFWeight (const string &sfFile, const string &dataOverMC)
 {
   TFile *fin = TFile::Open (sfFile.c_str ());
-  TH2F* SF_Combined_TOT = (TH2F *) fin->Get(dataOverMC.c_str ());
-  muonSFWeight_ = (TH2F*)SF_Combined_TOT->Clone();
-  muonSFWeight_->GetEntries();// to avoid the crashing warning
+  TH2 *SF_Combined_TOT = fin ? (TH2 *) fin->Get(dataOverMC.c_str ()) : NULL;
+  if (!SF_Combined_TOT)
+    {
+      cout << "Fatal Error [MuonSFWeight::MuonSFWeight]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
+      exit (1);
+    }
+  muonSFWeight_ = BinnedTable (*SF_Combined_TOT);
+
+  // to give a non null SF for muons being out of eta and/or pt range of the input histo
+  const TAxis * const xAxis = SF_Combined_TOT->GetXaxis (),
+              * const yAxis = SF_Combined_TOT->GetYaxis ();
+  etaMax_ = xAxis->GetBinUpEdge (xAxis->GetLast ());
+  etaHigh_ = (xAxis->GetBinUpEdge (xAxis->GetLast ()) + xAxis->GetBinUpEdge (xAxis->GetNbins () - 1)) / 2;
+  ptHigh_ = (yAxis->GetBinUpEdge (yAxis->GetNbins () - 1) + yAxis->GetBinUpEdge (yAxis->GetNbins () - 2)) / 2;
+  ptHighBarrel_ = (yAxis->GetBinUpEdge (yAxis->GetNbins ()) + yAxis->GetBinUpEdge (yAxis->GetNbins () - 1)) / 2;
+
   delete SF_Combined_TOT;
   fin->Close ();
   delete fin;
@@ -45,30 +80,25 @@ MuonSFWeight::at(const double &eta, const double &pt, const int &shiftUpDown)
   double pt_hist= pt;
   double eta_hist= eta;
   // to give a non null SF for muons being out of eta and/or pt range of the input histo
-  if (pt > 300 && abs(eta) < muonSFWeight_->GetXaxis()->GetBinUpEdge(muonSFWeight_->GetXaxis()->GetLast()) )
+  if (pt > 300 && abs(eta) < etaMax_)
     {
-      pt_hist =( muonSFWeight_->GetYaxis()->GetBinUpEdge(muonSFWeight_->GetYaxis()->GetNbins() - 1) + muonSFWeight_->GetYaxis()->GetBinUpEdge(muonSFWeight_->GetYaxis()->GetNbins() - 2))/2;
+      pt_hist = ptHigh_;
       if (pt > 300 && abs(eta) < 0.9)
-        {
-          pt_hist =( muonSFWeight_->GetYaxis()->GetBinUpEdge(muonSFWeight_->GetYaxis()->GetNbins()) + muonSFWeight_->GetYaxis()->GetBinUpEdge(muonSFWeight_->GetYaxis()->GetNbins() - 1))/2;
-        }
-    }
-  else if (pt < 300 && abs(eta) > muonSFWeight_->GetXaxis()->GetBinUpEdge(muonSFWeight_->GetXaxis()->GetLast()))
-    {
-      eta_hist =(muonSFWeight_->GetXaxis()->GetBinUpEdge(muonSFWeight_->GetXaxis()->GetLast()) + muonSFWeight_->GetXaxis()->GetBinUpEdge(muonSFWeight_->GetXaxis()->GetNbins() - 1))/2;
+        pt_hist = ptHighBarrel_;
     }
-  else if (pt > 300 && abs(eta) > muonSFWeight_->GetXaxis()->GetBinUpEdge(muonSFWeight_->GetXaxis()->GetLast()))
+  else if (pt < 300 && abs(eta) > etaMax_)
+    eta_hist = etaHigh_;
+  else if (pt > 300 && abs(eta) > etaMax_)
     {
-      pt_hist =( muonSFWeight_->GetYaxis()->GetBinUpEdge(muonSFWeight_->GetYaxis()->GetNbins() - 1) + muonSFWeight_->GetYaxis()->GetBinUpEdge(muonSFWeight_->GetYaxis()->GetNbins() - 2))/2;
-      eta_hist =(muonSFWeight_->GetXaxis()->GetBinUpEdge(muonSFWeight_->GetXaxis()->GetLast()) + muonSFWeight_->GetXaxis()->GetBinUpEdge(muonSFWeight_->GetXaxis()->GetNbins() - 1))/2;
+      pt_hist = ptHigh_;
+      eta_hist = etaHigh_;
     }
 
-  return muonSFWeight_->GetBinContent(muonSFWeight_->FindBin(abs(eta_hist),pt_hist)) + shiftUpDown * muonSFWeight_->GetBinError(muonSFWeight_->FindBin(abs(eta_hist),pt_hist));
+  return muonSFWeight_.at (abs(eta_hist), pt_hist, shiftUpDown);
 }
 
 MuonSFWeight::~MuonSFWeight ()
 {
-  delete muonSFWeight_;
 }
 
 
@@ -76,512 +106,200 @@ MuonSFWeight::~MuonSFWeight ()
 ElectronSFWeight::ElectronSFWeight (const string &cmsswRelease, const string &id, const string &sfFile, const string &dataOverMC) :
   cmsswRelease_ (cmsswRelease),
   id_ (id),
-  electronSFWeight_ (NULL)
+  fromHistogram_ (false),
+  swapAxes_ (false)
 {
   ifstream finStream (sfFile);
-  if (!finStream)
-    return;
-  finStream.close ();
-  TFile *fin = TFile::Open (sfFile.c_str ());
-  electronSFWeight_ = (TH2F *) fin->Get (dataOverMC.c_str ());
-  electronSFWeight_->SetDirectory (0);
-  fin->Close ();
-  delete fin;
-}
-
-double
-ElectronSFWeight::at (const double &eta, const double &pt, const int &shiftUpDown)
-{
-  double scaleFactor = 1.0, minus = 0.0, plus = 0.0;
-
-  if (electronSFWeight_)
-    {
-      double x = eta, y = pt;
-      if (strcasestr (electronSFWeight_->GetYaxis ()->GetTitle (), "eta"))
-        {
-          x = pt;
-          y = eta;
-        }
-      int xBin = electronSFWeight_->GetXaxis ()->FindBin (x),
-          yBin = electronSFWeight_->GetYaxis ()->FindBin (y);
-      xBin = min (xBin, electronSFWeight_->GetXaxis ()->GetNbins ());
-      xBin = max (xBin, 1);
-      yBin = min (yBin, electronSFWeight_->GetYaxis ()->GetNbins ());
-      yBin = max (yBin, 1);
-
-      scaleFactor = electronSFWeight_->GetBinContent (xBin, yBin);
-      minus = plus = electronSFWeight_->GetBinError (xBin, yBin);
-    }
-  else if (cmsswRelease_ == "53X")
+  if (finStream)
     {
-      if (id_ == "loose")
+      finStream.close ();
+      TFile *fin = TFile::Open (sfFile.c_str ());
+      TH2 *dataOverMCHist = fin ? (TH2 *) fin->Get (dataOverMC.c_str ()) : NULL;
+      if (!dataOverMCHist)
         {
-          if (fabs (eta) < 0.8)
-            {
-              if (pt < 15.0 && pt >= 10.0)
-                scaleFactor = 0.855;
-              if (pt < 20.0 && pt >= 15.0)
-                scaleFactor = 0.962;
-              if (pt < 30.0 && pt >= 20.0)
-                scaleFactor = 1.005;
-              if (pt < 40.0 && pt >= 30.0)
-                scaleFactor = 1.004;
-              if (pt < 50.0 && pt >= 40.0)
-                scaleFactor = 1.008;
-              if (pt >= 50.0)
-                scaleFactor = 1.008;
-            }
-          if (fabs (eta) < 1.442 && fabs (eta) >= 0.8)
-            {
-              if (pt < 15.0 && pt >= 10.0)
-                scaleFactor = 0.858;
-              if (pt < 20.0 && pt >= 15.0)
-                scaleFactor = 0.962;
-              if (pt < 30.0 && pt >= 20.0)
-                scaleFactor = 0.981;
-              if (pt < 40.0 && pt >= 30.0)
-                scaleFactor = 0.991;
-              if (pt < 50.0 && pt >= 40.0)
-                scaleFactor = 0.994;
-              if (pt >= 50.0)
-                scaleFactor = 0.999;
-            }
-          if (fabs (eta) < 1.556 && fabs (eta) >= 1.442)
-            {
-              if (pt < 15.0 && pt >= 10.0)
-                scaleFactor = 1.109;
-              if (pt < 20.0 && pt >= 15.0)
-                scaleFactor = 0.903;
-              if (pt < 30.0 && pt >= 20.0)
-                scaleFactor = 1.044;
-              if (pt < 40.0 && pt >= 30.0)
-                scaleFactor = 0.998;
-              if (pt < 50.0 && pt >= 40.0)
-                scaleFactor = 0.989;
-              if (pt >= 50.0)
-                scaleFactor = 0.994;
-            }
-          if (fabs (eta) < 2.0 && fabs (eta) >= 1.556)
-            {
-              if (pt < 15.0 && pt >= 10.0)
-                scaleFactor = 0.838;
-              if (pt < 20.0 && pt >= 15.0)
-                scaleFactor = 0.939;
-              if (pt < 30.0 && pt >= 20.0)
-                scaleFactor = 0.980;
-              if (pt < 40.0 && pt >= 30.0)
-                scaleFactor = 0.992;
-              if (pt < 50.0 && pt >= 40.0)
-                scaleFactor = 1.004;
-              if (pt >= 50.0)
-                scaleFactor = 1.006;
-            }
-          if (fabs (eta) < 2.5 && fabs (eta) >= 2.0)
-            {
-              if (pt < 15.0 && pt >= 10.0)
-                scaleFactor = 1.034;
-              if (pt < 20.0 && pt >= 15.0)
-                scaleFactor = 0.970;
-              if (pt < 30.0 && pt >= 20.0)
-                scaleFactor = 1.017;
-              if (pt < 40.0 && pt >= 30.0)
-                scaleFactor = 1.019;
-              if (pt < 50.0 && pt >= 40.0)
-                scaleFactor = 1.005;
-              if (pt >= 50.0)
-                scaleFactor = 1.009;
-            }
-        }
-      if (id_ == "tight")
-        {
-          if (fabs (eta) < 0.8)
-            {
-              if (pt < 15.0 && pt >= 10.0)
-                scaleFactor = 0.818;
-              if (pt < 20.0 && pt >= 15.0)
-                scaleFactor = 0.928;
-              if (pt < 30.0 && pt >= 20.0)
-                scaleFactor = 0.973;
-              if (pt < 40.0 && pt >= 30.0)
-                scaleFactor = 0.979;
-              if (pt < 50.0 && pt >= 40.0)
-                scaleFactor = 0.984;
-              if (pt >= 50.0)
-                scaleFactor = 0.983;
-            }
-          if (fabs (eta) < 1.442 && fabs (eta) >= 0.8)
-            {
-              if (pt < 15.0 && pt >= 10.0)
-                scaleFactor = 0.840;
-              if (pt < 20.0 && pt >= 15.0)
-                scaleFactor = 0.914;
-              if (pt < 30.0 && pt >= 20.0)
-                scaleFactor = 0.948;
-              if (pt < 40.0 && pt >= 30.0)
-                scaleFactor = 0.961;
-              if (pt < 50.0 && pt >= 40.0)
-                scaleFactor = 0.972;
-              if (pt >= 50.0)
-                scaleFactor = 0.977;
-            }
-          if (fabs (eta) < 1.556 && fabs (eta) >= 1.442)
-            {
-              if (pt < 15.0 && pt >= 10.0)
-                scaleFactor = 1.008;
-              if (pt < 20.0 && pt >= 15.0)
-                scaleFactor = 0.877;
-              if (pt < 30.0 && pt >= 20.0)
-                scaleFactor = 0.983;
-              if (pt < 40.0 && pt >= 30.0)
-                scaleFactor = 0.983;
-              if (pt < 50.0 && pt >= 40.0)
-                scaleFactor = 0.957;
-              if (pt >= 50.0)
-                scaleFactor = 0.978;
-            }
-          if (fabs (eta) < 2.0 && fabs (eta) >= 1.556)
-            {
-              if (pt < 15.0 && pt >= 10.0)
-                scaleFactor = 0.906;
-              if (pt < 20.0 && pt >= 15.0)
-                scaleFactor = 0.907;
-              if (pt < 30.0 && pt >= 20.0)
-                scaleFactor = 0.957;
-              if (pt < 40.0 && pt >= 30.0)
-                scaleFactor = 0.962;
-              if (pt < 50.0 && pt >= 40.0)
-                scaleFactor = 0.985;
-              if (pt >= 50.0)
-                scaleFactor = 0.986;
-            }
-          if (fabs (eta) < 2.5 && fabs (eta) >= 2.0)
-            {
-              if (pt < 15.0 && pt >= 10.0)
-                scaleFactor = 0.991;
-              if (pt < 20.0 && pt >= 15.0)
-                scaleFactor = 0.939;
-              if (pt < 30.0 && pt >= 20.0)
-                scaleFactor = 1.001;
-              if (pt < 40.0 && pt >= 30.0)
-                scaleFactor = 1.002;
-              if (pt < 50.0 && pt >= 40.0)
-                scaleFactor = 0.999;
-              if (pt >= 50.0)
-                scaleFactor = 0.995;
-            }
-        }
-      if (id_ == "mvaTrig0p9") // https://twiki.cern.ch/twiki/bin/view/CMS/KoPFAElectronTagAndProbe
-        {
-          if (fabs (eta) < 0.8)
-            {
-              if (pt < 30.0 && pt >= 20.0)
-                {
-                  scaleFactor = 0.953;
-                  plus = 0.185;
-                  minus = 0.007;
-                }
-              if (pt < 40.0 && pt >= 30.0)
-                {
-                  scaleFactor = 0.945;
-                  plus = 0.003;
-                  minus = 0.003;
-                }
-              if (pt < 50.0 && pt >= 40.0)
-                {
-                  scaleFactor = 0.948;
-                  plus = 0.001;
-                  minus = 0.001;
-                }
-              if (pt >= 50.0)
-                {
-                  scaleFactor = 0.960;
-                  plus = 0.001;
-                  minus = 0.001;
-                }
-            }
-          if (fabs (eta) < 1.478 && fabs (eta) >= 0.8)
-            {
-              if (pt < 30.0 && pt >= 20.0)
-                {
-                  scaleFactor = 0.904;
-                  plus = 0.010;
-                  minus = 0.010;
-                }
-              if (pt < 40.0 && pt >= 30.0)
-                {
-                  scaleFactor = 0.916;
-                  plus = 0.002;
-                  minus = 0.001;
-                }
-              if (pt < 50.0 && pt >= 40.0)
-                {
-                  scaleFactor = 0.959;
-                  plus = 0.001;
-                  minus = 0.001;
-                }
-              if (pt >= 50.0)
-                {
-                  scaleFactor = 0.957;
-                  plus = 0.002;
-                  minus = 0.002;
-                }
-            }
-          if (fabs (eta) <= 2.5 && fabs (eta) >= 1.478)
-            {
-              if (pt < 30.0 && pt >= 20.0)
-                {
-                  scaleFactor = 0.863;
-                  plus = 0.008;
-                  minus = 0.008;
-                }
-              if (pt < 40.0 && pt >= 30.0)
-                {
-                  scaleFactor = 0.896;
-                  plus = 0.004;
-                  minus = 0.004;
-                }
-              if (pt < 50.0 && pt >= 40.0)
-                {
-                  scaleFactor = 0.944;
-                  plus = 0.002;
-                  minus = 0.005;
-                }
-              if (pt >= 50.0)
-                {
-                  scaleFactor = 0.953;
-                  plus = 0.008;
-                  minus = 0.007;
-                }
-            }
+          cout << "Fatal Error [ElectronSFWeight::ElectronSFWeight]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
+          exit (1);
         }
+
+      //////////////////////////////////////////////////////////////////////////
+      // Points outside of the histogram are moved to the nearest bin, and the
+      // axes may be either (eta, pt) or (pt, eta).
+      //////////////////////////////////////////////////////////////////////////
+      electronSFWeight_ = BinnedTable (*dataOverMCHist, true);
+      fromHistogram_ = true;
+      swapAxes_ = strcasestr (dataOverMCHist->GetYaxis ()->GetTitle (), "eta");
+      //////////////////////////////////////////////////////////////////////////
+
+      delete dataOverMCHist;
+      fin->Close ();
+      delete fin;
     }
+  else if (cmsswRelease_ == "53X" && (id_ == "loose" || id_ == "tight" || id_ == "mvaTrig0p9"))
+    // mvaTrig0p9 from https://twiki.cern.ch/twiki/bin/view/CMS/KoPFAElectronTagAndProbe
+    electronSFWeight_ = BinnedTable (edm::FileInPath ("OSUT3Analysis/AnaTools/data/scaleFactors/electronSF_" + cmsswRelease_ + "_" + id_ + ".txt").fullPath ());
+}
 
-  double error = shiftUpDown > 0 ? plus : minus;
-  return scaleFactor + shiftUpDown * error;
+double
+ElectronSFWeight::at (const double &eta, const double &pt, const int &shiftUpDown)
+{
+  if (electronSFWeight_.empty ())
+    return 1.0;
+  if (!fromHistogram_)
+    return electronSFWeight_.at (fabs (eta), pt, shiftUpDown);
+  return (swapAxes_ ? electronSFWeight_.at (pt, eta, shiftUpDown) : electronSFWeight_.at (eta, pt, shiftUpDown));
 }
 
 ElectronSFWeight::~ElectronSFWeight ()
 {
-  if (electronSFWeight_)
-    delete electronSFWeight_;
 }
 
 double
 TriggerMetSFWeight::at(const double &Met, const int &shiftUpDown)
 {
-  int bin = triggerMetSFWeight_->FindBin(Met);
-  return 1.0 + triggerMetSFWeight_->GetBinContent(bin) + shiftUpDown * triggerMetSFWeight_->GetBinError(bin);\
+  unsigned bin = triggerMetSFWeight_.findBin(Met);
+  return 1.0 + triggerMetSFWeight_.value(bin) + shiftUpDown * triggerMetSFWeight_.errorUp(bin);
   // Add 1.0 because the histogram bin content is (data-MC)/MC
 }
 
 TriggerMetSFWeight::~TriggerMetSFWeight ()
 {
-  delete triggerMetSFWeight_;
 }
 
-TriggerMetSFWeight::TriggerMetSFWeight (const string &sfFile, const string &dataOverMC)
+TriggerMetSFWeight::TriggerMetSFWeight (const string &sfFile, const string &dataOverMC) :
+  triggerMetSFWeight_ (getTable (sfFile, dataOverMC, "TriggerMetSFWeight::TriggerMetSFWeight"))
 {
-  TFile *fin = TFile::Open (sfFile.c_str ());
-  TH1F* dataOverMCHist = (TH1F *) fin->Get(dataOverMC.c_str ());
-  if (!dataOverMCHist) cout << "Fatal Error [TriggerMetSFWeight::TriggerMetSFWeight]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
-  triggerMetSFWeight_ = (TH1F*)  dataOverMCHist->Clone();
-  triggerMetSFWeight_->GetEntries();// to avoid the crashing warning
-  delete dataOverMCHist;
-  fin->Close ();
-  delete fin;
  }
 
 
 double
 TrackNMissOutSFWeight::at(const double &NMissOut, const int &shiftUpDown)
 {
-  int bin = trackNMissOutSFWeight_->FindBin(NMissOut);
-  return 1.0 + trackNMissOutSFWeight_->GetBinContent(bin) + shiftUpDown * trackNMissOutSFWeight_->GetBinError(bin);  // Add 1.0 because the histogram bin content is (data-MC)/MC
+  unsigned bin = trackNMissOutSFWeight_.findBin(NMissOut);
+  return 1.0 + trackNMissOutSFWeight_.value(bin) + shiftUpDown * trackNMissOutSFWeight_.errorUp(bin);  // Add 1.0 because the histogram bin content is (data-MC)/MC
 }
 
 TrackNMissOutSFWeight::~TrackNMissOutSFWeight ()
 {
-  delete trackNMissOutSFWeight_;
 }
 
 
 
 
-TrackNMissOutSFWeight::TrackNMissOutSFWeight (const string &sfFile, const string &dataOverMC)
+TrackNMissOutSFWeight::TrackNMissOutSFWeight (const string &sfFile, const string &dataOverMC) :
+  trackNMissOutSFWeight_ (getTable (sfFile, dataOverMC, "TrackNMissOutSFWeight::TrackNMissOutSFWeight"))
 {
-  TFile *fin = TFile::Open (sfFile.c_str ());
-  TH1F* dataOverMCHist = (TH1F *) fin->Get(dataOverMC.c_str ());
-  if (!dataOverMCHist) cout << "Fatal Error [TrackNMissOutSFWeight::TrackNMissOutSFWeight]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
-  trackNMissOutSFWeight_ = (TH1F*)  dataOverMCHist->Clone();
-  trackNMissOutSFWeight_->GetEntries();  // to avoid the crashing warning
-  delete dataOverMCHist;
-  fin->Close ();
-  delete fin;
 }
 
 
 double
 EcaloVarySFWeight::at(const double &EcaloVary, const int &shiftUpDown)
 {
-  int bin = EcaloVarySFWeight_->FindBin(EcaloVary);
-  return 1.0 + EcaloVarySFWeight_->GetBinContent(bin) + shiftUpDown * EcaloVarySFWeight_->GetBinError(bin);  // Add 1.0 because the histogram bin content is (data-MC)/MC
+  unsigned bin = EcaloVarySFWeight_.findBin(EcaloVary);
+  return 1.0 + EcaloVarySFWeight_.value(bin) + shiftUpDown * EcaloVarySFWeight_.errorUp(bin);  // Add 1.0 because the histogram bin content is (data-MC)/MC
 }
 
 EcaloVarySFWeight::~EcaloVarySFWeight ()
 {
-  delete EcaloVarySFWeight_;
 }
 
-EcaloVarySFWeight::EcaloVarySFWeight (const string &sfFile, const string &dataOverMC)
+EcaloVarySFWeight::EcaloVarySFWeight (const string &sfFile, const string &dataOverMC) :
+  EcaloVarySFWeight_ (getTable (sfFile, dataOverMC, "EcaloVarySFWeight::EcaloVarySFWeight"))
 {
-  TFile *fin = TFile::Open (sfFile.c_str ());
-  TH1F* dataOverMCHist = (TH1F *) fin->Get(dataOverMC.c_str ());
-  if (!dataOverMCHist) cout << "Fatal Error [EcaloVarySFWeight::EcaloVarySFWeight]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
-  EcaloVarySFWeight_ = (TH1F*)  dataOverMCHist->Clone();
-  EcaloVarySFWeight_->GetEntries();  // to avoid the crashing warning
-  delete dataOverMCHist;
-  fin->Close ();
-  delete fin;
 }
 
 
-IsrVarySFWeight::IsrVarySFWeight (const string &sfFile, const string &dataOverMC)
+IsrVarySFWeight::IsrVarySFWeight (const string &sfFile, const string &dataOverMC) :
+  isrVarySFWeight_ (getTable (sfFile, dataOverMC, "IsrVarySFWeight::IsrVarySFWeight"))
 {
-  TFile *fin = TFile::Open (sfFile.c_str ());
-  TH1F* dataOverMCHist = (TH1F *) fin->Get(dataOverMC.c_str ());
-  if (!dataOverMCHist) cout << "Fatal Error [IsrVarySFWeight::IsrVarySFWeight]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
-  isrVarySFWeight_ = (TH1F*)  dataOverMCHist->Clone();
-  isrVarySFWeight_->GetEntries();// to avoid the crashing warning
-  delete dataOverMCHist;
-  clog << "Will use hist " << isrVarySFWeight_->GetName() << " from file " << sfFile << " to do ISR reweighting." << endl;
-  fin->Close ();
-  delete fin;
+  clog << "Will use hist " << dataOverMC << " from file " << sfFile << " to do ISR reweighting." << endl;
  }
 
 double
 IsrVarySFWeight::at(const double &ptSusy, const int &shiftUpDown)
 {
-  int bin = isrVarySFWeight_->FindBin(ptSusy);
-  return 1.0 + isrVarySFWeight_->GetBinContent(bin) + shiftUpDown * isrVarySFWeight_->GetBinError(bin);  // Add 1.0 because the histogram bin content is (data-MC)/MC
+  unsigned bin = isrVarySFWeight_.findBin(ptSusy);
+  return 1.0 + isrVarySFWeight_.value(bin) + shiftUpDown * isrVarySFWeight_.errorUp(bin);  // Add 1.0 because the histogram bin content is (data-MC)/MC
 }
 
 IsrVarySFWeight::~IsrVarySFWeight ()
 {
-  delete isrVarySFWeight_;
 }
 
 
 // Define four classes that will be used to reweight generated event to emulate the CMS reconstruction and the set of cut applied in the displaced susy analysis
 
 // MuonCutWeight
-MuonCutWeight::MuonCutWeight (const string &sfFile, const string &dataOverMC)
+MuonCutWeight::MuonCutWeight (const string &sfFile, const string &dataOverMC) :
+  muonCutWeight_ (getTable (sfFile, dataOverMC, "MuonCutWeight::MuonCutWeight"))
 {
-  TFile *fin = TFile::Open (sfFile.c_str ());
-  TH1F* dataOverMCHist = (TH1F *) fin->Get(dataOverMC.c_str ());
-  if (!dataOverMCHist) cout << "Fatal Error [MuonCutWeight::MuonCutWeight]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
-  muonCutWeight_ = (TH1F*)  dataOverMCHist->Clone();
-  muonCutWeight_->GetEntries();  // to avoid the crashing warning
-  delete dataOverMCHist;
-  fin->Close ();
-  delete fin;
 }
 
 
 double
 MuonCutWeight::at(const double &pt)
 {
-  int bin = muonCutWeight_->FindBin(pt);
-  return  muonCutWeight_->GetBinContent(bin);
+  return muonCutWeight_.value(muonCutWeight_.findBin(pt));
 }
 
 MuonCutWeight::~MuonCutWeight ()
 {
-  delete muonCutWeight_;
 }
 
 
 // ElectronCutWeight
-ElectronCutWeight::ElectronCutWeight (const string &sfFile, const string &dataOverMC)
+ElectronCutWeight::ElectronCutWeight (const string &sfFile, const string &dataOverMC) :
+  electronCutWeight_ (getTable (sfFile, dataOverMC, "ElectronCutWeight::ElectronCutWeight"))
 {
-  TFile *fin = TFile::Open (sfFile.c_str ());
-  TH1F* dataOverMCHist = (TH1F *) fin->Get(dataOverMC.c_str ());
-  if (!dataOverMCHist) cout << "Fatal Error [ElectronCutWeight::ElectronCutWeight]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
-  electronCutWeight_ = (TH1F*)  dataOverMCHist->Clone();
-  electronCutWeight_->GetEntries();  // to avoid the crashing warning
-  delete dataOverMCHist;
-  fin->Close ();
-  delete fin;
 }
 
 
 double
 ElectronCutWeight::at(const double &pt)
 {
-  int bin = electronCutWeight_->FindBin(pt);
-  return  electronCutWeight_->GetBinContent(bin);
+  return electronCutWeight_.value(electronCutWeight_.findBin(pt));
 }
 
 ElectronCutWeight::~ElectronCutWeight ()
 {
-  delete electronCutWeight_;
 }
 
 // RecoElectronWeight
-RecoElectronWeight::RecoElectronWeight (const string &sfFile, const string &dataOverMC)
+RecoElectronWeight::RecoElectronWeight (const string &sfFile, const string &dataOverMC) :
+  recoElectronWeight_ (getTable (sfFile, dataOverMC, "RecoElectronWeight::RecoElectronWeight"))
 {
-  TFile *fin = TFile::Open (sfFile.c_str ());
-  TH1F* dataOverMCHist = (TH1F *) fin->Get(dataOverMC.c_str ());
-  if (!dataOverMCHist) cout << "Fatal Error [RecoElectronWeight::RecoElectronWeight]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
-  recoElectronWeight_ = (TH1F*)  dataOverMCHist->Clone();
-  recoElectronWeight_->GetEntries();
-  delete dataOverMCHist;
-  fin->Close ();
-  delete fin;
 }
 
 
 double
 RecoElectronWeight::at(const double &d0)
 {
-  int bin = recoElectronWeight_->FindBin(d0);
-  return recoElectronWeight_->GetBinContent(bin);
+  return recoElectronWeight_.value(recoElectronWeight_.findBin(d0));
 }
 
 RecoElectronWeight::~RecoElectronWeight ()
 {
-  delete recoElectronWeight_;
 }
 
 // RecoMuonWeight
-RecoMuonWeight::RecoMuonWeight (const string &sfFile, const string &dataOverMC)
+RecoMuonWeight::RecoMuonWeight (const string &sfFile, const string &dataOverMC) :
+  recoMuonWeight_ (getTable (sfFile, dataOverMC, "RecoMuonWeight::RecoMuonWeight"))
 {
-  TFile *fin = TFile::Open (sfFile.c_str ());
-  TH1F* dataOverMCHist = (TH1F *) fin->Get(dataOverMC.c_str ());
-  if (!dataOverMCHist) cout << "Fatal Error [RecoMuonWeight::RecoMuonWeight]:  could not find histogram " << dataOverMC << " in " << sfFile << endl;
-  recoMuonWeight_ = (TH1F*)  dataOverMCHist->Clone();
-  recoMuonWeight_->GetEntries();  // to avoid the crashing warning
-  delete dataOverMCHist;
-  fin->Close ();
-  delete fin;
 }
 
 
 double
 RecoMuonWeight::at(const double &d0)
 {
-  int bin = recoMuonWeight_->FindBin(d0);
-  return  recoMuonWeight_->GetBinContent(bin);
+  return recoMuonWeight_.value(recoMuonWeight_.findBin(d0));
 }
 
 RecoMuonWeight::~RecoMuonWeight ()
 {
-  delete recoMuonWeight_;
 }
 
 
 
 
-
 /*
 --- Used previously
 
@@ -0,0 +1,37 @@
+#include "OSUT3Analysis/AnaTools/interface/SubexpressionCache.h"
+
+unsigned
+SubexpressionCache::getExpressionId (const string &expression)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Returns the identifier of the given subexpression, appending a new one if
+  // it has not been seen before in this module, and counts the use.
+  //////////////////////////////////////////////////////////////////////////////
+  auto expressionId = expressionIds_.find (expression);
+  if (expressionId != expressionIds_.end ())
+    {
+      useCounts_.at (expressionId->second)++;
+      return expressionId->second;
+    }
+  unsigned newExpressionId = expressionIds_.size ();
+  expressionIds_[expression] = newExpressionId;
+  useCounts_.push_back (1);
+  return newExpressionId;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+bool
+SubexpressionCache::find (const unsigned expression, const unsigned combination, double &value) const
+{
+  auto cachedValue = values_.find (((uint64_t) expression << 32) | combination);
+  if (cachedValue == values_.end ())
+    return false;
+  value = cachedValue->second;
+  return true;
+}
+
+void
+SubexpressionCache::insert (const unsigned expression, const unsigned combination, const double value)
+{
+  values_[((uint64_t) expression << 32) | combination] = value;
+}
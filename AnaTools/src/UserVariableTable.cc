@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <limits>
+
+#include "OSUT3Analysis/AnaTools/interface/DataFormat.h"
+#include "OSUT3Analysis/AnaTools/interface/UserVariableTable.h"
+
+void
+UserVariableTable::fill (const vector<edm::Handle<osu::Uservariable> > &handles)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // The columns are emptied rather than removed, so that their memory is
+  // reused from one event to the next.
+  //////////////////////////////////////////////////////////////////////////////
+  for (auto &column : columns_)
+    {
+      column.second.filled = false;
+      column.second.types.clear ();
+      column.second.collections.clear ();
+      column.second.values.clear ();
+      column.second.combinations.clear ();
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+#if IS_VALID(uservariables)
+  vector<int> indices;
+  for (const auto &handle : handles)
+    {
+      if (!handle.isValid ())
+        continue;
+      for (const auto &variable : *handle)
+        {
+          Column &column = columns_[variable.first];
+          if (column.filled)
+            continue;
+
+          for (const auto &userVariable : variable.second)
+            {
+              //////////////////////////////////////////////////////////////////
+              // ObjectList is sorted by type, so the types and indices are
+              // read in a canonical order. Indices of objects of the same type
+              // are sorted as well, so that the order in which a producer
+              // gives them does not matter.
+              //////////////////////////////////////////////////////////////////
+              if (column.types.empty ())
+                for (const auto &object : userVariable.objects)
+                  {
+                    auto collection = userVariable.collections.find (object.first);
+                    column.types.push_back (object.first);
+                    column.collections.push_back (collection != userVariable.collections.end () ? collection->second : edm::ProductID ());
+                  }
+              if (userVariable.objects.size () != column.types.size ())
+                continue;
+
+              indices.clear ();
+              for (auto object = userVariable.objects.begin (); object != userVariable.objects.end (); )
+                {
+                  auto range = userVariable.objects.equal_range (object->first);
+                  unsigned first = indices.size ();
+                  for (object = range.first; object != range.second; object++)
+                    indices.push_back (object->second);
+                  sort (indices.begin () + first, indices.end ());
+                }
+              //////////////////////////////////////////////////////////////////
+
+              if (indices.size () > 1)
+                column.combinations[indices] = userVariable.value;
+              else
+                {
+                  int index = indices.empty () ? 0 : indices.at (0);
+                  if (index < 0)
+                    continue;
+                  if ((int) column.values.size () <= index)
+                    column.values.resize (index + 1, INVALID_VALUE);
+                  column.values[index] = userVariable.value;
+                }
+            }
+          column.filled = true;
+        }
+    }
+#endif
+}
+
+const vector<string> *
+UserVariableTable::getTypes (const string &name) const
+{
+  auto column = columns_.find (name);
+  if (column == columns_.end () || !column->second.filled)
+    return NULL;
+  return &column->second.types;
+}
+
+const vector<edm::ProductID> *
+UserVariableTable::getCollections (const string &name) const
+{
+  auto column = columns_.find (name);
+  if (column == columns_.end () || !column->second.filled)
+    return NULL;
+  return &column->second.collections;
+}
+
+double
+UserVariableTable::get (const string &name, const vector<int> &indices) const
+{
+  if (indices.size () < 2)
+    return get (name, indices.empty () ? 0 : indices.at (0));
+
+  auto column = columns_.find (name);
+  if (column == columns_.end () || !column->second.filled)
+    return INVALID_VALUE;
+  auto value = column->second.combinations.find (indices);
+  return (value != column->second.combinations.end () ? value->second : INVALID_VALUE);
+}
+
+double
+UserVariableTable::get (const string &name, const int index) const
+{
+  auto column = columns_.find (name);
+  if (column == columns_.end () || !column->second.filled)
+    return INVALID_VALUE;
+  const vector<double> &values = column->second.values;
+  return ((index >= 0 && index < (int) values.size ()) ? values[index] : INVALID_VALUE);
+}
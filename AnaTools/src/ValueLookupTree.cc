@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cstdio>
 #include <algorithm>
 
 #include "DataFormats/Math/interface/deltaR.h"
@@ -7,50 +8,110 @@
 #include "OSUT3Analysis/AnaTools/interface/CommonUtils.h"
 #include "OSUT3Analysis/AnaTools/interface/ValueLookupTree.h"
 
+////////////////////////////////////////////////////////////////////////////////
+// Element-wise loops used by the columnar evaluation. Like evaluateOperator, the
+// result is invalid if any operand is invalid. The loops have no branches or
+// calls other than the operator itself, so that the compiler can vectorize
+// them.
+////////////////////////////////////////////////////////////////////////////////
+#define UNARY_COLUMN_OPERATOR(expression) \
+  for (unsigned i = 0; i < n; i++) \
+    a[i] = (IS_INVALID(a[i]) ? INVALID_VALUE : (expression));
+#define BINARY_COLUMN_OPERATOR(expression) \
+  for (unsigned i = 0; i < n; i++) \
+    a[i] = ((IS_INVALID(a[i]) || IS_INVALID(b[i])) ? INVALID_VALUE : (expression));
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Operators known to evaluateOperator, by the number of operands they take.
+  // Those in stringOperators take collection names, e.g., deltaR (muon, jet),
+  // and all the others take numbers. The numbers of operands of invMass and pT
+  // are not fixed.
+  //////////////////////////////////////////////////////////////////////////////
+  const unordered_set<string> unaryOperators = {"!", "+", "-", "cos", "sin", "tan", "acos", "asin", "atan", "cosh", "sinh", "tanh", "acosh", "asinh", "atanh", "exp", "log", "log10", "exp2", "expm1", "ilogb", "log1p", "log2", "logb", "sqrt", "cbrt", "erf", "erfc", "tgamma", "lgamma", "ceil", "floor", "trunc", "round", "rint", "nearbyint", "abs", "fabs", "normalizedPhi"};
+  const unordered_set<string> binaryOperators = {"||", "|", "&&", "&", "==", "=", "!=", "<", "<=", ">", ">=", "+", "-", "*", "/", "%", "atan2", "ldexp", "pow", "hypot", "fmod", "remainder", "copysign", "nextafter", "fdim", "fmax", "max", "fmin", "min", "dPhi"};
+  const unordered_map<string, int> stringOperators = {{"deltaPhi", 2}, {"compositePhi", 2}, {"deltaR", 2}, {"transMass", 2}, {"number", 1}, {"invMass", -1}, {"pT", -1}};
+  const unordered_set<string> numericTypes = {"float", "double", "long double", "char", "int", "unsigned", "unsigned short", "unsigned long", "bool", "unsigned int", "unsigned short int", "unsigned long int"};
+  //////////////////////////////////////////////////////////////////////////////
+
+  const unordered_set<string> unaryColumnOperators = {"+", "-", "!", "abs", "fabs", "sqrt", "exp", "log", "log10", "sin", "cos", "tan", "atan"};
+  const unordered_set<string> binaryColumnOperators = {"||", "|", "&&", "&", "==", "=", "!=", "<", "<=", ">", ">=", "+", "-", "*", "/", "atan2", "pow", "hypot", "fmax", "max", "fmin", "min", "dPhi"};
+}
+
 ValueLookupTree::ValueLookupTree () :
   root_ (NULL),
   evaluationError_ (false),
-  allCollectionsNonEmpty_ (false)
+  allCollectionsNonEmpty_ (false),
+  combination_ (0),
+  columnar_ (false),
+  registeredHandles_ (NULL)
 {
+  fill (kinematicMembers_, kinematicMembers_ + N_KINEMATIC_MEMBERS, -1);
 }
 
 ValueLookupTree::ValueLookupTree (const Cut &cut) :
   root_ (insert_ (cut.cutString, NULL)),
   inputCollections_ (cut.inputCollections),
   evaluationError_ (false),
-  allCollectionsNonEmpty_ (false)
+  allCollectionsNonEmpty_ (false),
+  combination_ (0),
+  columnar_ (false),
+  registeredHandles_ (NULL)
 {
   pruneCommas (root_);
   pruneParentheses (root_);
   pruneDots (root_);
+  foldConstants (root_);
 
   sort (inputCollections_.begin (), inputCollections_.end ());
+  resolveSlots (root_);
+  resolveCollections ();
+  findSubexpressions ();
+  initializeColumns ();
 }
 
 ValueLookupTree::ValueLookupTree (const ValueToPrint &value) :
   root_ (insert_ (value.valueToPrint, NULL)),
   inputCollections_ (value.inputCollections),
   evaluationError_ (false),
-  allCollectionsNonEmpty_ (false)
+  allCollectionsNonEmpty_ (false),
+  combination_ (0),
+  columnar_ (false),
+  registeredHandles_ (NULL)
 {
   pruneCommas (root_);
   pruneParentheses (root_);
   pruneDots (root_);
+  foldConstants (root_);
 
   sort (inputCollections_.begin (), inputCollections_.end ());
+  resolveSlots (root_);
+  resolveCollections ();
+  findSubexpressions ();
+  initializeColumns ();
 }
 
 ValueLookupTree::ValueLookupTree (const string &expression, const vector<string> &inputCollections) :
   root_ (insert_ (expression, NULL)),
   inputCollections_ (inputCollections),
   evaluationError_ (false),
-  allCollectionsNonEmpty_ (false)
+  allCollectionsNonEmpty_ (false),
+  combination_ (0),
+  columnar_ (false),
+  registeredHandles_ (NULL)
 {
   pruneCommas (root_);
   pruneParentheses (root_);
   pruneDots (root_);
+  foldConstants (root_);
 
   sort (inputCollections_.begin (), inputCollections_.end ());
+  resolveSlots (root_);
+  resolveCollections ();
+  findSubexpressions ();
+  initializeColumns ();
 }
 
 ValueLookupTree::~ValueLookupTree ()
@@ -70,15 +131,20 @@ ValueLookupTree::setCollections (Collections * const handles)
   // just the size of the i-th collection.
   //////////////////////////////////////////////////////////////////////////////
   handles_ = handles;
+  if (registeredHandles_ != handles_)
+    {
+      registerSubexpressions (handles_->subexpressionCache);
+      registeredHandles_ = handles_;
+    }
   values_.clear ();
   nCombinations_.clear ();
   collectionSizes_.clear ();
   nCombinations_.assign (inputCollections_.size (), 1);
   allCollectionsNonEmpty_ = true;
-  for (auto collection = inputCollections_.begin (); collection != inputCollections_.end (); collection++)
+  for (auto collection = inputCollectionIds_.begin (); collection != inputCollectionIds_.end (); collection++)
     {
       unsigned currentSize = getCollectionSize (*collection);
-      for (unsigned i = 0; i < (collection - inputCollections_.begin () + 1); i++)
+      for (unsigned i = 0; i < (collection - inputCollectionIds_.begin () + 1); i++)
         nCombinations_[i] *= currentSize;
       collectionSizes_.push_back (currentSize);
       allCollectionsNonEmpty_ = allCollectionsNonEmpty_ && currentSize;
@@ -117,19 +183,22 @@ ValueLookupTree::evaluate ()
   if (!values_.size () && allCollectionsNonEmpty_)
     {
       evaluationError_ = false;
-      uservariablesToDelete_.clear ();
-      eventvariablesToDelete_.clear ();
+      if (columnar_)
+        {
+          evaluateColumns ();
+          return values_;
+        }
       for (unsigned i = 0; i < nCombinations_.at (0); i++)
         {
-          objIterators_.clear ();
-          shouldIterate_.clear ();
+          combination_ = i;
+          objIteratorsSet_.reset ();
           ObjMap objs;
           unordered_set<string> keys;
           for (auto collection = inputCollections_.begin (); collection != inputCollections_.end (); collection++)
             {
               unsigned j = collection - inputCollections_.begin (),
                        localIndex = getLocalIndex (i, j);
-              objs.insert ({*collection, {j, localIndex, getObject (*collection, localIndex)}});
+              objs.insert ({*collection, {j, localIndex, getObject (inputCollectionIds_.at (j), localIndex)}});
               keys.insert (*collection);
             }
           if (isUniqueCase (objs, keys)) {
@@ -146,14 +215,6 @@ ValueLookupTree::evaluate ()
           } else
             values_.push_back (INVALID_VALUE);
         }
-#if IS_VALID(uservariables)
-      for (auto &uservariable : uservariablesToDelete_)
-        delete ((osu::Uservariable *) uservariable);
-#endif
-#if IS_VALID(eventvariables)
-      for (auto &eventvariable : eventvariablesToDelete_)
-        delete ((osu::Eventvariable *) eventvariable);
-#endif
     }
 
   return values_;
@@ -231,110 +292,101 @@ ValueLookupTree::getGlobalIndices (unsigned localIndex, const string &singleObje
 unsigned
 ValueLookupTree::getCollectionSize (const string &name) const
 {
+  CollectionId collection = anatools::getCollectionId (name);
+  if (!collectionIsFound (collection))
+    exitMissingCollection (name);
+  return getCollectionSize (collection);
+}
 
-  if (!collectionIsFound(name)) {
-    clog << "ERROR [ValueLookupTree::getCollectionSize]:  Could not find collection named " << name
-         << " for expression: " << printNode(root_) << endl
-         << "List of input collections: " << endl;
-    for (uint i=0; i<inputCollections_.size(); i++) clog << "  " << inputCollections_.at(i) << endl;
-    clog << "Please modify your configuration file.  Exiting..." << endl << endl << endl;
-    exit(8);
-  }
+unsigned
+ValueLookupTree::getCollectionSize (const CollectionId collection) const
+{
+  if (!collectionIsFound (collection))
+    exitMissingCollection (anatools::getCollectionName (collection));
 
-  if (EQ_VALID(name,beamspots))
-    return 1;
-  else if (EQ_VALID(name,bxlumis))
-    return handles_->bxlumis->size ();
-  else if (EQ_VALID(name,cschits))
-    return handles_->cschits->size ();
-  else if (EQ_VALID(name,cscsegs))
-    return handles_->cscsegs->size ();
-  else if (EQ_VALID(name,dtsegs))
-    return handles_->dtsegs->size ();
-  else if (EQ_VALID(name,electrons))
-    return handles_->electrons->size ();
-  else if (EQ_VALID(name,events))
-    return handles_->events->size ();
-  else if (EQ_VALID(name,genjets))
-    return handles_->genjets->size ();
-  else if (EQ_VALID(name,generatorweights))
-    return 1;
-  else if (EQ_VALID(name,basicjets))
-    return handles_->basicjets->size ();
-  else if (EQ_VALID(name,jets))
-    return handles_->jets->size ();
-  else if (EQ_VALID(name,bjets))
-    return handles_->bjets->size ();
-  else if (EQ_VALID(name,mcparticles))
-    return handles_->mcparticles->size ();
-  else if (EQ_VALID(name,mets))
-    return handles_->mets->size ();
-  else if (EQ_VALID(name,muons))
-    return handles_->muons->size ();
-  else if (EQ_VALID(name,photons))
-    return handles_->photons->size ();
-  else if (EQ_VALID(name,primaryvertexs))
-    return handles_->primaryvertexs->size ();
-  else if (EQ_VALID(name,rpchits))
-    return handles_->rpchits->size ();
-  else if (EQ_VALID(name,superclusters))
-    return handles_->superclusters->size ();
-  else if (EQ_VALID(name,taus))
-    return handles_->taus->size ();
-  else if (EQ_VALID(name,tracks))
-    return handles_->tracks->size ();
-  else if (EQ_VALID(name,secondaryTracks))
-    return handles_->secondaryTracks->size ();
-  else if (EQ_VALID(name,pileupinfos))
-    return handles_->pileupinfos->size ();
-  else if (EQ_VALID(name,uservariables)){
-    // !!!
-    //    return handles_->uservariables[printValue(root_)].size ();
-    //    return handles_->uservariables["electronPt"].size ();
-    //cout << handles_->uservariables.at(printValue(root_)).size () << endl;
-    //    auto isFound = handles_->uservariables.size();
-    //    cout << printValue(root_) << endl;
-    //    cout << "\t" << isFound << endl;
-    return 1;  // FIXME
-  }
-  else if (EQ_VALID(name,eventvariables)){
-    return 1;  // FIXME
-  }
-  return 0;
+  switch (collection)
+    {
+      case COLLECTION_BEAMSPOTS:        return 1;
+      case COLLECTION_BXLUMIS:          return handles_->bxlumis->size ();
+      case COLLECTION_CSCHITS:          return handles_->cschits->size ();
+      case COLLECTION_CSCSEGS:          return handles_->cscsegs->size ();
+      case COLLECTION_DTSEGS:           return handles_->dtsegs->size ();
+      case COLLECTION_ELECTRONS:        return handles_->electrons->size ();
+      case COLLECTION_EVENTS:           return handles_->events->size ();
+      case COLLECTION_GENJETS:          return handles_->genjets->size ();
+      case COLLECTION_GENERATORWEIGHTS: return 1;
+      case COLLECTION_BASICJETS:        return handles_->basicjets->size ();
+      case COLLECTION_JETS:             return handles_->jets->size ();
+      case COLLECTION_BJETS:            return handles_->bjets->size ();
+      case COLLECTION_MCPARTICLES:      return handles_->mcparticles->size ();
+      case COLLECTION_METS:             return handles_->mets->size ();
+      case COLLECTION_MUONS:            return handles_->muons->size ();
+      case COLLECTION_PHOTONS:          return handles_->photons->size ();
+      case COLLECTION_PRIMARYVERTEXS:   return handles_->primaryvertexs->size ();
+      case COLLECTION_RPCHITS:          return handles_->rpchits->size ();
+      case COLLECTION_SUPERCLUSTERS:    return handles_->superclusters->size ();
+      case COLLECTION_TAUS:             return handles_->taus->size ();
+      case COLLECTION_TRACKS:           return handles_->tracks->size ();
+      case COLLECTION_SECONDARYTRACKS:  return handles_->secondaryTracks->size ();
+      case COLLECTION_PILEUPINFOS:      return handles_->pileupinfos->size ();
+      case COLLECTION_USERVARIABLES:    return 1;  // a single UserVariableTable, indexed by the other objects in each combination
+      case COLLECTION_EVENTVARIABLES:   return 1;  // a single EventVariableTable
+      default:                          return 0;
+    }
 }
 
+bool
+ValueLookupTree::collectionIsFound (const string &name) const
+{
+  return collectionIsFound (anatools::getCollectionId (name));
+}
 
 bool
-  ValueLookupTree::collectionIsFound (const string &name) const
-{
-  bool isFound = false;
-  if        (EQ_VALID(name,beamspots))         isFound = handles_->beamspots.isValid();
-  else  if  (EQ_VALID(name,bxlumis))           isFound  =  handles_->bxlumis.isValid();
-  else  if  (EQ_VALID(name,cschits))           isFound  =  handles_->cschits.isValid();
-  else  if  (EQ_VALID(name,cscsegs))           isFound  =  handles_->cscsegs.isValid();
-  else  if  (EQ_VALID(name,dtsegs))            isFound  =  handles_->dtsegs.isValid();
-  else  if  (EQ_VALID(name,electrons))         isFound  =  handles_->electrons.isValid();
-  else  if  (EQ_VALID(name,events))            isFound  =  handles_->events.isValid();
-  else  if  (EQ_VALID(name,genjets))           isFound  =  handles_->genjets.isValid();
-  else  if  (EQ_VALID(name,generatorweights))  isFound  =  handles_->generatorweights.isValid();
-  else  if  (EQ_VALID(name,basicjets))         isFound  =  handles_->basicjets.isValid();
-  else  if  (EQ_VALID(name,jets))              isFound  =  handles_->jets.isValid();
-  else  if  (EQ_VALID(name,bjets))             isFound  =  handles_->bjets.isValid();
-  else  if  (EQ_VALID(name,mcparticles))       isFound  =  handles_->mcparticles.isValid();
-  else  if  (EQ_VALID(name,mets))              isFound  =  handles_->mets.isValid();
-  else  if  (EQ_VALID(name,muons))             isFound  =  handles_->muons.isValid();
-  else  if  (EQ_VALID(name,photons))           isFound  =  handles_->photons.isValid();
-  else  if  (EQ_VALID(name,primaryvertexs))    isFound  =  handles_->primaryvertexs.isValid();
-  else  if  (EQ_VALID(name,rpchits))           isFound  =  handles_->rpchits.isValid();
-  else  if  (EQ_VALID(name,superclusters))     isFound  =  handles_->superclusters.isValid();
-  else  if  (EQ_VALID(name,taus))              isFound  =  handles_->taus.isValid();
-  else  if  (EQ_VALID(name,tracks))            isFound  =  handles_->tracks.isValid();
-  else  if  (EQ_VALID(name,secondaryTracks))   isFound  =  handles_->secondaryTracks.isValid();
-  else  if  (EQ_VALID(name,pileupinfos))       isFound  =  handles_->pileupinfos.isValid();
-  else if (EQ_VALID(name,uservariables))       isFound = true; // This vector is always present, even if its size is 0.
-  else if (EQ_VALID(name,eventvariables))      isFound = true; // This vector is always present, even if its size is 0.
-  return isFound;
+ValueLookupTree::collectionIsFound (const CollectionId collection) const
+{
+  if (!anatools::isObjectCollection (collection))
+    return false;
 
+  switch (collection)
+    {
+      case COLLECTION_BEAMSPOTS:        return handles_->beamspots.isValid ();
+      case COLLECTION_BXLUMIS:          return handles_->bxlumis.isValid ();
+      case COLLECTION_CSCHITS:          return handles_->cschits.isValid ();
+      case COLLECTION_CSCSEGS:          return handles_->cscsegs.isValid ();
+      case COLLECTION_DTSEGS:           return handles_->dtsegs.isValid ();
+      case COLLECTION_ELECTRONS:        return handles_->electrons.isValid ();
+      case COLLECTION_EVENTS:           return handles_->events.isValid ();
+      case COLLECTION_GENJETS:          return handles_->genjets.isValid ();
+      case COLLECTION_GENERATORWEIGHTS: return handles_->generatorweights.isValid ();
+      case COLLECTION_BASICJETS:        return handles_->basicjets.isValid ();
+      case COLLECTION_JETS:             return handles_->jets.isValid ();
+      case COLLECTION_BJETS:            return handles_->bjets.isValid ();
+      case COLLECTION_MCPARTICLES:      return handles_->mcparticles.isValid ();
+      case COLLECTION_METS:             return handles_->mets.isValid ();
+      case COLLECTION_MUONS:            return handles_->muons.isValid ();
+      case COLLECTION_PHOTONS:          return handles_->photons.isValid ();
+      case COLLECTION_PRIMARYVERTEXS:   return handles_->primaryvertexs.isValid ();
+      case COLLECTION_RPCHITS:          return handles_->rpchits.isValid ();
+      case COLLECTION_SUPERCLUSTERS:    return handles_->superclusters.isValid ();
+      case COLLECTION_TAUS:             return handles_->taus.isValid ();
+      case COLLECTION_TRACKS:           return handles_->tracks.isValid ();
+      case COLLECTION_SECONDARYTRACKS:  return handles_->secondaryTracks.isValid ();
+      case COLLECTION_PILEUPINFOS:      return handles_->pileupinfos.isValid ();
+      case COLLECTION_USERVARIABLES:    return true; // This vector is always present, even if its size is 0.
+      case COLLECTION_EVENTVARIABLES:   return true; // This vector is always present, even if its size is 0.
+      default:                          return false;
+    }
+}
+
+void
+ValueLookupTree::exitMissingCollection (const string &name) const
+{
+  clog << "ERROR [ValueLookupTree::getCollectionSize]:  Could not find collection named " << name
+       << " for expression: " << printNode(root_) << endl
+       << "List of input collections: " << endl;
+  for (uint i=0; i<inputCollections_.size(); i++) clog << "  " << inputCollections_.at(i) << endl;
+  clog << "Please modify your configuration file.  Exiting..." << endl << endl << endl;
+  exit(8);
 }
 
 
@@ -438,6 +490,421 @@ ValueLookupTree::pruneDots (Node * &tree) const
     }
 }
 
+void
+ValueLookupTree::foldConstants (Node * const tree)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Recursively replaces each operator whose operands are all numbers, e.g.,
+  // 2 * 3.14159, with a leaf holding its value, so that it is not evaluated
+  // again for every object. The value is printed with enough digits that
+  // isnumber gives back exactly the same double. Nothing is folded if the
+  // operator raises an error.
+  //////////////////////////////////////////////////////////////////////////////
+  if (!tree || !tree->branches.size ())
+    return;
+  vector<Leaf> operands;
+  for (const auto &branch : tree->branches)
+    {
+      double value;
+      foldConstants (branch);
+      if (!branch->branches.size () && isnumber (branch->value, value))
+        operands.push_back (value);
+    }
+  if (operands.size () != tree->branches.size ()
+   || !((operands.size () == 1 && unaryOperators.count (tree->value))
+     || (operands.size () == 2 && binaryOperators.count (tree->value))))
+    return;
+
+  bool previousError = evaluationError_;
+  evaluationError_ = false;
+  Leaf value = evaluateOperator (tree->value, operands, ObjMap ());
+  const double *numericValue = boost::get<double> (&value);
+  if (!evaluationError_ && numericValue)
+    {
+      char buffer[64];
+      snprintf (buffer, sizeof (buffer), "%.17g", *numericValue);
+      for (const auto &branch : tree->branches)
+        destroy (branch);
+      tree->branches.clear ();
+      tree->value = buffer;
+    }
+  evaluationError_ = previousError;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+bool
+ValueLookupTree::validate (string &message) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Checks the tree before any events are processed, so that mistakes which
+  // would otherwise only show up as invalid values or errors in the event loop
+  // are reported right away. On failure, message describes the first problem
+  // found.
+  //////////////////////////////////////////////////////////////////////////////
+  bool isString;
+  if (!root_)
+    {
+      message = "failed to parse expression";
+      return false;
+    }
+  for (const auto &collection : inputCollectionIds_)
+    {
+      if (!anatools::isObjectCollection (collection))
+        {
+          message = "input collections contain an unknown or unsupported collection";
+          return false;
+        }
+    }
+  if (!validate_ (root_, isString, message))
+    return false;
+  if (isString)
+    {
+      message = "expression \"" + root_->value + "\" is a collection, not a number";
+      return false;
+    }
+  return true;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+bool
+ValueLookupTree::validate_ (const Node * const tree, bool &isString, string &message) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Recursively infers whether each node evaluates to a number or to a string,
+  // i.e., a collection name, and checks that each operator is given the kind
+  // of operands it expects and that each member exists in the dictionary of
+  // its collection.
+  //////////////////////////////////////////////////////////////////////////////
+  isString = false;
+  if (tree->slot >= 0)
+    return true;
+
+  double value;
+  if (!tree->branches.size ())
+    {
+      if (isnumber (tree->value, value))
+        return true;
+      if (isCollection (tree->value + "s"))
+        {
+          isString = true;
+          return true;
+        }
+      if (inputCollections_.size () != 1)
+        {
+          message = "cannot infer ownership of \"" + tree->value + "\"; use collection.member";
+          return false;
+        }
+      return validateMember (inputCollectionIds_.at (0), tree->value, message);
+    }
+
+  if (tree->value == ".")
+    {
+      CollectionId collection = anatools::getCollectionId (tree->branches.at (0)->value + "s");
+      if (!VEC_CONTAINS (inputCollectionIds_, collection))
+        {
+          message = "\"" + tree->branches.at (0)->value + "\" is not among the input collections";
+          return false;
+        }
+      return validateMember (collection, tree->branches.at (1)->value, message);
+    }
+
+  vector<bool> operandIsString;
+  for (const auto &branch : tree->branches)
+    {
+      bool branchIsString;
+      if (!validate_ (branch, branchIsString, message))
+        return false;
+      operandIsString.push_back (branchIsString);
+    }
+
+  auto stringOperator = stringOperators.find (tree->value);
+  if (stringOperator != stringOperators.end ())
+    {
+      if (stringOperator->second >= 0 && (int) tree->branches.size () != stringOperator->second)
+        {
+          message = "\"" + tree->value + "\" takes " + to_string (stringOperator->second) + " operand(s)";
+          return false;
+        }
+      for (unsigned i = 0; i < tree->branches.size (); i++)
+        {
+          if (!operandIsString.at (i))
+            {
+              message = "\"" + tree->value + "\" takes collections as operands, e.g., " + tree->value + " (muon, jet)";
+              return false;
+            }
+          if (!VEC_CONTAINS (inputCollectionIds_, anatools::getCollectionId (tree->branches.at (i)->value + "s")))
+            {
+              message = "\"" + tree->branches.at (i)->value + "\" in \"" + tree->value + "\" is not among the input collections";
+              return false;
+            }
+        }
+      return true;
+    }
+
+  if (!((tree->branches.size () == 1 && unaryOperators.count (tree->value))
+     || (tree->branches.size () == 2 && binaryOperators.count (tree->value))))
+    {
+      message = "unknown operator \"" + tree->value + "\" with " + to_string (tree->branches.size ()) + " operand(s)";
+      return false;
+    }
+  for (unsigned i = 0; i < tree->branches.size (); i++)
+    {
+      if (operandIsString.at (i))
+        {
+          message = "\"" + tree->value + "\" takes numbers as operands, but was given the collection \"" + tree->branches.at (i)->value + "\"";
+          return false;
+        }
+    }
+  return true;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+bool
+ValueLookupTree::validateMember (const CollectionId collection, const string &member, string &message) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // User and event variables are only known once their producers have run, so
+  // only the members of the other collections are checked, and only if the
+  // dictionary of the collection can be found.
+  //////////////////////////////////////////////////////////////////////////////
+  if (collection == COLLECTION_USERVARIABLES || collection == COLLECTION_EVENTVARIABLES)
+    return true;
+#ifdef ROOT6
+  const string &type = anatools::getCollectionType (collection);
+  if (!anatools::TypeWithDict::byName (type))
+    return true;
+  string memberType = anatools::getMemberType (type, member);
+  if (memberType == "")
+    {
+      message = "\"" + type + "\" has no accessible member \"" + member + "\"";
+      return false;
+    }
+  if (!numericTypes.count (memberType))
+    {
+      message = "member \"" + member + "\" of \"" + type + "\" has non-numeric type \"" + memberType + "\"";
+      return false;
+    }
+#endif
+  return true;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+void
+ValueLookupTree::resolveSlots (Node * const tree) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Recursively assigns a slot in the EventVariableTable to each node which
+  // refers to an event variable, either explicitly as eventvariable.name or as
+  // a bare name when the only input collection is eventvariables.
+  //////////////////////////////////////////////////////////////////////////////
+  if (!tree)
+    return;
+  if (tree->value == "." && tree->branches.size () == 2
+   && tree->branches.at (0)->value == "eventvariable"
+   && !tree->branches.at (1)->branches.size ())
+    {
+      tree->slot = EventVariableTable::getSlot (tree->branches.at (1)->value);
+      return;
+    }
+  if (!tree->branches.size ())
+    {
+      double value;
+      if (inputCollections_.size () == 1 && inputCollections_.at (0) == "eventvariables"
+       && !isnumber (tree->value, value)
+       && !isCollection (tree->value + "s")
+       && !(tree->parent && tree->parent->value == "."))
+        tree->slot = EventVariableTable::getSlot (tree->value);
+      return;
+    }
+  for (const auto &branch : tree->branches)
+    resolveSlots (branch);
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+void
+ValueLookupTree::resolveCollections ()
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Maps each input collection, and the collection of each member lookup in the
+  // tree, to its identifier once, so that no collection names need to be
+  // compared in the event loop. The members used by the kinematic operators,
+  // e.g., deltaR, are also registered in the MemberValueCache.
+  //////////////////////////////////////////////////////////////////////////////
+  inputCollectionIds_.clear ();
+  for (const auto &collection : inputCollections_)
+    inputCollectionIds_.push_back (anatools::getCollectionId (collection));
+  const char * const kinematicMembers[N_KINEMATIC_MEMBERS] = {"energy", "eta", "phi", "pt", "px", "py", "pz"};
+  for (unsigned i = 0; i < N_KINEMATIC_MEMBERS; i++)
+    kinematicMembers_[i] = MemberValueCache::getMemberId (kinematicMembers[i]);
+  resolveCollections_ (root_);
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+void
+ValueLookupTree::resolveCollections_ (Node * const tree) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Recursively assigns a collection and a member to each "." node of the form
+  // collection.member, e.g., muon.pt, which is left after pruneDots, and a
+  // member to each bare variable when there is a single input collection.
+  //////////////////////////////////////////////////////////////////////////////
+  if (!tree)
+    return;
+  if (tree->value == "." && tree->branches.size () == 2
+   && !tree->branches.at (0)->branches.size ()
+   && !tree->branches.at (1)->branches.size ())
+    {
+      CollectionId collection = anatools::getCollectionId (tree->branches.at (0)->value + "s");
+      if (anatools::isObjectCollection (collection))
+        {
+          tree->collection = collection;
+          tree->member = MemberValueCache::getMemberId (tree->branches.at (1)->value);
+        }
+    }
+  if (!tree->branches.size ())
+    {
+      double value;
+      if (inputCollectionIds_.size () == 1
+       && !isnumber (tree->value, value)
+       && !isCollection (tree->value + "s")
+       && !(tree->parent && tree->parent->value == "."))
+        tree->member = MemberValueCache::getMemberId (tree->value);
+    }
+  for (const auto &branch : tree->branches)
+    resolveCollections_ (branch);
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+void
+ValueLookupTree::findSubexpressions ()
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // When a collection is given more than once, e.g., for muon-muon pairs, the
+  // value of a subtree depends on which objects valueLookup has already
+  // iterated over, so it cannot be shared with other trees.
+  //////////////////////////////////////////////////////////////////////////////
+  subexpressions_.clear ();
+  if (adjacent_find (inputCollections_.begin (), inputCollections_.end ()) != inputCollections_.end ())
+    return;
+  if (root_)
+    findSubexpressions_ (root_, anatools::concatenateInputCollection (inputCollections_));
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+string
+ValueLookupTree::findSubexpressions_ (Node * const tree, const string &inputLabel)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Recursively builds the canonical form of each subtree, e.g.,
+  // "<(abs(eta),2.5)", and records those which are not simply an event
+  // variable or the member of an object, which are already read from tables.
+  // Returns the canonical form of the given subtree.
+  //////////////////////////////////////////////////////////////////////////////
+  if (!tree->branches.size ())
+    return tree->value;
+  string expression = tree->value + "(";
+  for (auto branch = tree->branches.begin (); branch != tree->branches.end (); branch++)
+    expression += (branch != tree->branches.begin () ? "," : "") + findSubexpressions_ (*branch, inputLabel);
+  expression += ")";
+  if (tree->slot < 0 && tree->collection == COLLECTION_INVALID)
+    subexpressions_.emplace_back (tree, inputLabel + ":" + expression);
+  return expression;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+void
+ValueLookupTree::registerSubexpressions (SubexpressionCache &cache)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Registers the subtrees in the cache of the module whose collections the
+  // tree is given, the first time it is given them, so that the use counts
+  // only include the trees of that module.
+  //////////////////////////////////////////////////////////////////////////////
+  for (const auto &subexpression : subexpressions_)
+    subexpression.first->expression = cache.getExpressionId (subexpression.second);
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+void
+ValueLookupTree::initializeColumns ()
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Trees over a single object collection which use only members of that
+  // collection, event variables, numbers, and the operators supported by
+  // applyColumnOperator are evaluated one column at a time over all the
+  // objects, instead of one object at a time. Enough scratch columns are
+  // allocated here for the deepest part of the tree.
+  //////////////////////////////////////////////////////////////////////////////
+  columnar_ = false;
+  if (!root_ || inputCollectionIds_.size () != 1)
+    return;
+  CollectionId collection = inputCollectionIds_.at (0);
+  if (!anatools::isObjectCollection (collection)
+   || collection == COLLECTION_USERVARIABLES
+   || collection == COLLECTION_EVENTVARIABLES)
+    return;
+  columnar_ = isColumnar (root_);
+  if (columnar_)
+    columns_.resize (columnDepth (root_));
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+void
+ValueLookupTree::setColumnarEvaluation (const bool columnar)
+{
+  if (columnar)
+    initializeColumns ();
+  else
+    columnar_ = false;
+  values_.clear ();
+}
+
+bool
+ValueLookupTree::columnarEvaluation () const
+{
+  return columnar_;
+}
+
+bool
+ValueLookupTree::isColumnar (const Node * const tree) const
+{
+  if (tree->slot >= 0)
+    return true;
+  if (tree->member >= 0)
+    return (!tree->branches.size () || tree->collection == inputCollectionIds_.at (0));
+  if (!tree->branches.size ())
+    {
+      double value;
+      return isnumber (tree->value, value);
+    }
+  if (!(tree->branches.size () == 1 && unaryColumnOperators.count (tree->value))
+   && !(tree->branches.size () == 2 && binaryColumnOperators.count (tree->value)))
+    return false;
+  for (const auto &branch : tree->branches)
+    {
+      if (!isColumnar (branch))
+        return false;
+    }
+  return true;
+}
+
+unsigned
+ValueLookupTree::columnDepth (const Node * const tree) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // The i-th branch of a node is evaluated into the i-th column above the one
+  // holding the node itself, and the operator is applied in place.
+  //////////////////////////////////////////////////////////////////////////////
+  unsigned depth = 1;
+  if (tree->slot < 0 && tree->member < 0)
+    {
+      for (unsigned i = 0; i < tree->branches.size (); i++)
+        depth = max (depth, i + columnDepth (tree->branches.at (i)));
+    }
+  return depth;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
 void
 ValueLookupTree::pruneDots_ (Node * const tree) const
 {
@@ -493,6 +960,10 @@ ValueLookupTree::insert_ (const string &cut, Node * const parent) const
   //////////////////////////////////////////////////////////////////////////////
   Node *tree = new Node;
   tree->parent = parent;
+  tree->slot = -1;
+  tree->collection = COLLECTION_INVALID;
+  tree->member = -1;
+  tree->expression = -1;
   if (!(insertBinaryInfixOperator  (cut,  tree,  {","})                           ||
         insertBinaryInfixOperator  (cut,  tree,  {"||", "|"})                     ||
         insertBinaryInfixOperator  (cut,  tree,  {"&&", "&"})                     ||
@@ -563,17 +1034,53 @@ ValueLookupTree::evaluate_ (const Node * const tree, const ObjMap &objs)
     return INVALID_VALUE;
   //////////////////////////////////////////////////////////////////////////////
 
+  //////////////////////////////////////////////////////////////////////////////
+  // The node is an event variable which was resolved to a slot when the tree
+  // was built. Read its value directly from the table.
+  //////////////////////////////////////////////////////////////////////////////
+  if (tree->slot >= 0)
+    return handles_->eventvariableTable.get (tree->slot);
+  //////////////////////////////////////////////////////////////////////////////
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The node is a member of an object, e.g., muon.pt, whose collection was
+  // resolved when the tree was built. Look up the value directly, without
+  // evaluating the daughters.
+  //////////////////////////////////////////////////////////////////////////////
+  if (tree->collection != COLLECTION_INVALID)
+    return valueLookup (tree->collection, objs, tree->branches.at (1)->value, true, tree->member);
+  //////////////////////////////////////////////////////////////////////////////
+
   //////////////////////////////////////////////////////////////////////////////
   // The node is not a leaf and its value is an operator. First, evaluate its
   // daughters, then return the result of the operator acting on the daughters.
   //////////////////////////////////////////////////////////////////////////////
   if (tree->branches.size ())
     {
+      ////////////////////////////////////////////////////////////////////////////
+      // If the same subtree appears elsewhere, with the same input collections,
+      // its value for this combination of objects may already be cached. A
+      // value is only cached if there was no error while evaluating it.
+      ////////////////////////////////////////////////////////////////////////////
+      bool isShared = handles_->subexpressionCache.isShared (tree->expression);
+      double cachedValue;
+      if (isShared && handles_->subexpressionCache.find (tree->expression, combination_, cachedValue))
+        return cachedValue;
+      bool previousError = evaluationError_;
+      evaluationError_ = false;
+      ////////////////////////////////////////////////////////////////////////////
+
       vector<Leaf> operands;
       for (const auto &branch : tree->branches)
         operands.push_back (evaluate_ (branch, objs));
       if (verbose_) cout << "    Debug evalute 0 (no branches) for tree->value = " << tree->value << endl;
-      return evaluateOperator (tree->value, operands, objs);
+      Leaf value = evaluateOperator (tree->value, operands, objs);
+
+      const double *numericValue = boost::get<double> (&value);
+      if (isShared && !evaluationError_ && numericValue)
+        handles_->subexpressionCache.insert (tree->expression, combination_, *numericValue);
+      evaluationError_ = evaluationError_ || previousError;
+      return value;
     }
   //////////////////////////////////////////////////////////////////////////////
 
@@ -602,7 +1109,7 @@ ValueLookupTree::evaluate_ (const Node * const tree, const ObjMap &objs)
                                << ", calling valueLookup for value: " << tree->value
                                << ", collection: " << inputCollections_.at (0)
                                << endl;
-            return valueLookup (inputCollections_.at (0), objs, tree->value);
+            return valueLookup (inputCollectionIds_.at (0), objs, tree->value, true, tree->member);
           }
           clog << "ERROR: cannot infer ownership of \"" << tree->value << "\"" << endl;
           evaluationError_ = true;
@@ -612,6 +1119,123 @@ ValueLookupTree::evaluate_ (const Node * const tree, const ObjMap &objs)
   //////////////////////////////////////////////////////////////////////////////
 }
 
+void
+ValueLookupTree::evaluateColumns ()
+{
+  unsigned n = nCombinations_.at (0);
+  evaluateColumn_ (root_, 0, n);
+  values_.assign (columns_.at (0).begin (), columns_.at (0).begin () + n);
+}
+
+void
+ValueLookupTree::evaluateColumn_ (const Node * const tree, const unsigned top, const unsigned n)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Fills the column at the given position with the value of the subtree for
+  // each of the n objects, giving the same values as evaluate_.
+  //////////////////////////////////////////////////////////////////////////////
+  vector<double> &column = columns_.at (top);
+  column.resize (n);
+  double *a = column.data (), value;
+  if (tree->slot >= 0)
+    fill (a, a + n, handles_->eventvariableTable.get (tree->slot));
+  else if (tree->member >= 0)
+    {
+      CollectionId collection = inputCollectionIds_.at (0);
+      const string &variable = (tree->branches.size () ? tree->branches.at (1)->value : tree->value);
+      for (unsigned i = 0; i < n; i++)
+        {
+          try
+            {
+              a[i] = getMemberValue (collection, i, getObject (collection, i), variable, tree->member);
+            }
+          catch (...)
+            {
+              a[i] = INVALID_VALUE;
+            }
+        }
+    }
+  else if (!tree->branches.size () && isnumber (tree->value, value))
+    fill (a, a + n, value);
+  else
+    {
+      for (unsigned i = 0; i < tree->branches.size (); i++)
+        evaluateColumn_ (tree->branches.at (i), top + i, n);
+      applyColumnOperator (tree->value, a, (tree->branches.size () > 1 ? columns_.at (top + 1).data () : NULL), n);
+    }
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+void
+ValueLookupTree::applyColumnOperator (const string &op, double * const a, const double * const b, const unsigned n) const
+{
+  if (!b)
+    {
+      if (op == "+")
+        UNARY_COLUMN_OPERATOR(+a[i])
+      else if (op == "-")
+        UNARY_COLUMN_OPERATOR(-a[i])
+      else if (op == "!")
+        UNARY_COLUMN_OPERATOR(!a[i])
+      else if (op == "abs" || op == "fabs")
+        UNARY_COLUMN_OPERATOR(fabs (a[i]))
+      else if (op == "sqrt")
+        UNARY_COLUMN_OPERATOR(sqrt (a[i]))
+      else if (op == "exp")
+        UNARY_COLUMN_OPERATOR(exp (a[i]))
+      else if (op == "log")
+        UNARY_COLUMN_OPERATOR(log (a[i]))
+      else if (op == "log10")
+        UNARY_COLUMN_OPERATOR(log10 (a[i]))
+      else if (op == "sin")
+        UNARY_COLUMN_OPERATOR(sin (a[i]))
+      else if (op == "cos")
+        UNARY_COLUMN_OPERATOR(cos (a[i]))
+      else if (op == "tan")
+        UNARY_COLUMN_OPERATOR(tan (a[i]))
+      else if (op == "atan")
+        UNARY_COLUMN_OPERATOR(atan (a[i]))
+      return;
+    }
+
+  if (op == "||" || op == "|")
+    BINARY_COLUMN_OPERATOR(a[i] || b[i])
+  else if (op == "&&" || op == "&")
+    BINARY_COLUMN_OPERATOR(a[i] && b[i])
+  else if (op == "==" || op == "=")
+    BINARY_COLUMN_OPERATOR(a[i] == b[i])
+  else if (op == "!=")
+    BINARY_COLUMN_OPERATOR(a[i] != b[i])
+  else if (op == "<")
+    BINARY_COLUMN_OPERATOR(a[i] < b[i])
+  else if (op == "<=")
+    BINARY_COLUMN_OPERATOR(a[i] <= b[i])
+  else if (op == ">")
+    BINARY_COLUMN_OPERATOR(a[i] > b[i])
+  else if (op == ">=")
+    BINARY_COLUMN_OPERATOR(a[i] >= b[i])
+  else if (op == "+")
+    BINARY_COLUMN_OPERATOR(a[i] + b[i])
+  else if (op == "-")
+    BINARY_COLUMN_OPERATOR(a[i] - b[i])
+  else if (op == "*")
+    BINARY_COLUMN_OPERATOR(a[i] * b[i])
+  else if (op == "/")
+    BINARY_COLUMN_OPERATOR(a[i] / b[i])
+  else if (op == "atan2")
+    BINARY_COLUMN_OPERATOR(atan2 (a[i], b[i]))
+  else if (op == "pow")
+    BINARY_COLUMN_OPERATOR(pow (a[i], b[i]))
+  else if (op == "hypot")
+    BINARY_COLUMN_OPERATOR(hypot (a[i], b[i]))
+  else if (op == "fmax" || op == "max")
+    BINARY_COLUMN_OPERATOR(fmax (a[i], b[i]))
+  else if (op == "fmin" || op == "min")
+    BINARY_COLUMN_OPERATOR(fmin (a[i], b[i]))
+  else if (op == "dPhi")
+    BINARY_COLUMN_OPERATOR(deltaPhi (a[i], b[i]))
+}
+
 Leaf
 ValueLookupTree::evaluateOperator (const string &op, const vector<Leaf> &operands, const ObjMap &objs)
 {
@@ -762,8 +1386,8 @@ ValueLookupTree::evaluateOperator (const string &op, const vector<Leaf> &operand
       else if (op == "abs" || op == "fabs")
         return (fabs (boost::get<double> (operands.at (0))));
       else if (op == "deltaPhi")
-        return deltaPhi (valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "phi"),
-                         valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "phi"));
+        return deltaPhi (valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "phi", true, kinematicMembers_[KINEMATIC_PHI]),
+                         valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "phi", true, kinematicMembers_[KINEMATIC_PHI]));
       else if (op == "dPhi")
         return deltaPhi (boost::get<double> (operands.at (0)), boost::get<double> (operands.at (1)));
       else if (op == "normalizedPhi")
@@ -772,10 +1396,10 @@ ValueLookupTree::evaluateOperator (const string &op, const vector<Leaf> &operand
         {
           double px0, px1, py0, py1, phi;
 
-          px0 = valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "px");
-          px1 = valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "px");
-          py0 = valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "py");
-          py1 = valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "py");
+          px0 = valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "px", true, kinematicMembers_[KINEMATIC_PX]);
+          px1 = valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "px", true, kinematicMembers_[KINEMATIC_PX]);
+          py0 = valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "py", true, kinematicMembers_[KINEMATIC_PY]);
+          py1 = valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "py", true, kinematicMembers_[KINEMATIC_PY]);
 
           phi = acos ((px0 + px1) / hypot (px0 + px1, py0 + py1));
           if ((py0 + py1) < 0.0)
@@ -787,10 +1411,10 @@ ValueLookupTree::evaluateOperator (const string &op, const vector<Leaf> &operand
         {
           double eta0, phi0, eta1, phi1;
 
-          eta0 = valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "eta");
-          phi0 = valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "phi", false);
-          eta1 = valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "eta");
-          phi1 = valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "phi", false);
+          eta0 = valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "eta", true, kinematicMembers_[KINEMATIC_ETA]);
+          phi0 = valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "phi", false, kinematicMembers_[KINEMATIC_PHI]);
+          eta1 = valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "eta", true, kinematicMembers_[KINEMATIC_ETA]);
+          phi1 = valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "phi", false, kinematicMembers_[KINEMATIC_PHI]);
 
           return deltaR (eta0, phi0, eta1, phi1);
         }
@@ -800,20 +1424,20 @@ ValueLookupTree::evaluateOperator (const string &op, const vector<Leaf> &operand
 
           for (const auto &operand : operands)
             {
-              energy += valueLookup (boost::get<string> (operand) + "s", objs, "energy");
-              px += valueLookup (boost::get<string> (operand) + "s", objs, "px", false);
-              py += valueLookup (boost::get<string> (operand) + "s", objs, "py", false);
-              pz += valueLookup (boost::get<string> (operand) + "s", objs, "pz", false);
+              energy += valueLookup (boost::get<string> (operand) + "s", objs, "energy", true, kinematicMembers_[KINEMATIC_ENERGY]);
+              px += valueLookup (boost::get<string> (operand) + "s", objs, "px", false, kinematicMembers_[KINEMATIC_PX]);
+              py += valueLookup (boost::get<string> (operand) + "s", objs, "py", false, kinematicMembers_[KINEMATIC_PY]);
+              pz += valueLookup (boost::get<string> (operand) + "s", objs, "pz", false, kinematicMembers_[KINEMATIC_PZ]);
             }
 
           return sqrt (energy * energy - px * px - py * py - pz * pz);
         }
       else if (op == "transMass")
         {
-          double pt0 = valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "pt", false),
-                 pt1 = valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "pt", false),
-                 dPhi = deltaPhi (valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "phi"),
-                                  valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "phi"));
+          double pt0 = valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "pt", false, kinematicMembers_[KINEMATIC_PT]),
+                 pt1 = valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "pt", false, kinematicMembers_[KINEMATIC_PT]),
+                 dPhi = deltaPhi (valueLookup (boost::get<string> (operands.at (0)) + "s", objs, "phi", true, kinematicMembers_[KINEMATIC_PHI]),
+                                  valueLookup (boost::get<string> (operands.at (1)) + "s", objs, "phi", true, kinematicMembers_[KINEMATIC_PHI]));
 
           return sqrt (2.0 * pt0 * pt1 * (1 - cos (dPhi)));
         }
@@ -823,8 +1447,8 @@ ValueLookupTree::evaluateOperator (const string &op, const vector<Leaf> &operand
 
           for (const auto &operand : operands)
             {
-              px += valueLookup (boost::get<string> (operand) + "s", objs, "px");
-              py += valueLookup (boost::get<string> (operand) + "s", objs, "py", false);
+              px += valueLookup (boost::get<string> (operand) + "s", objs, "px", true, kinematicMembers_[KINEMATIC_PX]);
+              py += valueLookup (boost::get<string> (operand) + "s", objs, "py", false, kinematicMembers_[KINEMATIC_PY]);
             }
           return hypot(px,py);
         }
@@ -849,185 +1473,74 @@ ValueLookupTree::evaluateOperator (const string &op, const vector<Leaf> &operand
 }
 
 void *
-ValueLookupTree::getObject (const string &name, const unsigned i)
-{
-  if (EQ_VALID(name,beamspots))
-    return ((void *) &(*handles_->beamspots));
-  else if (EQ_VALID(name,bxlumis))
-    return ((void *) &handles_->bxlumis->at (i));
-  else if (EQ_VALID(name,cschits))
-    return ((void *) &handles_->cschits->at (i));
-  else if (EQ_VALID(name,cscsegs))
-    return ((void *) &handles_->cscsegs->at (i));
-  else if (EQ_VALID(name,dtsegs))
-    return ((void *) &handles_->dtsegs->at (i));
-  else if (EQ_VALID(name,electrons))
-    return ((void *) &handles_->electrons->at (i));
-  else if (EQ_VALID(name,events))
-    return ((void *) &handles_->events->at (i));
-  else if (EQ_VALID(name,genjets))
-    return ((void *) &handles_->genjets->at (i));
-  else if (EQ_VALID(name,generatorweights))
-    return ((void *) &(*handles_->generatorweights));
-  else if (EQ_VALID(name,jets))
-    return ((void *) &handles_->jets->at (i));
-  else if (EQ_VALID(name,bjets))
-    return ((void *) &handles_->bjets->at (i));
-  else if (EQ_VALID(name,basicjets))
-    return ((void *) &handles_->basicjets->at (i));
-  else if (EQ_VALID(name,mcparticles))
-    return ((void *) &handles_->mcparticles->at (i));
-  else if (EQ_VALID(name,mets))
-    return ((void *) &handles_->mets->at (i));
-  else if (EQ_VALID(name,muons))
-    return ((void *) &handles_->muons->at (i));
-  else if (EQ_VALID(name,photons))
-    return ((void *) &handles_->photons->at (i));
-  else if (EQ_VALID(name,primaryvertexs))
-    return ((void *) &handles_->primaryvertexs->at (i));
-  else if (EQ_VALID(name,rpchits))
-    return ((void *) &handles_->rpchits->at (i));
-  else if (EQ_VALID(name,superclusters))
-    return ((void *) &handles_->superclusters->at (i));
-  else if (EQ_VALID(name,taus))
-    return ((void *) &handles_->taus->at (i));
-  else if (EQ_VALID(name,tracks))
-    return ((void *) &handles_->tracks->at (i));
-  else if (EQ_VALID(name,secondaryTracks))
-    return ((void *) &handles_->secondaryTracks->at (i));
-  else if (EQ_VALID(name,pileupinfos))
-    return ((void *) &handles_->pileupinfos->at (i));
-  else if (EQ_VALID(name,uservariables))
-    {
-      //!!!
-      osu::Uservariable *obj = new osu::Uservariable ();
-      for (const auto &handle : handles_->uservariables)
-        obj->insert (handle->begin (), handle->end ());
-      uservariablesToDelete_.push_back (obj);
-      return obj;
-    }
-  else if (EQ_VALID(name,eventvariables))
+ValueLookupTree::getObject (const CollectionId collection, const unsigned i)
+{
+  switch (collection)
     {
-      //!!!
-      osu::Eventvariable *obj = new osu::Eventvariable ();
-      for (const auto &handle : handles_->eventvariables)
-        obj->insert (handle->begin (), handle->end ());
-      eventvariablesToDelete_.push_back (obj);
-      return obj;
+      case COLLECTION_BEAMSPOTS:        return ((void *) &(*handles_->beamspots));
+      case COLLECTION_BXLUMIS:          return ((void *) &handles_->bxlumis->at (i));
+      case COLLECTION_CSCHITS:          return ((void *) &handles_->cschits->at (i));
+      case COLLECTION_CSCSEGS:          return ((void *) &handles_->cscsegs->at (i));
+      case COLLECTION_DTSEGS:           return ((void *) &handles_->dtsegs->at (i));
+      case COLLECTION_ELECTRONS:        return ((void *) &handles_->electrons->at (i));
+      case COLLECTION_EVENTS:           return ((void *) &handles_->events->at (i));
+      case COLLECTION_GENJETS:          return ((void *) &handles_->genjets->at (i));
+      case COLLECTION_GENERATORWEIGHTS: return ((void *) &(*handles_->generatorweights));
+      case COLLECTION_BASICJETS:        return ((void *) &handles_->basicjets->at (i));
+      case COLLECTION_JETS:             return ((void *) &handles_->jets->at (i));
+      case COLLECTION_BJETS:            return ((void *) &handles_->bjets->at (i));
+      case COLLECTION_MCPARTICLES:      return ((void *) &handles_->mcparticles->at (i));
+      case COLLECTION_METS:             return ((void *) &handles_->mets->at (i));
+      case COLLECTION_MUONS:            return ((void *) &handles_->muons->at (i));
+      case COLLECTION_PHOTONS:          return ((void *) &handles_->photons->at (i));
+      case COLLECTION_PRIMARYVERTEXS:   return ((void *) &handles_->primaryvertexs->at (i));
+      case COLLECTION_RPCHITS:          return ((void *) &handles_->rpchits->at (i));
+      case COLLECTION_SUPERCLUSTERS:    return ((void *) &handles_->superclusters->at (i));
+      case COLLECTION_TAUS:             return ((void *) &handles_->taus->at (i));
+      case COLLECTION_TRACKS:           return ((void *) &handles_->tracks->at (i));
+      case COLLECTION_SECONDARYTRACKS:  return ((void *) &handles_->secondaryTracks->at (i));
+      case COLLECTION_PILEUPINFOS:      return ((void *) &handles_->pileupinfos->at (i));
+      case COLLECTION_USERVARIABLES:    return ((void *) &handles_->uservariableTable);
+      case COLLECTION_EVENTVARIABLES:   return ((void *) &handles_->eventvariableTable);
+      default:                          return NULL;
     }
-  return NULL;
 }
 
-string
-ValueLookupTree::getCollectionType (const string &name) const
-{
-  if (EQ_VALID(name,beamspots))
-    return "osu::Beamspot";
-  else if (EQ_VALID(name,bxlumis))
-    return "osu::Bxlumi";
-  else if (EQ_VALID(name,cschits))
-    return "osu::Cschit";
-  else if (EQ_VALID(name,cscsegs))
-    return "osu::Cscseg";
-  else if (EQ_VALID(name,dtsegs))
-    return "osu::Dtseg";
-  else if (EQ_VALID(name,electrons))
-    return "osu::Electron";
-  else if (EQ_VALID(name,events))
-    return "osu::Event";
-  else if (EQ_VALID(name,genjets))
-    return "osu::Genjet";
-  else if (EQ_VALID(name,generatorweights))
-    return "osu::Generatorweight";
-  else if (EQ_VALID(name,jets))
-    return "osu::Jet";
-  else if (EQ_VALID(name,bjets))
-    return "osu::Bjet";
-  else if (EQ_VALID(name,basicjets))
-    return "osu::Basicjet";
-  else if (EQ_VALID(name,mcparticles))
-    return "osu::Mcparticle";
-  else if (EQ_VALID(name,mets))
-    return "osu::Met";
-  else if (EQ_VALID(name,muons))
-    return "osu::Muon";
-  else if (EQ_VALID(name,photons))
-    return "osu::Photon";
-  else if (EQ_VALID(name,primaryvertexs))
-    return "osu::Primaryvertex";
-  else if (EQ_VALID(name,rpchits))
-    return "osu::Rpchit";
-  else if (EQ_VALID(name,superclusters))
-    return "osu::Supercluster";
-  else if (EQ_VALID(name,taus))
-    return "osu::Tau";
-  else if (EQ_VALID(name,tracks))
-    return "osu::Track";
-  else if (EQ_VALID(name,secondaryTracks))
-    return "osu::SecondaryTrack";
-  else if (EQ_VALID(name,pileupinfos))
-    return "osu::PileUpInfo";
-  else if (EQ_VALID(name,uservariables))
-    return "osu::Uservariable";
-  else if (EQ_VALID(name,eventvariables))
-    return "osu::Eventvariable";
-  return "";
+edm::ProductID
+ValueLookupTree::getProductId (const CollectionId collection) const
+{
+  switch (collection)
+    {
+      case COLLECTION_BEAMSPOTS:        return handles_->beamspots.id ();
+      case COLLECTION_BXLUMIS:          return handles_->bxlumis.id ();
+      case COLLECTION_CSCHITS:          return handles_->cschits.id ();
+      case COLLECTION_CSCSEGS:          return handles_->cscsegs.id ();
+      case COLLECTION_DTSEGS:           return handles_->dtsegs.id ();
+      case COLLECTION_ELECTRONS:        return handles_->electrons.id ();
+      case COLLECTION_EVENTS:           return handles_->events.id ();
+      case COLLECTION_GENJETS:          return handles_->genjets.id ();
+      case COLLECTION_BASICJETS:        return handles_->basicjets.id ();
+      case COLLECTION_JETS:             return handles_->jets.id ();
+      case COLLECTION_BJETS:            return handles_->bjets.id ();
+      case COLLECTION_MCPARTICLES:      return handles_->mcparticles.id ();
+      case COLLECTION_METS:             return handles_->mets.id ();
+      case COLLECTION_MUONS:            return handles_->muons.id ();
+      case COLLECTION_PHOTONS:          return handles_->photons.id ();
+      case COLLECTION_PRIMARYVERTEXS:   return handles_->primaryvertexs.id ();
+      case COLLECTION_RPCHITS:          return handles_->rpchits.id ();
+      case COLLECTION_SUPERCLUSTERS:    return handles_->superclusters.id ();
+      case COLLECTION_TAUS:             return handles_->taus.id ();
+      case COLLECTION_TRACKS:           return handles_->tracks.id ();
+      case COLLECTION_SECONDARYTRACKS:  return handles_->secondaryTracks.id ();
+      case COLLECTION_PILEUPINFOS:      return handles_->pileupinfos.id ();
+      default:                          return edm::ProductID ();
+    }
 }
 
 bool
 ValueLookupTree::isCollection (const string &name) const
 {
-  if (EQ_VALID(name,beamspots))
-    return true;
-  else if (EQ_VALID(name,bxlumis))
-    return true;
-  else if (EQ_VALID(name,cschits))
-    return true;
-  else if (EQ_VALID(name,cscsegs))
-    return true;
-  else if (EQ_VALID(name,dtsegs))
-    return true;
-  else if (EQ_VALID(name,electrons))
-    return true;
-  else if (EQ_VALID(name,events))
-    return true;
-  else if (EQ_VALID(name,genjets))
-    return true;
-  else if (EQ_VALID(name,generatorweights))
-    return true;
-  else if (EQ_VALID(name,jets))
-    return true;
-  else if (EQ_VALID(name,bjets))
-    return true;
-  else if (EQ_VALID(name,basicjets))
-    return true;
-  else if (EQ_VALID(name,mcparticles))
-    return true;
-  else if (EQ_VALID(name,mets))
-    return true;
-  else if (EQ_VALID(name,muons))
-    return true;
-  else if (EQ_VALID(name,photons))
-    return true;
-  else if (EQ_VALID(name,primaryvertexs))
-    return true;
-  else if (EQ_VALID(name,rpchits))
-    return true;
-  else if (EQ_VALID(name,superclusters))
-    return true;
-  else if (EQ_VALID(name,taus))
-    return true;
-  else if (EQ_VALID(name,pileupinfos))
-    return true;
-  else if (EQ_VALID(name,tracks))
-    return true;
-  else if (EQ_VALID(name,secondaryTracks))
-    return true;
-  else if (EQ_VALID(name,uservariables))
-    return true;
-  else if (EQ_VALID(name,eventvariables))
-    return true;
-  return false;
+  return anatools::isObjectCollection (anatools::getCollectionId (name));
 }
 
 bool
@@ -1346,28 +1859,129 @@ ValueLookupTree::insertParentheses (const string &s, Node * const tree) const
 }
 
 double
-ValueLookupTree::valueLookup (const string &collection, const ObjMap &objs, const string &variable, const bool iterateObj)
+ValueLookupTree::valueLookup (const string &collection, const ObjMap &objs, const string &variable, const bool iterateObj, const int member)
 {
-  if (!objIterators_.count (collection))
+  CollectionId collectionId = anatools::getCollectionId (collection);
+  if (collectionId == COLLECTION_INVALID)
+    return INVALID_VALUE;
+  return valueLookup (collectionId, objs, variable, iterateObj, member);
+}
+
+double
+ValueLookupTree::valueLookup (const CollectionId collection, const ObjMap &objs, const string &variable, const bool iterateObj, const int member)
+{
+  if (!objIteratorsSet_.test (collection))
     {
-      auto range = objs.equal_range (collection);
+      const string &name = anatools::getCollectionName (collection);
+      auto range = objs.equal_range (name);
       objIterators_[collection] = range.first;
-      shouldIterate_[collection] = (objs.count (collection) > 1);
+      shouldIterate_[collection] = (objs.count (name) > 1);
+      objIteratorsSet_.set (collection);
     }
-  else if (shouldIterate_.at (collection) && iterateObj)
-    objIterators_.at (collection)++;
-  void *obj = objIterators_.at (collection)->second.addr;
+  else if (shouldIterate_[collection] && iterateObj)
+    objIterators_[collection]++;
+  void *obj = objIterators_[collection]->second.addr;
 
   try
     {
-      if (collection == "uservariables")
-        return 1; // FIXME
-      if (collection == "eventvariables")
-        return (((EventVariableProducerPayload *) obj)->at (variable));
-      return anatools::getMember (getCollectionType (collection), obj, variable, &functionLookupTable_);
+      if (collection == COLLECTION_USERVARIABLES)
+        return userVariableLookup (objs, variable);
+      if (collection == COLLECTION_EVENTVARIABLES)
+        return (((EventVariableTable *) obj)->get (variable));
+
+      //////////////////////////////////////////////////////////////////////////
+      // Values found with getMember are cached for the rest of the event, so
+      // that other trees using the same member of the same object do not
+      // repeat the lookup. Only members whose identifiers were resolved when
+      // the tree was built are cached, so that the member registry is never
+      // read in the event loop.
+      //////////////////////////////////////////////////////////////////////////
+      return getMemberValue (collection, objIterators_[collection]->second.localIndex, obj, variable, member);
+      //////////////////////////////////////////////////////////////////////////
     }
   catch (...)
     {
       return INVALID_VALUE;
     }
 }
+
+double
+ValueLookupTree::getMemberValue (const CollectionId collection, const unsigned index, void * const obj, const string &variable, const int member)
+{
+  if (member < 0)
+    return anatools::getMember (anatools::getCollectionType (collection), obj, variable, &functionLookupTable_);
+  double value;
+  if (!handles_->memberValueCache.find (collection, index, member, value))
+    {
+      value = anatools::getMember (anatools::getCollectionType (collection), obj, variable, &functionLookupTable_);
+      handles_->memberValueCache.insert (collection, index, member, value);
+    }
+  return value;
+}
+
+double
+ValueLookupTree::userVariableLookup (const ObjMap &objs, const string &variable) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // User variables are associated with objects by their indices, so the value
+  // is read from the table at the local indices of the objects of the
+  // associated types in the current combination. If the combination does not
+  // contain the right number of objects of each type, the value is invalid.
+  //////////////////////////////////////////////////////////////////////////////
+  const UserVariableTable &table = handles_->uservariableTable;
+  const vector<string> *types = table.getTypes (variable);
+  if (!types)
+    return INVALID_VALUE;
+  if (types->empty ())
+    return table.get (variable, 0);
+  if (!userVariableCollectionsMatch (variable))
+    return INVALID_VALUE;
+  if (types->size () == 1)
+    {
+      auto range = objs.equal_range (types->at (0) + "s");
+      if (range.first == range.second || next (range.first) != range.second)
+        return INVALID_VALUE;
+      return table.get (variable, (int) range.first->second.localIndex);
+    }
+
+  vector<int> indices;
+  for (auto type = types->begin (); type != types->end (); )
+    {
+      auto last = upper_bound (type, types->end (), *type);
+      auto range = objs.equal_range (*type + "s");
+      unsigned first = indices.size ();
+      for (auto object = range.first; object != range.second; object++)
+        indices.push_back (object->second.localIndex);
+      if (indices.size () - first != (unsigned) (last - type))
+        return INVALID_VALUE;
+      sort (indices.begin () + first, indices.end ());
+      type = last;
+    }
+  return table.get (variable, indices);
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+bool
+ValueLookupTree::userVariableCollectionsMatch (const string &variable) const
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // The indices of the associated objects are taken in the collections read by
+  // the producer of the variable, so they can only be used if this tree reads
+  // the same collections. This is not the case, e.g., if the tree reads the
+  // collections filtered by an ObjectSelector. Producers which do not record
+  // the collections are trusted.
+  //////////////////////////////////////////////////////////////////////////////
+  const UserVariableTable &table = handles_->uservariableTable;
+  const vector<string> &types = *table.getTypes (variable);
+  const vector<edm::ProductID> &collections = *table.getCollections (variable);
+  for (unsigned i = 0; i < types.size (); i++)
+    {
+      if (!collections.at (i).isValid () || collections.at (i) == getProductId (anatools::getCollectionId (types.at (i) + "s")))
+        continue;
+      if (mismatchedUserVariables_.insert (variable).second)
+        clog << "WARNING: \"" << variable << "\" is associated with " << types.at (i) << "s from a different collection than the one being read. Its value is invalid." << endl;
+      return false;
+    }
+  return true;
+  //////////////////////////////////////////////////////////////////////////////
+}
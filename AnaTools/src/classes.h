@@ -30,6 +30,9 @@ namespace {
      edm::Wrapper<EventVariableProducerPayload> EventVariableProducerPayloadDummy2;
      edm::Wrapper<vector<EventVariableProducerPayload> > EventVariableProducerPayloadDummy3;
 
+     EventVariableRecord EventVariableRecordDummy0;
+     edm::Wrapper<EventVariableRecord> EventVariableRecordDummy1;
+
      map<string, vector<vector<bool> > > mapcharbooldummy0;
      edm::Wrapper<map<string, vector<vector<bool> > > > mapcharbooldummy1;
      vector<map<string, vector<vector<bool> > > > mapcharbooldummy2;
@@ -41,6 +44,7 @@ namespace {
      edm::Wrapper<vector<vector<bool> > > booldummy3;
 
      pair<const string, vector<UserVariable> > uservariabledummy0;
+     map<string, edm::ProductID> uservariabledummy1;
      pair<const string, double > eventvariabledummy0;
    };
 }
@@ -0,0 +1,402 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <cmath>
+
+#include "DataFormats/Provenance/interface/Provenance.h"
+#include "FWCore/FWLite/interface/FWLiteEnabler.h"
+
+#include "OSUT3Analysis/AnaTools/interface/CommonUtils.h"
+#include "OSUT3Analysis/AnaTools/interface/ValueLookupTree.h"
+
+using namespace std;
+
+// Tracks are benchmarked only if BENCHMARK_TRACKS is defined at build time,
+// by uncommenting its flag in AnaTools/bin/BuildFile.xml. There is no track
+// collection in MINI_AOD, so this also requires DATA_FORMAT to be AOD, where
+// osu::Track wraps a reco::Track which can be built from scratch.
+#if defined (BENCHMARK_TRACKS) && !(IS_VALID(tracks) && DATA_FORMAT == AOD)
+  #error "BENCHMARK_TRACKS requires DATA_FORMAT to be AOD in OSUT3Analysis/AnaTools/interface/DataFormat.h"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Standalone benchmark of the cut evaluation done by CutCalculator. Synthetic
+// muon and jet collections, and track collections if BENCHMARK_TRACKS is
+// defined, with configurable multiplicities are generated for each event and
+// a set of representative cuts, including composite muon-muon and muon-jet
+// cuts, is evaluated with ValueLookupTree objects. The flags are then combined
+// across cuts the same way as in CutCalculator::setInputCollectionFlags. The
+// average time per event spent in each step is printed at the end. No input
+// files are needed.
+//
+// Only the first step of the flag propagation in CutCalculator is timed. The
+// arbitration, the propagation to and from composite collections, and the
+// flags for unrelated collections are not mirrored, so the time reported for
+// the flag propagation is a lower bound on that in CutCalculator.
+//
+// Each tree over a single collection which is evaluated one column at a time
+// is also evaluated one object at a time, outside of the timing, and the two
+// must give the same values and the same evaluation error, or the benchmark
+// fails. A few expressions which give invalid and non-finite values are
+// checked the same way.
+////////////////////////////////////////////////////////////////////////////////
+
+struct BenchmarkCut
+{
+  vector<string> inputCollections;
+  string inputLabel;
+  string cutString;
+  ValueLookupTree *valueLookupTree;
+  double nanoseconds;
+};
+
+struct ColumnCheck
+{
+  vector<string> inputCollections;
+  string inputLabel;
+  string expression;
+  ValueLookupTree *columnTree;
+  ValueLookupTree *objectTree;
+  bool ownsColumnTree;
+};
+
+void generateEvent (mt19937 &, const map<string, unsigned> &, vector<osu::Muon> &, vector<osu::Jet> &, vector<osu::Track> &);
+void propagateFlags (const vector<BenchmarkCut> &, FlagMap &, FlagMap &);
+bool checkColumns (ColumnCheck &, Collections &, Collections &, const unsigned, const bool);
+void printHelp (const string &);
+void parseOptions (int, char *[], map<string, string> &, vector<string> &);
+
+int
+main (int argc, char *argv[])
+{
+  map<string, string> opt;
+  vector<string> argVector;
+  parseOptions (argc, argv, opt, argVector);
+  if (argVector.size () > 1 || opt.count ("help"))
+    {
+      printHelp (argv[0]);
+      return 0;
+    }
+
+  unsigned nEvents = argVector.size () ? atoi (argVector.at (0).c_str ()) : 10000;
+  map<string, unsigned> multiplicities;
+  multiplicities["muons"] = opt.count ("muons") ? atoi (opt.at ("muons").c_str ()) : 4;
+  multiplicities["jets"] = opt.count ("jets") ? atoi (opt.at ("jets").c_str ()) : 8;
+  multiplicities["tracks"] = opt.count ("tracks") ? atoi (opt.at ("tracks").c_str ()) : 20;
+#ifndef BENCHMARK_TRACKS
+  if (opt.count ("tracks"))
+    {
+      cerr << "Tracks are only benchmarked when built with BENCHMARK_TRACKS defined!" << endl;
+      return 1;
+    }
+#endif
+  mt19937 generator (opt.count ("seed") ? atoi (opt.at ("seed").c_str ()) : 0);
+
+  // Needed so that getMember can find the dictionaries of the OSU classes.
+  FWLiteEnabler::enable ();
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Representative cuts, in the same form as they are given in the channel
+  // definitions.
+  //////////////////////////////////////////////////////////////////////////////
+  vector<BenchmarkCut> cuts = {
+    {{"muons"}, "", "pt > 25 && fabs (eta) < 2.1", NULL, 0.0},
+    {{"muons"}, "", "fabs (phi) < 3.0", NULL, 0.0},
+    {{"jets"}, "", "pt > 30 && fabs (eta) < 2.4", NULL, 0.0},
+    {{"muons", "muons"}, "", "invMass (muon, muon) > 60 && invMass (muon, muon) < 120", NULL, 0.0},
+    {{"muons", "muons"}, "", "deltaR (muon, muon) > 0.3", NULL, 0.0},
+    {{"jets", "muons"}, "", "deltaR (muon, jet) > 0.5", NULL, 0.0}
+  };
+#ifdef BENCHMARK_TRACKS
+  cuts.push_back ({{"tracks"}, "", "pt > 50 && fabs (eta) < 2.1", NULL, 0.0});
+  cuts.push_back ({{"muons", "tracks"}, "", "deltaR (muon, track) > 0.15", NULL, 0.0});
+#endif
+  for (auto &cut : cuts)
+    {
+      cut.inputLabel = anatools::concatenateInputCollection (cut.inputCollections);
+      cut.valueLookupTree = new ValueLookupTree (cut.cutString, cut.inputCollections);
+      if (!cut.valueLookupTree->isValid ())
+        {
+          cerr << "Failed to parse \"" << cut.cutString << "\"!" << endl;
+          return 1;
+        }
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The handles in the Collections object point directly to the synthetic
+  // collections, with a dummy provenance so that they are valid.
+  //////////////////////////////////////////////////////////////////////////////
+  vector<osu::Muon> muons;
+  vector<osu::Jet> jets;
+  vector<osu::Track> tracks;
+  edm::Provenance provenance;
+  Collections handles;
+  handles.muons = edm::Handle<vector<osu::Muon> > (&muons, &provenance);
+  handles.jets = edm::Handle<vector<osu::Jet> > (&jets, &provenance);
+#ifdef BENCHMARK_TRACKS
+  handles.tracks = edm::Handle<vector<osu::Track> > (&tracks, &provenance);
+#endif
+  //////////////////////////////////////////////////////////////////////////////
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The trees evaluated one object at a time get their own copy of the
+  // Collections object, so that they do not read member values or
+  // subexpressions cached by the trees they are checked against.
+  //////////////////////////////////////////////////////////////////////////////
+  Collections objectHandles = handles;
+  vector<BenchmarkCut> checkedExpressions = {
+    {{"muons"}, "", "noSuchMember > 0 || pt > 25", NULL, 0.0},
+    {{"jets"}, "", "sqrt (pt - 30) / (fabs (eta) - 1)", NULL, 0.0},
+    {{"muons"}, "", "-pt + 2 * fabs (phi) >= eta && !(pt < 10)", NULL, 0.0}
+  };
+  vector<ColumnCheck> columnChecks;
+  for (const auto &cut : cuts)
+    {
+      if (cut.valueLookupTree->columnarEvaluation ())
+        columnChecks.push_back ({cut.inputCollections, cut.inputLabel, cut.cutString, cut.valueLookupTree, NULL, false});
+    }
+  for (const auto &expression : checkedExpressions)
+    {
+      ValueLookupTree *columnTree = new ValueLookupTree (expression.cutString, expression.inputCollections);
+      if (!columnTree->isValid () || !columnTree->columnarEvaluation ())
+        {
+          cerr << "\"" << expression.cutString << "\" is not evaluated one column at a time!" << endl;
+          return 1;
+        }
+      columnChecks.push_back ({expression.inputCollections, anatools::concatenateInputCollection (expression.inputCollections), expression.cutString, columnTree, NULL, true});
+    }
+  for (auto &check : columnChecks)
+    {
+      check.objectTree = new ValueLookupTree (check.expression, check.inputCollections);
+      check.objectTree->setColumnarEvaluation (false);
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  double evaluationTime = 0.0, propagationTime = 0.0;
+  unsigned long nValues = 0;
+  unsigned nMismatches = 0;
+  for (unsigned iEvent = 0; iEvent < nEvents; iEvent++)
+    {
+      generateEvent (generator, multiplicities, muons, jets, tracks);
+      handles.memberValueCache.clear ();
+      handles.subexpressionCache.clear ();
+      objectHandles.memberValueCache.clear ();
+      objectHandles.subexpressionCache.clear ();
+
+      for (auto &cut : cuts)
+        {
+          auto start = chrono::steady_clock::now ();
+          cut.valueLookupTree->setCollections (&handles);
+          nValues += cut.valueLookupTree->evaluate ().size ();
+          double t = chrono::duration<double, nano> (chrono::steady_clock::now () - start).count ();
+          cut.nanoseconds += t;
+          evaluationTime += t;
+        }
+
+      FlagMap individualObjectFlags, cumulativeObjectFlags;
+      auto start = chrono::steady_clock::now ();
+      propagateFlags (cuts, individualObjectFlags, cumulativeObjectFlags);
+      propagationTime += chrono::duration<double, nano> (chrono::steady_clock::now () - start).count ();
+
+      for (auto &check : columnChecks)
+        {
+          if (!checkColumns (check, handles, objectHandles, iEvent, nMismatches < 10))
+            nMismatches++;
+        }
+    }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Print the results.
+  //////////////////////////////////////////////////////////////////////////////
+#ifdef BENCHMARK_TRACKS
+  cout << nEvents << " events with " << multiplicities.at ("muons") << " muons, " << multiplicities.at ("jets") << " jets, and " << multiplicities.at ("tracks") << " tracks" << endl;
+#else
+  cout << nEvents << " events with " << multiplicities.at ("muons") << " muons and " << multiplicities.at ("jets") << " jets (tracks are not benchmarked without BENCHMARK_TRACKS)" << endl;
+#endif
+  cout << nValues << " values evaluated" << endl << endl;
+  for (const auto &cut : cuts)
+    cout << setw (12) << fixed << setprecision (1) << cut.nanoseconds / nEvents << " ns/event  " << cut.inputLabel << ": " << cut.cutString << endl;
+  cout << endl;
+  cout << setw (12) << fixed << setprecision (1) << evaluationTime / nEvents << " ns/event  total evaluation" << endl;
+  cout << setw (12) << fixed << setprecision (1) << propagationTime / nEvents << " ns/event  flag propagation (input collections only)" << endl;
+  cout << endl;
+  if (nMismatches)
+    cout << "column by column and object by object evaluation differ " << nMismatches << " times, the first ones are printed above" << endl;
+  else
+    cout << columnChecks.size () << " trees give the same values column by column and object by object" << endl;
+  //////////////////////////////////////////////////////////////////////////////
+
+  for (auto &cut : cuts)
+    delete cut.valueLookupTree;
+  for (auto &check : columnChecks)
+    {
+      if (check.ownsColumnTree)
+        delete check.columnTree;
+      delete check.objectTree;
+    }
+
+  return (nMismatches ? 1 : 0);
+}
+
+void
+generateEvent (mt19937 &generator, const map<string, unsigned> &multiplicities, vector<osu::Muon> &muons, vector<osu::Jet> &jets, vector<osu::Track> &tracks)
+{
+  exponential_distribution<double> pt (1.0 / 30.0);
+  uniform_real_distribution<double> eta (-2.5, 2.5),
+                                    phi (-M_PI, M_PI);
+
+  muons.clear ();
+  for (unsigned i = 0; i < multiplicities.at ("muons"); i++)
+    {
+      TYPE(muons) muon;
+      muon.setP4 (reco::Candidate::PolarLorentzVector (pt (generator), eta (generator), phi (generator), 0.105658));
+      muons.push_back (osu::Muon (muon));
+    }
+
+  jets.clear ();
+  for (unsigned i = 0; i < multiplicities.at ("jets"); i++)
+    {
+      TYPE(jets) jet;
+      jet.setP4 (reco::Candidate::PolarLorentzVector (pt (generator), eta (generator), phi (generator), 10.0));
+      jets.push_back (osu::Jet (jet));
+    }
+
+  tracks.clear ();
+#ifdef BENCHMARK_TRACKS
+  for (unsigned i = 0; i < multiplicities.at ("tracks"); i++)
+    {
+      reco::Candidate::PolarLorentzVector p4 (pt (generator), eta (generator), phi (generator), 0.0);
+      TYPE(tracks) track (10.0, 10.0, reco::Track::Point (0.0, 0.0, 0.0), reco::Track::Vector (p4.px (), p4.py (), p4.pz ()), 1, reco::Track::CovarianceMatrix ());
+      tracks.push_back (osu::Track (track));
+    }
+#endif
+}
+
+void
+propagateFlags (const vector<BenchmarkCut> &cuts, FlagMap &individualObjectFlags, FlagMap &cumulativeObjectFlags)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Same logic as CutCalculator::setInputCollectionFlags: store a flag for
+  // each object from each cut, and AND the cumulative flags with those from
+  // the previous cuts on the same collection. The later steps done by
+  // CutCalculator for composite collections are not included.
+  //////////////////////////////////////////////////////////////////////////////
+  individualObjectFlags.resize (cuts.size ());
+  cumulativeObjectFlags.resize (cuts.size ());
+  for (unsigned currentCutIndex = 0; currentCutIndex < cuts.size (); currentCutIndex++)
+    {
+      const BenchmarkCut &currentCut = cuts.at (currentCutIndex);
+      for (const auto &cutDecision : currentCut.valueLookupTree->evaluate ())
+        {
+          double value = boost::get<double> (cutDecision);
+          pair<bool, bool> flag = make_pair (value, !IS_INVALID(value));
+
+          individualObjectFlags.at (currentCutIndex)[currentCut.inputLabel].push_back (flag);
+          cumulativeObjectFlags.at (currentCutIndex)[currentCut.inputLabel].push_back (flag);
+        }
+
+      vector<pair<bool, bool> > &currentFlags = cumulativeObjectFlags.at (currentCutIndex)[currentCut.inputLabel];
+      for (unsigned index = 0; index != currentFlags.size (); index++)
+        {
+          for (unsigned cutIndex = 0; cutIndex != currentCutIndex; cutIndex++)
+            {
+              auto previousFlags = cumulativeObjectFlags.at (cutIndex).find (currentCut.inputLabel);
+              if (previousFlags != cumulativeObjectFlags.at (cutIndex).end ())
+                currentFlags.at (index).first = currentFlags.at (index).first && previousFlags->second.at (index).first;
+            }
+        }
+    }
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+bool
+checkColumns (ColumnCheck &check, Collections &handles, Collections &objectHandles, const unsigned iEvent, const bool printDifferences)
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Compares the values of a tree evaluated one column at a time with those of
+  // the same expression evaluated one object at a time. The values must be
+  // identical, invalid values included, with NaN only equal to NaN, and the
+  // evaluation error must be the same.
+  //////////////////////////////////////////////////////////////////////////////
+  check.columnTree->setCollections (&handles);
+  check.objectTree->setCollections (&objectHandles);
+  const vector<Leaf> &columnValues = check.columnTree->evaluate (),
+                     &objectValues = check.objectTree->evaluate ();
+
+  bool equal = (columnValues.size () == objectValues.size ()
+             && check.columnTree->evaluationError () == check.objectTree->evaluationError ());
+  for (unsigned i = 0; equal && i < columnValues.size (); i++)
+    {
+      const double *columnValue = boost::get<double> (&columnValues.at (i)),
+                   *objectValue = boost::get<double> (&objectValues.at (i));
+      if (columnValue && objectValue)
+        equal = (*columnValue == *objectValue || (std::isnan (*columnValue) && std::isnan (*objectValue)));
+      else
+        equal = (columnValues.at (i) == objectValues.at (i));
+    }
+  if (equal || !printDifferences)
+    return equal;
+
+  cerr << "Event " << iEvent << ", " << check.inputLabel << ": \"" << check.expression << "\" differs:" << endl;
+  cerr << "  column by column (error " << check.columnTree->evaluationError () << "):";
+  for (const auto &value : columnValues)
+    cerr << " " << value;
+  cerr << endl;
+  cerr << "  object by object (error " << check.objectTree->evaluationError () << "):";
+  for (const auto &value : objectValues)
+    cerr << " " << value;
+  cerr << endl;
+  return false;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+void
+printHelp (const string &exeName)
+{
+  printf ("Usage: %s [OPTION]... [NEVENTS]\n", exeName.c_str ());
+  printf ("Times the evaluation of representative cuts on NEVENTS synthetic events\n");
+  printf ("(default 10000) and prints the average time per event.\n");
+  printf ("\n");
+  printf ("%-29s%s\n", "  -h, --help", "print this help message");
+  printf ("%-29s%s\n", "  -m, --muons N", "number of muons per event (default 4)");
+  printf ("%-29s%s\n", "  -j, --jets N", "number of jets per event (default 8)");
+  printf ("%-29s%s\n", "  -t, --tracks N", "number of tracks per event (default 20, requires BENCHMARK_TRACKS)");
+  printf ("%-29s%s\n", "  -s, --seed N", "seed for the random number generator (default 0)");
+}
+
+void
+parseOptions (int argc, char *argv[], map<string, string> &opt, vector<string> &argVector)
+{
+  for (int i = 1; i < argc; i++)
+    {
+      if (argv[i][0] != '-')
+        {
+          argVector.push_back (argv[i]);
+          continue;
+        }
+      int offset = 1;
+      if (argv[i][1] == '-')
+        offset++;
+      string key = argv[i] + offset;
+      if (key == "h")
+        key = "help";
+      else if (key == "m")
+        key = "muons";
+      else if (key == "j")
+        key = "jets";
+      else if (key == "t")
+        key = "tracks";
+      else if (key == "s")
+        key = "seed";
+      if (key != "help" && i + 1 < argc)
+        opt[key] = argv[++i];
+      else
+        opt[key] = "";
+    }
+}
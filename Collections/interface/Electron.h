@@ -73,6 +73,11 @@ namespace osu
 #endif
         ~Electron ();
 
+        const unsigned triggerMatchBits () const;
+        const bool isTriggerMatched () const;
+        const double dRToTriggerObject () const;
+        void set_triggerMatch (const unsigned bits, const double dR) { triggerMatchBits_ = bits; dRToTriggerObject_ = dR; };
+
 #if DATA_FORMAT == MINI_AOD || DATA_FORMAT == MINI_AOD_CUSTOM
       private:
         float rho_;
@@ -108,6 +113,10 @@ namespace osu
         double metNoMuMinusOneUpPhi_;
 #endif
 
+      private:
+        unsigned triggerMatchBits_;
+        double dRToTriggerObject_;
+
     };
 }
 
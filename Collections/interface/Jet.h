@@ -54,6 +54,11 @@ namespace osu
 	void set_log10ipsig (float value) { log10ipsig_ = value;}
 	void set_medianlog10ipsig (float value) { medianlog10ipsig_ = value;}
 
+        const unsigned triggerMatchBits () const;
+        const bool isTriggerMatched () const;
+        const double dRToTriggerObject () const;
+        void set_triggerMatch (const unsigned bits, const double dR) { triggerMatchBits_ = bits; dRToTriggerObject_ = dR; };
+
       private:
         int matchedToLepton_;
         float pfCombinedSecondaryVertexV2BJetTags_;
@@ -71,6 +76,9 @@ namespace osu
 	float ipsig_;
 	float log10ipsig_;
 	float medianlog10ipsig_;
+
+        unsigned triggerMatchBits_;
+        double dRToTriggerObject_;
     };
 }
 #elif DATA_FORMAT == AOD_CUSTOM
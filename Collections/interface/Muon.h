@@ -53,6 +53,15 @@ namespace osu
         const double metNoMuMinusOnePy () const;
         const double metNoMuMinusOnePhi () const;
 
+        // Set by TriggerMatcher in Collections/plugins if the producer has
+        // any triggerMatchingFilters. Bit i is set if the muon is within
+        // maxDeltaRForTriggerMatching of a trigger object which passed the
+        // i-th filter.
+        const unsigned triggerMatchBits () const;
+        const bool isTriggerMatched () const;
+        const double dRToTriggerObject () const;
+        void set_triggerMatch (const unsigned bits, const double dR) { triggerMatchBits_ = bits; dRToTriggerObject_ = dR; };
+
       private:
         bool isTightMuonWRTVtx_;
         double pfdBetaIsoCorr_;
@@ -73,6 +82,9 @@ namespace osu
         double metNoMuMinusOnePx_;
         double metNoMuMinusOnePy_;
         double metNoMuMinusOnePhi_;
+
+        unsigned triggerMatchBits_;
+        double dRToTriggerObject_;
     };
 }
 #elif DATA_FORMAT == AOD_CUSTOM
@@ -1,8 +1,7 @@
 #ifndef OSU_TRACK
 #define OSU_TRACK
 
-#include <random>
-#include <chrono>
+#include <cstdint>
 
 #include "DataFormats/GsfTrackReco/interface/GsfTrack.h"
 
@@ -38,6 +37,36 @@ struct EtaPhiList : public vector<EtaPhi>
 
 namespace osu
 {
+  // Summary of the hit pattern of a track, made once when the track is
+  // produced so that the hit-pattern accessors reduce to bit operations. For
+  // each tracker substructure (PXB = 1, PXF = 2, TIB = 3, TID = 4, TOB = 5,
+  // TEC = 6), bit (layer - 1) of validLayers or missingLayers is set if there
+  // is a valid or missing hit in that layer among the TRACK_HITS.
+  struct HitPatternSummary
+  {
+    bool filled;
+    uint16_t validLayers[7];
+    uint16_t missingLayers[7];
+    uint16_t packedPixelBarrelHitPattern;
+    uint16_t packedPixelEndcapHitPattern;
+    uint16_t firstLayerWithValidHit;
+    uint16_t lastLayerWithValidHit;
+
+    HitPatternSummary () :
+      filled (false),
+      validLayers (),
+      missingLayers (),
+      packedPixelBarrelHitPattern (0),
+      packedPixelEndcapHitPattern (0),
+      firstLayerWithValidHit (0),
+      lastLayerWithValidHit (0)
+    {
+    }
+
+    const int stripLayersWithMeasurement () const;
+    const int stripTOBLayersWithMeasurement () const;
+  };
+
   class Track : public GenMatchable<TYPE(tracks), 0>
     {
       public:
@@ -45,7 +74,7 @@ namespace osu
         Track (const TYPE(tracks) &);
         Track (const TYPE(tracks) &, const edm::Handle<vector<osu::Mcparticle> > &);
         Track (const TYPE(tracks) &, const edm::Handle<vector<osu::Mcparticle> > &, const edm::ParameterSet &);
-        Track (const TYPE(tracks) &, const edm::Handle<vector<osu::Mcparticle> > &, const edm::ParameterSet &, const edm::Handle<vector<reco::GsfTrack> > &, const EtaPhiList &, const EtaPhiList &, const map<DetId, vector<double> > * const, const map<DetId, vector<int> > * const, const bool);
+        Track (const TYPE(tracks) &, const edm::Handle<vector<osu::Mcparticle> > &, const edm::ParameterSet &, const edm::Handle<vector<reco::GsfTrack> > &, const EtaPhiList &, const EtaPhiList &, const map<DetId, vector<double> > * const, const map<DetId, vector<int> > * const, const bool, const uint64_t = 0);
         ~Track ();
 
         const double dRMinJet() const;
@@ -85,6 +114,10 @@ namespace osu
         const int hitAndTOBDrop_gsfTrackMissingOuterHits () const;
         const int hitAndTOBDrop_bestTrackMissingOuterHits () const;
 
+        // Returns the seed for the hit-drop decisions of the track with the
+        // given index in the given event, so that they are reproducible.
+        static uint64_t dropHitsSeed (const unsigned run, const unsigned lumi, const unsigned long long event, const unsigned index);
+
         // Debug methods for HitPattern
         const bool hasValidHitInPixelBarrelLayer (const uint16_t layer) const;
         const bool hasValidHitInPixelBarrelLayer1 () const { return hasValidHitInPixelBarrelLayer(1); };
@@ -111,6 +144,10 @@ namespace osu
 
         const bool inTOBCrack () const;
 
+        // Returns the summary made when the track was produced, or makes one
+        // if the track was read from a file without it.
+        const HitPatternSummary hitPatternSummary () const;
+
     private:
         double dRMinJet_;
         double minDeltaRForFiducialTrack_;
@@ -136,9 +173,11 @@ namespace osu
         double postTOBDropHitProbability_;
         double hitProbability_;
 
+        bool dropHits_;
+        uint64_t dropHitsSeed_;
         bool dropTOBDecision_;
-        vector<bool> dropHitDecisions_;
-        vector<bool> dropMiddleHitDecisions_;
+
+        HitPatternSummary hitPatternSummary_;
 
         const bool isFiducialTrack (const EtaPhiList &, const double, double &) const;
         const edm::Ref<vector<reco::GsfTrack> > &findMatchedGsfTrack (const edm::Handle<vector<reco::GsfTrack> > &, edm::Ref<vector<reco::GsfTrack> > &, double &) const;
@@ -146,6 +185,21 @@ namespace osu
         int isCloseToBadEcalChannel (const double &);
         template<class T> const int extraMissingMiddleHits (const T &) const;
         template<class T> const int extraMissingOuterHits (const T &) const;
+        const int stripLayersWithMeasurement (const osu::Track &) const;
+        const int stripLayersWithMeasurement (const reco::GsfTrack &) const;
+        const HitPatternSummary summarizeHitPattern () const;
+
+        ////////////////////////////////////////////////////////////////////////
+        // Counter-based random numbers for the hit-drop studies: the i-th
+        // number of a given stream is a hash of the seed, the stream, and i,
+        // so each decision is computed on demand and does not depend on the
+        // order in which the decisions are made.
+        ////////////////////////////////////////////////////////////////////////
+        static uint64_t splitMix64 (uint64_t);
+        const double dropHitsUniform (const unsigned stream, const unsigned i) const;
+        const bool dropHitDecision (const unsigned) const;
+        const bool dropMiddleHitDecision (const unsigned) const;
+        ////////////////////////////////////////////////////////////////////////
 
     };
 }
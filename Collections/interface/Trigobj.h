@@ -14,7 +14,47 @@ namespace osu
         Trigobj (const TYPE(trigobjs) &);
         Trigobj (const TYPE(trigobjs) &, const edm::Handle<vector<osu::Mcparticle> > &);
         Trigobj (const TYPE(trigobjs) &, const edm::Handle<vector<osu::Mcparticle> > &, const edm::ParameterSet &);
+        Trigobj (const TYPE(trigobjs) &, const edm::Handle<vector<osu::Mcparticle> > &, const edm::ParameterSet &, const vector<unsigned> &);
         ~Trigobj ();
+
+        // IDs in the TrigobjFilterIndex of the same event of the filters
+        // which this object passed.
+        const vector<unsigned> &filterIds () const { return filterIds_; };
+        bool passedFilter (const unsigned filterId) const;
+
+      private:
+        vector<unsigned> filterIds_;
+    };
+
+  // Filter labels of all of the trigger objects in an event, each stored once
+  // and given an ID, and, for each filter, the indices of the objects which
+  // passed it. This is produced alongside the vector<osu::Trigobj> by
+  // OSUTrigobjProducer, which unpacks the filter labels once per event, so
+  // that trigger objects can be looked up by filter without unpacking them
+  // again or comparing strings.
+  class TrigobjFilterIndex
+    {
+      public:
+        TrigobjFilterIndex () {};
+        ~TrigobjFilterIndex () {};
+
+        // Return the ID of the given filter, adding it if it is not already
+        // known, and record that the given object passed it.
+        unsigned addObject (const unsigned objectIndex, const string &filterLabel);
+
+        // Return the ID of the given filter, or size () if no object passed
+        // it.
+        unsigned filterId (const string &) const;
+
+        unsigned size () const { return filterLabels_.size (); };
+        const string &filterLabel (const unsigned filterId) const { return filterLabels_.at (filterId); };
+        const vector<unsigned> &objectIndices (const unsigned filterId) const { return objectIndices_.at (filterId); };
+        bool passed (const string &filterLabel) const { return filterId (filterLabel) < size (); };
+
+      private:
+        vector<string> filterLabels_;
+        map<string, unsigned> filterIds_;
+        vector<vector<unsigned> > objectIndices_;
     };
 }
 
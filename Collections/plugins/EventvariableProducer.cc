@@ -10,8 +10,10 @@ EventvariableProducer::EventvariableProducer (const edm::ParameterSet &cfg) :
   collection_ = collections_.getParameter<edm::InputTag> ("eventvariables");
 
   produces<osu::Eventvariable> (collection_.instance ());
+  produces<EventVariableRecord> (collection_.instance ());
 
   token_ = consumes<TYPE(eventvariables)> (collection_);
+  recordToken_ = consumes<EventVariableRecord> (collection_);
 }
 
 EventvariableProducer::~EventvariableProducer ()
@@ -21,6 +23,15 @@ EventvariableProducer::~EventvariableProducer ()
 void
 EventvariableProducer::produce (edm::Event &event, const edm::EventSetup &setup)
 {
+  //////////////////////////////////////////////////////////////////////////////
+  // The typed record of the declared variables is passed along as is, if the
+  // producer of the input made one.
+  //////////////////////////////////////////////////////////////////////////////
+  edm::Handle<EventVariableRecord> record;
+  if (event.getByToken (recordToken_, record))
+    event.put (unique_ptr<EventVariableRecord> (new EventVariableRecord (*record)), collection_.instance ());
+  //////////////////////////////////////////////////////////////////////////////
+
   edm::Handle<TYPE(eventvariables)> collection;
   if (!event.getByToken (token_, collection))
     return;
@@ -23,6 +23,7 @@ class EventvariableProducer : public edm::EDProducer
     edm::ParameterSet  collections_;
     edm::InputTag      collection_;
     edm::EDGetTokenT<TYPE(eventvariables)> token_;
+    edm::EDGetTokenT<EventVariableRecord> recordToken_;
     ////////////////////////////////////////////////////////////////////////////
 
     // Payload for this EDFilter.
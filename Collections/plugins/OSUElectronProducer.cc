@@ -12,7 +12,8 @@ OSUElectronProducer::OSUElectronProducer (const edm::ParameterSet &cfg) :
   cfg_ (cfg),
   pfCandidate_ (cfg.getParameter<edm::InputTag> ("pfCandidate")),
   conversions_ (cfg.getParameter<edm::InputTag> ("conversions")),
-  rho_         (cfg.getParameter<edm::InputTag> ("rho"))
+  rho_         (cfg.getParameter<edm::InputTag> ("rho")),
+  triggerMatcher_ (cfg, consumesCollector ())
 {
   collection_ = collections_.getParameter<edm::InputTag> ("electrons");
   produces<vector<osu::Electron> > (collection_.instance ());
@@ -66,11 +67,14 @@ OSUElectronProducer::produce (edm::Event &event, const edm::EventSetup &setup)
   Handle<double> rho;
   event.getByToken (rhoToken_, rho);
 
+  triggerMatcher_.update (event);
+
   pl_ = unique_ptr<vector<osu::Electron> > (new vector<osu::Electron> ());
   for (const auto &object : *collection)
     {
       pl_->emplace_back (object, particles, cfg_, met->at (0));
       osu::Electron &electron = pl_->back ();
+      triggerMatcher_.match (electron);
 
       if(rho.isValid())
         electron.set_rho((float)(*rho));
@@ -198,9 +202,14 @@ OSUElectronProducer::produce (edm::Event &event, const edm::EventSetup &setup)
   edm::Handle<vector<osu::Mcparticle> > particles;
   event.getByToken (mcparticleToken_, particles);
 
+  triggerMatcher_.update (event);
+
   pl_ = unique_ptr<vector<osu::Electron> > (new vector<osu::Electron> ());
   for (const auto &object : *collection)
-    pl_->emplace_back (object, particles, cfg_);
+    {
+      pl_->emplace_back (object, particles, cfg_);
+      triggerMatcher_.match (pl_->back ());
+    }
 
   event.put (std::move (pl_), collection_.instance ());
   pl_.reset ();
@@ -6,6 +6,7 @@
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "OSUT3Analysis/Collections/interface/Electron.h"
+#include "OSUT3Analysis/Collections/plugins/TriggerMatcher.h"
 #include "RecoEgamma/EgammaTools/interface/EffectiveAreas.h"
 
 class OSUElectronProducer : public edm::EDProducer
@@ -37,6 +38,8 @@ class OSUElectronProducer : public edm::EDProducer
     edm::InputTag      conversions_;
     edm::InputTag      rho_;
 
+    TriggerMatcher     triggerMatcher_;
+
     ////////////////////////////////////////////////////////////////////////////
 
     // Payload for this EDFilter.
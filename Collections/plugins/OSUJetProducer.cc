@@ -1,5 +1,6 @@
 #include "OSUT3Analysis/Collections/plugins/OSUJetProducer.h"
 #include "DataFormats/Math/interface/deltaR.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #if IS_VALID(jets)
 
@@ -18,7 +19,8 @@ OSUJetProducer::OSUJetProducer (const edm::ParameterSet &cfg) :
   jetResolutionPayload_ (cfg.getParameter<string> ("jetResolutionPayload")),
   jetResSFPayload_      (cfg.getParameter<string> ("jetResSFPayload")),
   jetResFromGlobalTag_  (cfg.getParameter<bool> ("jetResFromGlobalTag")),
-  cfg_         (cfg)
+  cfg_         (cfg),
+  triggerMatcher_ (cfg, consumesCollector ())
 {
   collection_ = collections_.getParameter<edm::InputTag> ("jets");
 #if DATA_FORMAT == MINI_AOD || DATA_FORMAT == MINI_AOD_CUSTOM || DATA_FORMAT == AOD
@@ -37,6 +39,11 @@ OSUJetProducer::OSUJetProducer (const edm::ParameterSet &cfg) :
   genjetsToken_ = consumes<vector<TYPE(genjets)> > (genjets_);
   rhoToken_ = consumes<double> (rho_);
   primaryvertexsToken_ = consumes<vector<TYPE(primaryvertexs)> > (primaryvertexs_);
+#else
+  // osu::Jet is the original jet class in this data format, so it cannot hold
+  // the result of trigger matching.
+  if (triggerMatcher_.isEnabled ())
+    throw cms::Exception ("FatalError") << "Trigger matching of jets is not supported for this data format.\n";
 #endif
 }
 
@@ -54,6 +61,8 @@ OSUJetProducer::produce (edm::Event &event, const edm::EventSetup &setup)
   edm::Handle<vector<osu::Mcparticle> > particles;
   event.getByToken (mcparticleToken_, particles);
 
+  triggerMatcher_.update (event);
+
 #if DATA_FORMAT == MINI_AOD || DATA_FORMAT == MINI_AOD_CUSTOM
   // get JetCorrector parameters to get the jec uncertainty
   edm::ESHandle<JetCorrectorParametersCollection> JetCorParColl;
@@ -148,6 +157,7 @@ OSUJetProducer::produce (edm::Event &event, const edm::EventSetup &setup)
 #if DATA_FORMAT == MINI_AOD || DATA_FORMAT == MINI_AOD_CUSTOM || DATA_FORMAT == AOD
       pl_->emplace_back (object, particles, cfg_);
       osu::Jet &jet = pl_->back ();
+      triggerMatcher_.match (jet);
 #elif DATA_FORMAT == AOD_CUSTOM
       pl_->emplace_back (object);
 #endif
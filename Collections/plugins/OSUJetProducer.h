@@ -8,6 +8,7 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
 #include "OSUT3Analysis/Collections/interface/Jet.h"
+#include "OSUT3Analysis/Collections/plugins/TriggerMatcher.h"
 
 #include "JetMETCorrections/Objects/interface/JetCorrector.h"
 #include "JetMETCorrections/Objects/interface/JetCorrectionsRecord.h"
@@ -47,6 +48,8 @@ class OSUJetProducer : public edm::EDProducer
     edm::EDGetTokenT<vector<TYPE(primaryvertexs)> > primaryvertexsToken_;
 
     edm::ParameterSet  cfg_;
+
+    TriggerMatcher     triggerMatcher_;
     ////////////////////////////////////////////////////////////////////////////
 
     // Payload for this EDFilter.
@@ -10,9 +10,8 @@
 OSUMuonProducer::OSUMuonProducer (const edm::ParameterSet &cfg) :
   collections_ (cfg.getParameter<edm::ParameterSet> ("collections")),
   cfg_ (cfg),
-  pfCandidate_ (cfg.getParameter<edm::InputTag> ("pfCandidate"))
-
-
+  pfCandidate_ (cfg.getParameter<edm::InputTag> ("pfCandidate")),
+  triggerMatcher_ (cfg, consumesCollector ())
 {
   collection_ = collections_.getParameter<edm::InputTag> ("muons");
   produces<vector<osu::Muon> > (collection_.instance ());
@@ -60,6 +59,8 @@ OSUMuonProducer::produce (edm::Event &event, const edm::EventSetup &setup)
   Handle<vector<osu::Met> > met;
   event.getByToken (metToken_, met);
 
+  triggerMatcher_.update (event);
+
 
 
 
@@ -71,6 +72,7 @@ OSUMuonProducer::produce (edm::Event &event, const edm::EventSetup &setup)
     {
       pl_->emplace_back (object, particles, cfg_, met->at (0));
       osu::Muon &muon = pl_->back ();
+      triggerMatcher_.match (muon);
 
       if (vertices->size ())
         {
@@ -178,15 +180,23 @@ OSUMuonProducer::produce (edm::Event &event, const edm::EventSetup &setup)
   pl_.reset ();
 }
 #elif DATA_FORMAT == AOD_CUSTOM
+#include "FWCore/Utilities/interface/Exception.h"
+
 #include "OSUT3Analysis/AnaTools/interface/CommonUtils.h"
 
 OSUMuonProducer::OSUMuonProducer (const edm::ParameterSet &cfg) :
   collections_ (cfg.getParameter<edm::ParameterSet> ("collections")),
-  cfg_ (cfg)
+  cfg_ (cfg),
+  triggerMatcher_ (cfg, consumesCollector ())
 {
   collection_ = collections_.getParameter<edm::InputTag> ("muons");
 
   produces<vector<osu::Muon> > (collection_.instance ());
+
+  // osu::Muon is the original muon class in this data format, so it cannot
+  // hold the result of trigger matching.
+  if (triggerMatcher_.isEnabled ())
+    throw cms::Exception ("FatalError") << "Trigger matching of muons is not supported for this data format.\n";
 }
 
 OSUMuonProducer::~OSUMuonProducer ()
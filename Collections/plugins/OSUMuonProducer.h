@@ -6,6 +6,7 @@
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "OSUT3Analysis/Collections/interface/Muon.h"
+#include "OSUT3Analysis/Collections/plugins/TriggerMatcher.h"
 
 
 class OSUMuonProducer : public edm::EDProducer
@@ -35,6 +36,8 @@ class OSUMuonProducer : public edm::EDProducer
     edm::ParameterSet  cfg_;
     edm::InputTag      pfCandidate_;
 
+    TriggerMatcher     triggerMatcher_;
+
     ////////////////////////////////////////////////////////////////////////////
 
     // Payload for this EDFilter.
@@ -142,7 +142,8 @@ OSUTrackProducer::produce (edm::Event &event, const edm::EventSetup &setup)
   for (const auto &object : *collection)
     {
 #ifdef DISAPP_TRKS
-      pl_->emplace_back (object, particles, cfg_, gsfTracks, electronVetoList_, muonVetoList_, &EcalAllDeadChannelsValMap_, &EcalAllDeadChannelsBitMap_, !event.isRealData ());
+      uint64_t dropHitsSeed = osu::Track::dropHitsSeed (event.id ().run (), event.id ().luminosityBlock (), event.id ().event (), pl_->size ());
+      pl_->emplace_back (object, particles, cfg_, gsfTracks, electronVetoList_, muonVetoList_, &EcalAllDeadChannelsValMap_, &EcalAllDeadChannelsBitMap_, !event.isRealData (), dropHitsSeed);
       osu::Track &track = pl_->back ();
 #else
       pl_->emplace_back (object);
@@ -11,9 +11,12 @@ OSUTrigobjProducer::OSUTrigobjProducer (const edm::ParameterSet &cfg) :
   collection_ = collections_.getParameter<edm::InputTag> ("trigobjs");
 
   produces<vector<osu::Trigobj> > (collection_.instance ());
+  produces<osu::TrigobjFilterIndex> (collection_.instance ());
 
   token_ = consumes<vector<TYPE(trigobjs)> > (collection_);
   mcparticleToken_ = consumes<vector<osu::Mcparticle> > (collections_.getParameter<edm::InputTag> ("mcparticles"));
+  if (collections_.exists ("triggers"))
+    triggersToken_ = consumes<TYPE(triggers)> (collections_.getParameter<edm::InputTag> ("triggers"));
 }
 
 OSUTrigobjProducer::~OSUTrigobjProducer ()
@@ -29,12 +32,42 @@ OSUTrigobjProducer::produce (edm::Event &event, const edm::EventSetup &setup)
   edm::Handle<vector<osu::Mcparticle> > particles;
   event.getByToken (mcparticleToken_, particles);
 
+  edm::Handle<TYPE(triggers)> triggers;
+  if (!triggersToken_.isUninitialized ())
+    event.getByToken (triggersToken_, triggers);
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The path names and filter labels of each object are unpacked exactly once
+  // per event, here, and each filter label is interned in the filter index,
+  // so that nothing downstream needs to unpack or compare them again.
+  //////////////////////////////////////////////////////////////////////////////
   pl_ = unique_ptr<vector<osu::Trigobj> > (new vector<osu::Trigobj> ());
-  for (const auto &object : *collection)
-    pl_->emplace_back (object, particles, cfg_);
+  filterIndex_ = unique_ptr<osu::TrigobjFilterIndex> (new osu::TrigobjFilterIndex ());
+  pl_->reserve (collection->size ());
+  vector<unsigned> filterIds;
+  for (unsigned i = 0; i < collection->size (); i++)
+    {
+      TYPE(trigobjs) object = collection->at (i);
+      if (triggers.isValid ())
+        {
+#if CMSSW_VERSION_CODE >= CMSSW_VERSION(9,2,0)
+          object.unpackNamesAndLabels (event, *triggers);
+#else
+          object.unpackPathNames (event.triggerNames (*triggers));
+#endif
+        }
+
+      filterIds.clear ();
+      for (const auto &filterLabel : object.filterLabels ())
+        filterIds.push_back (filterIndex_->addObject (i, filterLabel));
+      pl_->emplace_back (object, particles, cfg_, filterIds);
+    }
+  //////////////////////////////////////////////////////////////////////////////
 
   event.put (std::move (pl_), collection_.instance ());
+  event.put (std::move (filterIndex_), collection_.instance ());
   pl_.reset ();
+  filterIndex_.reset ();
 }
 
 #include "FWCore/Framework/interface/MakerMacros.h"
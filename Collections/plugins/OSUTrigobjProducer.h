@@ -24,11 +24,13 @@ class OSUTrigobjProducer : public edm::EDProducer
     edm::InputTag      collection_;
     edm::EDGetTokenT<vector<TYPE(trigobjs)> > token_;
     edm::EDGetTokenT<vector<osu::Mcparticle> > mcparticleToken_;
+    edm::EDGetTokenT<TYPE(triggers)> triggersToken_;
     edm::ParameterSet  cfg_;
     ////////////////////////////////////////////////////////////////////////////
 
     // Payload for this EDFilter.
     unique_ptr<vector<osu::Trigobj> > pl_;
+    unique_ptr<osu::TrigobjFilterIndex> filterIndex_;
 };
 
 #endif
@@ -0,0 +1,169 @@
+#include <cmath>
+#include <numeric>
+
+#include "DataFormats/Math/interface/deltaR.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "OSUT3Analysis/Collections/plugins/TriggerMatcher.h"
+
+namespace
+{
+  // Trigger objects beyond this |eta| are put in the outermost cells, which
+  // does not change which of them are matched.
+  const double MAX_ETA = 5.0;
+
+  // Smallest width of the cells, so that the grid stays small for very small
+  // values of maxDeltaRForTriggerMatching.
+  const double MIN_CELL_WIDTH = 0.2;
+}
+
+TriggerMatcher::TriggerMatcher (const edm::ParameterSet &cfg, edm::ConsumesCollector &&cc) :
+  filters_       (cfg.getParameter<vector<string> > ("triggerMatchingFilters")),
+  maxDeltaR_     (cfg.getParameter<double> ("maxDeltaRForTriggerMatching")),
+  etaCellWidth_  (2.0 * MAX_ETA),
+  phiCellWidth_  (2.0 * M_PI),
+  nEtaCells_     (1),
+  nPhiCells_     (1)
+{
+  if (filters_.empty ())
+    return;
+  if (filters_.size () > 32)
+    throw cms::Exception ("FatalError") << "At most 32 filters can be used for trigger matching, but " << filters_.size () << " were given.\n";
+  if (!(maxDeltaR_ > 0.0))
+    throw cms::Exception ("FatalError") << "maxDeltaRForTriggerMatching must be positive to use trigger matching.\n";
+
+#if IS_VALID(trigobjs)
+  const edm::ParameterSet &collections = cfg.getParameter<edm::ParameterSet> ("collections");
+  if (!collections.exists ("trigobjs"))
+    throw cms::Exception ("FatalError") << "No trigobjs collection was given, but it is needed for trigger matching.\n";
+  token_ = cc.consumes<vector<osu::Trigobj> > (collections.getParameter<edm::InputTag> ("trigobjs"));
+  filterIndexToken_ = cc.consumes<osu::TrigobjFilterIndex> (collections.getParameter<edm::InputTag> ("trigobjs"));
+#else
+  throw cms::Exception ("FatalError") << "Trigger matching is not supported for this data format.\n";
+#endif
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The cells are at least maxDeltaR wide in phi, so an object can only be
+  // matched to trigger objects in its own phi cell and the two next to it.
+  //////////////////////////////////////////////////////////////////////////////
+  const double cellWidth = max (maxDeltaR_, MIN_CELL_WIDTH);
+  nEtaCells_ = max ((unsigned) ceil (2.0 * MAX_ETA / cellWidth), 1u);
+  nPhiCells_ = max ((unsigned) floor (2.0 * M_PI / cellWidth), 1u);
+  etaCellWidth_ = 2.0 * MAX_ETA / nEtaCells_;
+  phiCellWidth_ = 2.0 * M_PI / nPhiCells_;
+  //////////////////////////////////////////////////////////////////////////////
+}
+
+TriggerMatcher::~TriggerMatcher ()
+{
+}
+
+void
+TriggerMatcher::update (const edm::Event &event)
+{
+  trigobjs_.clear ();
+  cellBegin_.assign (nEtaCells_ * nPhiCells_ + 1, 0);
+  if (filters_.empty ())
+    return;
+
+#if IS_VALID(trigobjs)
+  edm::Handle<vector<osu::Trigobj> > collection;
+  edm::Handle<osu::TrigobjFilterIndex> filterIndex;
+  if (!event.getByToken (token_, collection) || !event.getByToken (filterIndexToken_, filterIndex))
+    return;
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The trigger objects which passed each filter are read from the filter
+  // index, and only those which passed any of them are kept.
+  //////////////////////////////////////////////////////////////////////////////
+  filterBits_.assign (collection->size (), 0);
+  for (unsigned i = 0; i < filters_.size (); i++)
+    {
+      const unsigned filterId = filterIndex->filterId (filters_.at (i));
+      if (filterId >= filterIndex->size ())
+        continue;
+      for (const auto &objectIndex : filterIndex->objectIndices (filterId))
+        filterBits_.at (objectIndex) |= (1u << i);
+    }
+
+  vector<IndexedTrigobj> trigobjs;
+  vector<unsigned> cells;
+  for (unsigned i = 0; i < collection->size (); i++)
+    {
+      if (!filterBits_.at (i))
+        continue;
+
+      const osu::Trigobj &trigobj = collection->at (i);
+      trigobjs.push_back ({trigobj.eta (), trigobj.phi (), filterBits_.at (i)});
+      cells.push_back (etaCell (trigobj.eta ()) * nPhiCells_ + phiCell (trigobj.phi ()));
+      cellBegin_.at (cells.back () + 1)++;
+    }
+  //////////////////////////////////////////////////////////////////////////////
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Order the trigger objects by cell with a counting sort.
+  //////////////////////////////////////////////////////////////////////////////
+  partial_sum (cellBegin_.begin (), cellBegin_.end (), cellBegin_.begin ());
+  vector<unsigned> next (cellBegin_.begin (), cellBegin_.end () - 1);
+  trigobjs_.resize (trigobjs.size ());
+  for (unsigned i = 0; i < trigobjs.size (); i++)
+    trigobjs_.at (next.at (cells.at (i))++) = trigobjs.at (i);
+  //////////////////////////////////////////////////////////////////////////////
+#endif
+}
+
+unsigned
+TriggerMatcher::findMatches (const double eta, const double phi, double &minDeltaR) const
+{
+  unsigned phiCells[3] = {0, 1, 2}, nPhiCells = nPhiCells_;
+  if (nPhiCells_ >= 3)
+    {
+      const unsigned cell = phiCell (phi);
+      phiCells[0] = (cell + nPhiCells_ - 1) % nPhiCells_;
+      phiCells[1] = cell;
+      phiCells[2] = (cell + 1) % nPhiCells_;
+      nPhiCells = 3;
+    }
+
+  unsigned filterBits = 0;
+  minDeltaR = INVALID_VALUE;
+  const unsigned etaBegin = etaCell (eta - maxDeltaR_),
+                 etaEnd = etaCell (eta + maxDeltaR_) + 1;
+  for (unsigned i = etaBegin; i < etaEnd; i++)
+    {
+      for (unsigned j = 0; j < nPhiCells; j++)
+        {
+          const unsigned cell = i * nPhiCells_ + phiCells[j];
+          for (unsigned k = cellBegin_[cell]; k < cellBegin_[cell + 1]; k++)
+            {
+              const IndexedTrigobj &trigobj = trigobjs_[k];
+              double dR = reco::deltaR (eta, phi, trigobj.eta, trigobj.phi);
+              if (dR > maxDeltaR_)
+                continue;
+              filterBits |= trigobj.filterBits;
+              if (dR < minDeltaR || minDeltaR < 0.0)
+                minDeltaR = dR;
+            }
+        }
+    }
+
+  return filterBits;
+}
+
+unsigned
+TriggerMatcher::etaCell (const double eta) const
+{
+  const double x = (eta + MAX_ETA) / etaCellWidth_;
+  if (!(x >= 0.0))
+    return 0;
+  return min ((unsigned) min (x, (double) nEtaCells_), nEtaCells_ - 1);
+}
+
+unsigned
+TriggerMatcher::phiCell (const double phi) const
+{
+  const double x = (phi + M_PI) / phiCellWidth_;
+  if (!(x >= 0.0))
+    return 0;
+  return min ((unsigned) min (x, (double) nPhiCells_), nPhiCells_ - 1);
+}
@@ -0,0 +1,76 @@
+#ifndef TRIGGER_MATCHER
+#define TRIGGER_MATCHER
+
+#include "FWCore/Framework/interface/ConsumesCollector.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "OSUT3Analysis/Collections/interface/Trigobj.h"
+
+// Matches the objects made by an OSU object producer to the trigger objects
+// which passed any of the filters in its triggerMatchingFilters parameter. The
+// trigobjs collection must be the one made by OSUTrigobjProducer, whose
+// filter index gives the trigger objects which passed each filter, so that
+// nothing is unpacked or copied again. These are found once per event, in
+// update, and put in a grid of eta-phi cells the size of
+// maxDeltaRForTriggerMatching, so that matching each object only looks at the
+// trigger objects in the neighboring cells. Nothing is done if no filters are
+// given.
+class TriggerMatcher
+{
+  public:
+    TriggerMatcher (const edm::ParameterSet &, edm::ConsumesCollector &&);
+    ~TriggerMatcher ();
+
+    // Whether any filters were given, i.e., whether objects are matched.
+    bool isEnabled () const { return !filters_.empty (); };
+
+    void update (const edm::Event &);
+
+    // Return the bits of the filters passed by the trigger objects matched
+    // to the given eta and phi, and set the distance to the closest one.
+    unsigned findMatches (const double, const double, double &) const;
+
+    template<class T> void match (T &object) const
+    {
+      if (filters_.empty ())
+        return;
+      double dR;
+      unsigned filterBits = findMatches (object.eta (), object.phi (), dR);
+      object.set_triggerMatch (filterBits, dR);
+    };
+
+  private:
+    struct IndexedTrigobj
+      {
+        double eta;
+        double phi;
+        unsigned filterBits;
+      };
+
+    vector<string> filters_;
+    double maxDeltaR_;
+
+#if IS_VALID(trigobjs)
+    edm::EDGetTokenT<vector<osu::Trigobj> > token_;
+    edm::EDGetTokenT<osu::TrigobjFilterIndex> filterIndexToken_;
+#endif
+
+    double etaCellWidth_;
+    double phiCellWidth_;
+    unsigned nEtaCells_;
+    unsigned nPhiCells_;
+
+    // Trigger objects in this event which passed any of the filters, ordered
+    // by cell, with those in cell i starting at cellBegin_[i].
+    vector<IndexedTrigobj> trigobjs_;
+    vector<unsigned> cellBegin_;
+
+    // Bits of the filters passed by each trigger object in this event.
+    vector<unsigned> filterBits_;
+
+    unsigned etaCell (const double) const;
+    unsigned phiCell (const double) const;
+};
+
+#endif
@@ -39,7 +39,9 @@ osu::Electron::Electron (const TYPE(electrons) &electron) :
   metNoMuMinusOneUpPt_        (INVALID_VALUE),
   metNoMuMinusOneUpPx_        (INVALID_VALUE),
   metNoMuMinusOneUpPy_        (INVALID_VALUE),
-  metNoMuMinusOneUpPhi_       (INVALID_VALUE)
+  metNoMuMinusOneUpPhi_       (INVALID_VALUE),
+  triggerMatchBits_           (0),
+  dRToTriggerObject_          (INVALID_VALUE)
 {
 }
 
@@ -70,7 +72,9 @@ osu::Electron::Electron (const TYPE(electrons) &electron, const edm::Handle<vect
   metNoMuMinusOneUpPt_          (INVALID_VALUE),
   metNoMuMinusOneUpPx_          (INVALID_VALUE),
   metNoMuMinusOneUpPy_          (INVALID_VALUE),
-  metNoMuMinusOneUpPhi_         (INVALID_VALUE)
+  metNoMuMinusOneUpPhi_         (INVALID_VALUE),
+  triggerMatchBits_           (0),
+  dRToTriggerObject_          (INVALID_VALUE)
 {
 }
 
@@ -101,7 +105,9 @@ osu::Electron::Electron (const TYPE(electrons) &electron, const edm::Handle<vect
   metNoMuMinusOneUpPt_          (INVALID_VALUE),
   metNoMuMinusOneUpPx_          (INVALID_VALUE),
   metNoMuMinusOneUpPy_          (INVALID_VALUE),
-  metNoMuMinusOneUpPhi_         (INVALID_VALUE)
+  metNoMuMinusOneUpPhi_         (INVALID_VALUE),
+  triggerMatchBits_           (0),
+  dRToTriggerObject_          (INVALID_VALUE)
 {
 }
 
@@ -132,7 +138,9 @@ osu::Electron::Electron (const TYPE(electrons) &electron, const edm::Handle<vect
   metNoMuMinusOneUpPt_          (INVALID_VALUE),
   metNoMuMinusOneUpPx_          (INVALID_VALUE),
   metNoMuMinusOneUpPy_          (INVALID_VALUE),
-  metNoMuMinusOneUpPhi_         (INVALID_VALUE)
+  metNoMuMinusOneUpPhi_         (INVALID_VALUE),
+  triggerMatchBits_           (0),
+  dRToTriggerObject_          (INVALID_VALUE)
 {
   TVector2 p (met.px () + this->px (), met.py () + this->py ()),
            pNoMu (met.noMuPx () + this->px (), met.noMuPy () + this->py ()),
@@ -373,17 +381,23 @@ osu::Electron::metNoMuMinusOneUpPhi () const
 #else
 
 osu::Electron::Electron (const TYPE(electrons) &electron) :
-  GenMatchable (electron)
+  GenMatchable (electron),
+  triggerMatchBits_   (0),
+  dRToTriggerObject_  (INVALID_VALUE)
 {
 }
 
 osu::Electron::Electron (const TYPE(electrons) &electron, const edm::Handle<vector<osu::Mcparticle> > &particles) :
-  GenMatchable (electron, particles)
+  GenMatchable (electron, particles),
+  triggerMatchBits_   (0),
+  dRToTriggerObject_  (INVALID_VALUE)
 {
 }
 
 osu::Electron::Electron (const TYPE(electrons) &electron, const edm::Handle<vector<osu::Mcparticle> > &particles, const edm::ParameterSet &cfg) :
-  GenMatchable (electron, particles, cfg)
+  GenMatchable (electron, particles, cfg),
+  triggerMatchBits_   (0),
+  dRToTriggerObject_  (INVALID_VALUE)
 {
 }
 
@@ -392,4 +406,22 @@ osu::Electron::Electron (const TYPE(electrons) &electron, const edm::Handle<vect
 osu::Electron::~Electron ()
 {
 }
+
+const unsigned
+osu::Electron::triggerMatchBits () const
+{
+  return triggerMatchBits_;
+}
+
+const bool
+osu::Electron::isTriggerMatched () const
+{
+  return (triggerMatchBits_ != 0);
+}
+
+const double
+osu::Electron::dRToTriggerObject () const
+{
+  return dRToTriggerObject_;
+}
 #endif
@@ -24,7 +24,9 @@ osu::Jet::Jet (const TYPE(jets) &jet) :
   alphamax_                                      (INVALID_VALUE),
   ipsig_                                         (INVALID_VALUE),
   log10ipsig_                                    (INVALID_VALUE),
-  medianlog10ipsig_                              (INVALID_VALUE)
+  medianlog10ipsig_                              (INVALID_VALUE),
+  triggerMatchBits_                              (0),
+  dRToTriggerObject_                             (INVALID_VALUE)
 {
 }
 
@@ -45,7 +47,9 @@ osu::Jet::Jet (const TYPE(jets) &jet, const edm::Handle<vector<osu::Mcparticle>
   alphamax_                                      (INVALID_VALUE),
   ipsig_                                         (INVALID_VALUE),
   log10ipsig_                                    (INVALID_VALUE),
-  medianlog10ipsig_                              (INVALID_VALUE)
+  medianlog10ipsig_                              (INVALID_VALUE),
+  triggerMatchBits_                              (0),
+  dRToTriggerObject_                             (INVALID_VALUE)
 {
 }
 
@@ -66,7 +70,9 @@ osu::Jet::Jet (const TYPE(jets) &jet, const edm::Handle<vector<osu::Mcparticle>
   alphamax_                                      (INVALID_VALUE),
   ipsig_                                         (INVALID_VALUE),
   log10ipsig_                                    (INVALID_VALUE),
-  medianlog10ipsig_                              (INVALID_VALUE)
+  medianlog10ipsig_                              (INVALID_VALUE),
+  triggerMatchBits_                              (0),
+  dRToTriggerObject_                             (INVALID_VALUE)
 {
 }
 
@@ -166,6 +172,24 @@ osu::Jet::medianlog10ipsig () const
   return medianlog10ipsig_;
 }
 
+const unsigned
+osu::Jet::triggerMatchBits () const
+{
+  return triggerMatchBits_;
+}
+
+const bool
+osu::Jet::isTriggerMatched () const
+{
+  return (triggerMatchBits_ != 0);
+}
+
+const double
+osu::Jet::dRToTriggerObject () const
+{
+  return dRToTriggerObject_;
+}
+
 #elif DATA_FORMAT == AOD_CUSTOM
 osu::Jet::Jet (const TYPE(jets) &jet) :
   TYPE(jets) (jet)
@@ -25,7 +25,9 @@ osu::Muon::Muon (const TYPE(muons) &muon) :
   metNoMuMinusOnePt_       (INVALID_VALUE),
   metNoMuMinusOnePx_       (INVALID_VALUE),
   metNoMuMinusOnePy_       (INVALID_VALUE),
-  metNoMuMinusOnePhi_      (INVALID_VALUE)
+  metNoMuMinusOnePhi_      (INVALID_VALUE),
+  triggerMatchBits_        (0),
+  dRToTriggerObject_       (INVALID_VALUE)
 {
 }
 
@@ -47,7 +49,9 @@ osu::Muon::Muon (const TYPE(muons) &muon, const edm::Handle<vector<osu::Mcpartic
   metNoMuMinusOnePt_       (INVALID_VALUE),
   metNoMuMinusOnePx_       (INVALID_VALUE),
   metNoMuMinusOnePy_       (INVALID_VALUE),
-  metNoMuMinusOnePhi_      (INVALID_VALUE)
+  metNoMuMinusOnePhi_      (INVALID_VALUE),
+  triggerMatchBits_        (0),
+  dRToTriggerObject_       (INVALID_VALUE)
 {
 }
 
@@ -69,7 +73,9 @@ osu::Muon::Muon (const TYPE(muons) &muon, const edm::Handle<vector<osu::Mcpartic
   metNoMuMinusOnePt_       (INVALID_VALUE),
   metNoMuMinusOnePx_       (INVALID_VALUE),
   metNoMuMinusOnePy_       (INVALID_VALUE),
-  metNoMuMinusOnePhi_      (INVALID_VALUE)
+  metNoMuMinusOnePhi_      (INVALID_VALUE),
+  triggerMatchBits_        (0),
+  dRToTriggerObject_       (INVALID_VALUE)
 {
 }
 
@@ -91,7 +97,9 @@ osu::Muon::Muon (const TYPE(muons) &muon, const edm::Handle<vector<osu::Mcpartic
   metNoMuMinusOnePt_       (INVALID_VALUE),
   metNoMuMinusOnePx_       (INVALID_VALUE),
   metNoMuMinusOnePy_       (INVALID_VALUE),
-  metNoMuMinusOnePhi_      (INVALID_VALUE)
+  metNoMuMinusOnePhi_      (INVALID_VALUE),
+  triggerMatchBits_        (0),
+  dRToTriggerObject_       (INVALID_VALUE)
 {
   TVector2 p (met.px () + this->px (), met.py () + this->py ()),
            pNoMu (met.noMuPx (), met.noMuPy ()); // we do not add the muon's pt
@@ -228,6 +236,24 @@ osu::Muon::metNoMuMinusOnePhi () const
   return metNoMuMinusOnePhi_;
 }
 
+const unsigned
+osu::Muon::triggerMatchBits () const
+{
+  return triggerMatchBits_;
+}
+
+const bool
+osu::Muon::isTriggerMatched () const
+{
+  return (triggerMatchBits_ != 0);
+}
+
+const double
+osu::Muon::dRToTriggerObject () const
+{
+  return dRToTriggerObject_;
+}
+
 #elif DATA_FORMAT == AOD_CUSTOM
 
 osu::Muon::Muon ()
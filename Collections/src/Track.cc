@@ -14,9 +14,9 @@ osu::Track::Track () :
   EcalAllDeadChannelsValMap_ (NULL),
   EcalAllDeadChannelsBitMap_ (NULL),
   isFiducialECALTrack_ (true),
-  dropTOBDecision_ (-1.0),
-  dropHitDecisions_ ({}),
-  dropMiddleHitDecisions_ ({})
+  dropHits_ (false),
+  dropHitsSeed_ (0),
+  dropTOBDecision_ (false)
 {
 }
 
@@ -33,9 +33,10 @@ osu::Track::Track (const TYPE(tracks) &track) :
   EcalAllDeadChannelsValMap_ (NULL),
   EcalAllDeadChannelsBitMap_ (NULL),
   isFiducialECALTrack_ (true),
-  dropTOBDecision_ (-1.0),
-  dropHitDecisions_ ({}),
-  dropMiddleHitDecisions_ ({})
+  dropHits_ (false),
+  dropHitsSeed_ (0),
+  dropTOBDecision_ (false),
+  hitPatternSummary_ (summarizeHitPattern ())
 {
 }
 
@@ -52,9 +53,10 @@ osu::Track::Track (const TYPE(tracks) &track, const edm::Handle<vector<osu::Mcpa
   EcalAllDeadChannelsValMap_ (NULL),
   EcalAllDeadChannelsBitMap_ (NULL),
   isFiducialECALTrack_ (true),
-  dropTOBDecision_ (-1.0),
-  dropHitDecisions_ ({}),
-  dropMiddleHitDecisions_ ({})
+  dropHits_ (false),
+  dropHitsSeed_ (0),
+  dropTOBDecision_ (false),
+  hitPatternSummary_ (summarizeHitPattern ())
 {
 }
 
@@ -71,13 +73,14 @@ osu::Track::Track (const TYPE(tracks) &track, const edm::Handle<vector<osu::Mcpa
   EcalAllDeadChannelsValMap_ (NULL),
   EcalAllDeadChannelsBitMap_ (NULL),
   isFiducialECALTrack_ (true),
-  dropTOBDecision_ (-1.0),
-  dropHitDecisions_ ({}),
-  dropMiddleHitDecisions_ ({})
+  dropHits_ (false),
+  dropHitsSeed_ (0),
+  dropTOBDecision_ (false),
+  hitPatternSummary_ (summarizeHitPattern ())
 {
 }
 
-osu::Track::Track (const TYPE(tracks) &track, const edm::Handle<vector<osu::Mcparticle> > &particles, const edm::ParameterSet &cfg, const edm::Handle<vector<reco::GsfTrack> > &gsfTracks, const EtaPhiList &electronVetoList, const EtaPhiList &muonVetoList, const map<DetId, vector<double> > * const EcalAllDeadChannelsValMap, const map<DetId, vector<int> > * const EcalAllDeadChannelsBitMap, const bool dropHits) :
+osu::Track::Track (const TYPE(tracks) &track, const edm::Handle<vector<osu::Mcparticle> > &particles, const edm::ParameterSet &cfg, const edm::Handle<vector<reco::GsfTrack> > &gsfTracks, const EtaPhiList &electronVetoList, const EtaPhiList &muonVetoList, const map<DetId, vector<double> > * const EcalAllDeadChannelsValMap, const map<DetId, vector<int> > * const EcalAllDeadChannelsBitMap, const bool dropHits, const uint64_t dropHitsSeed) :
   GenMatchable (track, particles, cfg),
   dRMinJet_ (INVALID_VALUE),
   minDeltaRForFiducialTrack_ (cfg.getParameter<double> ("minDeltaRForFiducialTrack")),
@@ -86,9 +89,10 @@ osu::Track::Track (const TYPE(tracks) &track, const edm::Handle<vector<osu::Mcpa
   EcalAllDeadChannelsValMap_ (EcalAllDeadChannelsValMap),
   EcalAllDeadChannelsBitMap_ (EcalAllDeadChannelsBitMap),
   isFiducialECALTrack_ (!isCloseToBadEcalChannel (minDeltaRForFiducialTrack_)),
-  dropTOBDecision_ (-1.0),
-  dropHitDecisions_ ({}),
-  dropMiddleHitDecisions_ ({})
+  dropHits_ (dropHits),
+  dropHitsSeed_ (dropHitsSeed),
+  dropTOBDecision_ (false),
+  hitPatternSummary_ (summarizeHitPattern ())
 {
   maxDeltaR_ = cfg.getParameter<double> ("maxDeltaRForGsfTrackMatching");
   if (gsfTracks.isValid ())
@@ -108,14 +112,8 @@ osu::Track::Track (const TYPE(tracks) &track, const edm::Handle<vector<osu::Mcpa
       <<  "hitProbability:             "  <<  (hitProbability_             *  100.0)  <<  "%";
   edm::LogInfo ("osu_Track") << ss.str ();
 
-  unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-  default_random_engine generator (seed);
-  uniform_real_distribution<double> distribution (0.0, 1.0);
-  dropTOBDecision_ = (dropHits ? distribution (generator) : 1.0e6) < dropTOBProbability_;
-  for (int i = 0; i < 50; i++)
-    dropHitDecisions_.push_back ((dropHits ? distribution (generator) : 1.0e6) < (dropTOBDecision_ ? postTOBDropHitProbability_ : preTOBDropHitProbability_));
-  for (int i = 0; i < 50; i++)
-    dropMiddleHitDecisions_.push_back ((dropHits ? distribution (generator) : 1.0e6) < hitProbability_);
+  // The decisions for the individual hits are made on demand.
+  dropTOBDecision_ = dropHits_ && dropHitsUniform (0, 0) < dropTOBProbability_;
 
   // PrintTrackHitPatternInfo();
 
@@ -357,6 +355,41 @@ osu::Track::bestTrackMissingOuterHits () const
  * Methods for testing effect of dropping random hits and all the TOB hits.
 *******************************************************************************/
 
+uint64_t
+osu::Track::dropHitsSeed (const unsigned run, const unsigned lumi, const unsigned long long event, const unsigned index)
+{
+  return splitMix64 (splitMix64 (splitMix64 (splitMix64 (run) ^ lumi) ^ event) ^ index);
+}
+
+uint64_t
+osu::Track::splitMix64 (uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+const double
+osu::Track::dropHitsUniform (const unsigned stream, const unsigned i) const
+{
+  // The top 53 bits give a double uniformly distributed in [0, 1).
+  uint64_t x = splitMix64 (dropHitsSeed_ ^ splitMix64 ((uint64_t (stream) << 32) | i));
+  return (x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+const bool
+osu::Track::dropHitDecision (const unsigned i) const
+{
+  return dropHits_ && dropHitsUniform (1, i) < (dropTOBDecision_ ? postTOBDropHitProbability_ : preTOBDropHitProbability_);
+}
+
+const bool
+osu::Track::dropMiddleHitDecision (const unsigned i) const
+{
+  return dropHits_ && dropHitsUniform (2, i) < hitProbability_;
+}
+
 /* Missing middle hits */
 
 template<class T> const int
@@ -364,9 +397,9 @@ osu::Track::extraMissingMiddleHits (const T &track) const
 {
   int nHits = 0;
   bool countMissingMiddleHits = false;
-  for (int i = 0; i < track.hitPattern ().stripLayersWithMeasurement () - (dropTOBDecision_ ? this->hitPattern ().stripTOBLayersWithMeasurement () : 0); i++)
+  for (int i = 0; i < stripLayersWithMeasurement (track) - (dropTOBDecision_ ? hitPatternSummary ().stripTOBLayersWithMeasurement () : 0); i++)
     {
-      bool hit = !dropMiddleHitDecisions_.at (i);
+      bool hit = !dropMiddleHitDecision (i);
       if (!hit && countMissingMiddleHits)
         nHits++;
       if (hit)
@@ -411,9 +444,9 @@ template<class T> const int
 osu::Track::extraMissingOuterHits (const T &track) const
 {
   int nHits = 0;
-  for (int i = 0; i < track.hitPattern ().stripLayersWithMeasurement () - (dropTOBDecision_ ? this->hitPattern ().stripTOBLayersWithMeasurement () : 0); i++)
+  for (int i = 0; i < stripLayersWithMeasurement (track) - (dropTOBDecision_ ? hitPatternSummary ().stripTOBLayersWithMeasurement () : 0); i++)
     {
-      bool hit = !dropHitDecisions_.at (i);
+      bool hit = !dropHitDecision (i);
       if (!hit)
         nHits++;
       else
@@ -426,7 +459,7 @@ osu::Track::extraMissingOuterHits (const T &track) const
 const int
 osu::Track::hitAndTOBDrop_missingOuterHits () const
 {
-  int nDropTOBHits = (dropTOBDecision_ ? this->hitPattern ().stripTOBLayersWithMeasurement () : 0);
+  int nDropTOBHits = (dropTOBDecision_ ? hitPatternSummary ().stripTOBLayersWithMeasurement () : 0);
   int nDropHits = extraMissingOuterHits (*this);
   return this->hitPattern ().trackerLayersWithoutMeasurement (reco::HitPattern::MISSING_OUTER_HITS) + nDropTOBHits + nDropHits;
 }
@@ -576,39 +609,13 @@ osu::Track::PrintTrackHitPatternInfo () const
 const bool
 osu::Track::hasValidHitInPixelBarrelLayer (const uint16_t layer) const
 {
-
-  const reco::HitPattern &p = this->hitPattern();
-
-  // Loop over TRACK_HITS
-  for (int i = 0; i < p.numberOfHits(reco::HitPattern::TRACK_HITS); i++) {
-    uint16_t hit = p.getHitPattern(reco::HitPattern::TRACK_HITS, i);
-    if(reco::HitPattern::pixelBarrelHitFilter(hit) &&
-       reco::HitPattern::getLayer(hit) == layer &&
-       reco::HitPattern::validHitFilter(hit)) {
-         return true;
-     }
-   }
-
-   return false;
- }
+  return (layer > 0 && layer <= 16 && ((hitPatternSummary ().validLayers[1] >> (layer - 1)) & 0x1));
+}
 
 const bool
 osu::Track::hasValidHitInPixelEndcapLayer (const uint16_t layer) const
 {
-
-  const reco::HitPattern &p = this->hitPattern();
-
-  // Loop over TRACK_HITS
-  for (int i = 0; i < p.numberOfHits(reco::HitPattern::TRACK_HITS); i++) {
-    uint16_t hit = p.getHitPattern(reco::HitPattern::TRACK_HITS, i);
-    if(reco::HitPattern::pixelEndcapHitFilter(hit) &&
-       reco::HitPattern::getLayer(hit) == layer &&
-       reco::HitPattern::validHitFilter(hit)) {
-         return true;
-     }
-   }
-
-   return false;
+  return (layer > 0 && layer <= 16 && ((hitPatternSummary ().validLayers[2] >> (layer - 1)) & 0x1));
 }
 
 const uint16_t
@@ -632,63 +639,7 @@ osu::Track::packedPixelBarrelHitPattern () const
 
   // This looks at TRACK_HITS, MISSING_INNER_HITS, and MISSING_OUTER_HITS
 
-  uint8_t statusPXB1 = 0x4;
-  uint8_t statusPXB2 = 0x4;
-  uint8_t statusPXB3 = 0x4;
-
-  const reco::HitPattern &p = this->hitPattern();
-
-  const std::array<reco::HitPattern::HitCategory, 3> categories = {{reco::HitPattern::TRACK_HITS, reco::HitPattern::MISSING_INNER_HITS, reco::HitPattern::MISSING_OUTER_HITS}};
-
-  // Loop over TRACK_HITS, MISSING_INNER_HITS, and MISSING_OUTER_HITS
-  for (auto category : categories) {
-
-    for (int i = 0; i < p.numberOfHits(category); i++) {
-      uint16_t hit = p.getHitPattern(category, i);
-
-      if(reco::HitPattern::pixelBarrelHitFilter(hit)) {
-
-        uint32_t layer = reco::HitPattern::getLayer(hit);
-
-        if(layer == 1) {
-          if(statusPXB1 != 0x4) { // if you already found a hit, mark this as having multiple hits
-            statusPXB1 = 0x5;
-            continue;
-          }
-          else statusPXB1 = reco::HitPattern::getHitType(hit);
-        }
-
-        if(layer == 2) {
-          if(statusPXB2 != 0x4) { // if you already found a hit, mark this as having multiple hits
-            statusPXB2 = 0x5;
-            continue;
-          }
-          else statusPXB2 = reco::HitPattern::getHitType(hit);
-        }
-
-        if(layer == 3) {
-          if(statusPXB3 != 0x4) { // if you already found a hit, mark this as having multiple hits
-            statusPXB3 = 0x5;
-            continue;
-          }
-          else statusPXB3 = reco::HitPattern::getHitType(hit);
-        }
-
-      } // if pixel barrel hit
-
-    } // loop over hits in category
-
-  } // loop over categories
-
-  // Now pack these into a single return value
-
-  uint16_t result = 0;
-
-  result |= (statusPXB1 << 0);
-  result |= (statusPXB2 << 3);
-  result |= (statusPXB3 << 6);
-
-  return result;
+  return hitPatternSummary ().packedPixelBarrelHitPattern;
 
 }
 
@@ -703,126 +654,137 @@ osu::Track::packedPixelEndcapHitPattern () const
   // | status | status |
   // |  PXF2  |  PXF1  |
   // +--------+--------+
-  // where status:
-  // 0 = valid
-  // 1 = missing
-  // 2 = inactive
-  // 3 = bad
-  // 4 = no hit present in HitPattern at all
-  // 5 = found multiple hits somehow
+  // where status is the same as for packedPixelBarrelHitPattern
 
   // This looks at TRACK_HITS, MISSING_INNER_HITS, and MISSING_OUTER_HITS
 
-  uint8_t statusPXF1 = 0x4;
-  uint8_t statusPXF2 = 0x4;
-
-  const reco::HitPattern &p = this->hitPattern();
-
-  const std::array<reco::HitPattern::HitCategory, 3> categories = {{reco::HitPattern::TRACK_HITS, reco::HitPattern::MISSING_INNER_HITS, reco::HitPattern::MISSING_OUTER_HITS}};
-
-  // Loop over TRACK_HITS, MISSING_INNER_HITS, and MISSING_OUTER_HITS
-  for (auto category : categories) {
-
-    for (int i = 0; i < p.numberOfHits(category); i++) {
-      uint16_t hit = p.getHitPattern(category, i);
-
-      if(reco::HitPattern::pixelEndcapHitFilter(hit)) {
-
-        uint32_t layer = reco::HitPattern::getLayer(hit);
-
-        if(layer == 1) {
-          if(statusPXF1 != 0x4) { // if you already found a hit, mark this as having multiple hits
-            statusPXF1 = 0x5;
-            continue;
-          }
-          else statusPXF1 = reco::HitPattern::getHitType(hit);
-        }
-
-        if(layer == 2) {
-          if(statusPXF2 != 0x4) { // if you already found a hit, mark this as having multiple hits
-            statusPXF2 = 0x5;
-            continue;
-          }
-          else statusPXF2 = reco::HitPattern::getHitType(hit);
-        }
-
-      } // if pixel endcap hit
-
-    } // loop over hits in category
-
-  } // loop over categories
-
-  // Now pack these into a single return value
-
-  uint16_t result = 0;
-
-  result |= (statusPXF1 << 0);
-  result |= (statusPXF2 << 3);
-
-  return result;
+  return hitPatternSummary ().packedPixelEndcapHitPattern;
 
 }
 
 const uint16_t
 osu::Track::firstLayerWithValidHit () const
 {
+  return hitPatternSummary ().firstLayerWithValidHit;
+}
 
-  bool foundAValidHit = false;
-  uint16_t earliestValidHit = 0;
+const uint16_t
+osu::Track::lastLayerWithValidHit () const
+{
+  return hitPatternSummary ().lastLayerWithValidHit;
+}
+
+const osu::HitPatternSummary
+osu::Track::hitPatternSummary () const
+{
+  return (hitPatternSummary_.filled ? hitPatternSummary_ : summarizeHitPattern ());
+}
 
+const osu::HitPatternSummary
+osu::Track::summarizeHitPattern () const
+{
+  HitPatternSummary summary;
   const reco::HitPattern &p = this->hitPattern();
 
-  // loop over the TRACK_HITS of the track
+  //////////////////////////////////////////////////////////////////////////////
+  // Per-layer valid and missing hits, and the first and last layers with a
+  // valid hit, from the TRACK_HITS.
+  //////////////////////////////////////////////////////////////////////////////
+  bool foundAValidHit = false;
   for (int i = 0; i < p.numberOfHits(reco::HitPattern::TRACK_HITS); i++) {
 
-    uint16_t pattern = p.getHitPattern(reco::HitPattern::TRACK_HITS, i);
-    uint16_t hitType = (pattern >> 0) & 0x3; // results in just the hit type bits
+    uint16_t hit = p.getHitPattern(reco::HitPattern::TRACK_HITS, i);
+    if(!reco::HitPattern::trackerHitFilter(hit)) continue;
 
-    pattern = (pattern - (1 << 10)) >> 3; // results in just the structure/subStructure/subSubStructure bits
+    uint32_t subStructure = reco::HitPattern::getSubStructure(hit);
+    uint32_t layer = reco::HitPattern::getLayer(hit);
+    if(subStructure > 0 && subStructure < 7 && layer > 0 && layer <= 16) {
+      if(reco::HitPattern::validHitFilter(hit)) summary.validLayers[subStructure] |= (1 << (layer - 1));
+      if(reco::HitPattern::missingHitFilter(hit)) summary.missingLayers[subStructure] |= (1 << (layer - 1));
+    }
+
+    uint16_t hitType = (hit >> 0) & 0x3; // results in just the hit type bits
+    uint16_t pattern = (hit - (1 << 10)) >> 3; // results in just the structure/subStructure/subSubStructure bits
 
     if(hitType == reco::HitPattern::HIT_TYPE::VALID) {
       if(!foundAValidHit) {
         foundAValidHit = true;
-        earliestValidHit = pattern;
+        summary.firstLayerWithValidHit = summary.lastLayerWithValidHit = pattern;
+      }
+      else {
+        if(pattern < summary.firstLayerWithValidHit) summary.firstLayerWithValidHit = pattern;
+        if(pattern > summary.lastLayerWithValidHit) summary.lastLayerWithValidHit = pattern;
       }
-      else if(pattern < earliestValidHit) earliestValidHit = pattern;
     }
 
   }
+  //////////////////////////////////////////////////////////////////////////////
 
-  return earliestValidHit;
+  //////////////////////////////////////////////////////////////////////////////
+  // Status of each pixel layer, packed as described in
+  // packedPixelBarrelHitPattern, from all the hit categories.
+  //////////////////////////////////////////////////////////////////////////////
+  uint8_t statusPXB[3] = {0x4, 0x4, 0x4};
+  uint8_t statusPXF[2] = {0x4, 0x4};
 
-}
+  const std::array<reco::HitPattern::HitCategory, 3> categories = {{reco::HitPattern::TRACK_HITS, reco::HitPattern::MISSING_INNER_HITS, reco::HitPattern::MISSING_OUTER_HITS}};
 
-const uint16_t
-osu::Track::lastLayerWithValidHit () const
-{
+  // Loop over TRACK_HITS, MISSING_INNER_HITS, and MISSING_OUTER_HITS
+  for (auto category : categories) {
 
-  bool foundAValidHit = false;
-  uint16_t latestValidHit = 0;
+    for (int i = 0; i < p.numberOfHits(category); i++) {
+      uint16_t hit = p.getHitPattern(category, i);
 
-  const reco::HitPattern &p = this->hitPattern();
+      uint8_t *status = NULL;
+      uint32_t layer = reco::HitPattern::getLayer(hit);
+      if(reco::HitPattern::pixelBarrelHitFilter(hit) && layer >= 1 && layer <= 3)
+        status = &statusPXB[layer - 1];
+      else if(reco::HitPattern::pixelEndcapHitFilter(hit) && layer >= 1 && layer <= 2)
+        status = &statusPXF[layer - 1];
+      if(!status) continue;
 
-  // loop over the TRACK_HITS of the track
-  for (int i = 0; i < p.numberOfHits(reco::HitPattern::TRACK_HITS); i++) {
+      if(*status != 0x4) // if you already found a hit, mark this as having multiple hits
+        *status = 0x5;
+      else
+        *status = reco::HitPattern::getHitType(hit);
 
-    uint16_t pattern = p.getHitPattern(reco::HitPattern::TRACK_HITS, i);
-    uint16_t hitType = (pattern >> 0) & 0x3; // results in just the hit type bits
+    } // loop over hits in category
 
-    pattern = (pattern - (1 << 10)) >> 3; // results in just the structure/subStructure/subSubStructure bits
+  } // loop over categories
 
-    if(hitType == reco::HitPattern::HIT_TYPE::VALID) {
-      if(!foundAValidHit) {
-        foundAValidHit = true;
-        latestValidHit = pattern;
-      }
-      else if(pattern > latestValidHit) latestValidHit = pattern;
-    }
+  // Now pack these into a single value
 
-  }
+  summary.packedPixelBarrelHitPattern = (statusPXB[0] << 0) | (statusPXB[1] << 3) | (statusPXB[2] << 6);
+  summary.packedPixelEndcapHitPattern = (statusPXF[0] << 0) | (statusPXF[1] << 3);
+  //////////////////////////////////////////////////////////////////////////////
+
+  summary.filled = true;
+  return summary;
+}
+
+const int
+osu::Track::stripLayersWithMeasurement (const osu::Track &track) const
+{
+  return track.hitPatternSummary ().stripLayersWithMeasurement ();
+}
 
-  return latestValidHit;
+const int
+osu::Track::stripLayersWithMeasurement (const reco::GsfTrack &track) const
+{
+  return track.hitPattern ().stripLayersWithMeasurement ();
+}
 
+const int
+osu::HitPatternSummary::stripLayersWithMeasurement () const
+{
+  // TIB, TID, TOB, and TEC
+  return __builtin_popcount (validLayers[3]) + __builtin_popcount (validLayers[4]) + __builtin_popcount (validLayers[5]) + __builtin_popcount (validLayers[6]);
+}
+
+const int
+osu::HitPatternSummary::stripTOBLayersWithMeasurement () const
+{
+  return __builtin_popcount (validLayers[5]);
 }
 
 /******************************************************************************/
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "OSUT3Analysis/Collections/interface/Trigobj.h"
 
 #if IS_VALID(trigobjs)
@@ -21,8 +23,45 @@ osu::Trigobj::Trigobj (const TYPE(trigobjs) &trigobj, const edm::Handle<vector<o
 {
 }
 
+osu::Trigobj::Trigobj (const TYPE(trigobjs) &trigobj, const edm::Handle<vector<osu::Mcparticle> > &particles, const edm::ParameterSet &cfg, const vector<unsigned> &filterIds) :
+  GenMatchable (trigobj, particles, cfg),
+  filterIds_ (filterIds)
+{
+  sort (filterIds_.begin (), filterIds_.end ());
+}
+
 osu::Trigobj::~Trigobj ()
 {
 }
 
+bool
+osu::Trigobj::passedFilter (const unsigned filterId) const
+{
+  return binary_search (filterIds_.begin (), filterIds_.end (), filterId);
+}
+
+unsigned
+osu::TrigobjFilterIndex::addObject (const unsigned objectIndex, const string &filterLabel)
+{
+  auto filter = filterIds_.find (filterLabel);
+  if (filter == filterIds_.end ())
+    {
+      filter = filterIds_.insert (make_pair (filterLabel, filterLabels_.size ())).first;
+      filterLabels_.push_back (filterLabel);
+      objectIndices_.push_back (vector<unsigned> ());
+    }
+
+  vector<unsigned> &objectIndices = objectIndices_.at (filter->second);
+  if (objectIndices.empty () || objectIndices.back () != objectIndex)
+    objectIndices.push_back (objectIndex);
+  return filter->second;
+}
+
+unsigned
+osu::TrigobjFilterIndex::filterId (const string &filterLabel) const
+{
+  auto filter = filterIds_.find (filterLabel);
+  return (filter != filterIds_.end () ? filter->second : size ());
+}
+
 #endif
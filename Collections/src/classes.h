@@ -166,6 +166,10 @@ namespace {
     edm::Wrapper<osu::Trigobj>                trigobj2;
     edm::Wrapper<vector<osu::Trigobj> >       trigobj3;
     edm::Ref<vector<osu::Trigobj> >           trigobj4;
+#if IS_VALID(trigobjs)
+    osu::TrigobjFilterIndex                   trigobj5;
+    edm::Wrapper<osu::TrigobjFilterIndex>     trigobj6;
+#endif
 
     osu::Uservariable                         uservariable0;
     vector<osu::Uservariable>                 uservariable1;
@@ -20,6 +20,15 @@ collectionProducer.genMatchables = {
     "maxDeltaRForGenMatching":  cms.double  (0.1),
     "minPtForGenMatching":      cms.double  (10.0),
 }
+# Objects are matched to the trigger objects which passed any of these filters
+# (at most 32), using the filter index made by the trigobjs producer, which
+# add_channels runs before the other object producers when filters are given.
+# Bit i of triggerMatchBits is set if the object matched a trigger object
+# which passed the i-th filter. No matching is done if the list is empty.
+collectionProducer.triggerMatchables = {
+    "triggerMatchingFilters":       cms.vstring (),
+    "maxDeltaRForTriggerMatching":  cms.double  (0.1),
+}
 ################################################################################
 
 ################################################################################
@@ -82,6 +91,7 @@ collectionProducer.electrons = cms.EDProducer ("OSUElectronProducer",
     gsfElectronCore  =  cms.InputTag  ("reducedEgamma",                  "reducedGedGsfElectronCores",  ""),
 )
 copyConfiguration (collectionProducer.electrons, collectionProducer.genMatchables)
+copyConfiguration (collectionProducer.electrons, collectionProducer.triggerMatchables)
 
 #-------------------------------------------------------------------------------
 
@@ -112,6 +122,7 @@ if 'CMSSW_8' in os.environ['CMSSW_VERSION']:
     collectionProducer.jets.jetResFromGlobalTag = cms.bool(True)
 
 copyConfiguration (collectionProducer.jets, collectionProducer.genMatchables)
+copyConfiguration (collectionProducer.jets, collectionProducer.triggerMatchables)
 
 #-------------------------------------------------------------------------------
 
@@ -132,6 +143,7 @@ collectionProducer.muons = cms.EDProducer ("OSUMuonProducer",
     pfCandidate =  cms.InputTag  ('packedPFCandidates','',''),
 )
 copyConfiguration (collectionProducer.muons, collectionProducer.genMatchables)
+copyConfiguration (collectionProducer.muons, collectionProducer.triggerMatchables)
 
 #-------------------------------------------------------------------------------
 
@@ -8,12 +8,12 @@ import glob
 import subprocess
 import pickle
 import shutil
+import json
 from OSUT3Analysis.Configuration.configurationOptions import *
 from OSUT3Analysis.Configuration.processingUtilities import *
 from OSUT3Analysis.Configuration.formattingUtilities import *
 from OSUT3Analysis.DBTools.condorSubArgumentsSet import *
 import FWCore.ParameterSet.Config as cms
-from ROOT import TFile
 
 
 ###############################################################################
@@ -84,41 +84,80 @@ def MakeWeightsString(Weight,FilesSet):
             Str = Str + ',' + str(Weight)
     return Str
 ###############################################################################
+#   Read the cut flows and EDM event counts of many files with one call to    #
+#   getEventsFromCutFlow, which reads the files in parallel. If that call     #
+#   fails, e.g., because ROOT crashed on a corrupt file, the files are read   #
+#   one at a time, so that only those which cannot be read are invalid.       #
+###############################################################################
+def RunGetEventsFromCutFlow(FilesSet):
+    process = subprocess.Popen(['getEventsFromCutFlow', '--json'] + list(FilesSet), stdout = subprocess.PIPE)
+    output = process.communicate()[0]
+    if process.returncode:
+        return None
+    try:
+        return json.loads(output)
+    except ValueError:
+        return None
+def GetCutFlowSummary(FilesSet):
+    Summary = {'files' : {}, 'badFiles' : [], 'edmEvents' : 0, 'totalEvents' : 0, 'cutFlows' : {}}
+    if not FilesSet:
+        return Summary
+    AllFilesSummary = RunGetEventsFromCutFlow(FilesSet)
+    if AllFilesSummary is not None:
+        return AllFilesSummary
+    print "getEventsFromCutFlow failed, reading the files one at a time."
+    for File in FilesSet:
+        FileSummary = RunGetEventsFromCutFlow([File])
+        if FileSummary is None or File not in FileSummary['files']:
+            print File + " could not be read by getEventsFromCutFlow."
+            Summary['files'][File] = {'valid' : False, 'edm' : False, 'edmEvents' : 0, 'totalEvents' : 0, 'cutFlows' : {}}
+            Summary['badFiles'].append(File)
+            continue
+        Summary['files'][File] = FileSummary['files'][File]
+        Summary['badFiles'].extend(FileSummary['badFiles'])
+        Summary['edmEvents'] += FileSummary['edmEvents']
+        Summary['totalEvents'] += FileSummary['totalEvents']
+        # Sum the cut flows bin by bin, as getEventsFromCutFlow does.
+        for Directory in FileSummary['cutFlows']:
+            CutFlow = FileSummary['cutFlows'][Directory]
+            if Directory not in Summary['cutFlows']:
+                Summary['cutFlows'][Directory] = {'eventCounter' : None, 'labels' : None, 'cutFlow' : None}
+            Sum = Summary['cutFlows'][Directory]
+            if CutFlow['eventCounter'] is not None:
+                Sum['eventCounter'] = (Sum['eventCounter'] or 0) + CutFlow['eventCounter']
+            if CutFlow['cutFlow'] is not None:
+                if Sum['cutFlow'] is None:
+                    Sum['labels'] = CutFlow['labels']
+                    Sum['cutFlow'] = []
+                Sum['cutFlow'] += [0] * (len(CutFlow['cutFlow']) - len(Sum['cutFlow']))
+                for i in range(len(CutFlow['cutFlow'])):
+                    Sum['cutFlow'][i] += CutFlow['cutFlow'][i]
+    return Summary
+###############################################################################
 #   Get the total number of events from cutFlows to calculate the weights     #
 ###############################################################################
 def GetNumberOfEvents(FilesSet):
     NumberOfEvents = {'SkimNumber' : {}, 'TotalNumber' : 0}
-    for File in FilesSet:
-        ScoutFile = TFile(File)
-        if ScoutFile.IsZombie():
+    Summary = GetCutFlowSummary(FilesSet)
+    for File in list(FilesSet):
+        FileSummary = Summary['files'][File]
+        if not FileSummary['valid']:
             print File + " is a bad root file."
             FilesSet.remove(File)
             continue
-        randomChannelDirectory = ""
-        TotalNumberTmp = 0
-        for key in ScoutFile.GetListOfKeys():
-            if key.GetClassName() != "TDirectoryFile" or "CutFlow" not in key.GetName():
-                continue
-            randomChannelDirectory = key.GetName()
+        for randomChannelDirectory in FileSummary['cutFlows']:
+            CutFlow = FileSummary['cutFlows'][randomChannelDirectory]
             channelName = randomChannelDirectory[0:len(randomChannelDirectory)-14]
             if not NumberOfEvents['SkimNumber'].has_key(channelName):
                 NumberOfEvents['SkimNumber'][channelName] = 0
-            OriginalCounterObj = ScoutFile.Get(randomChannelDirectory + "/eventCounter")
-            SkimCounterObj = ScoutFile.Get(randomChannelDirectory + "/cutFlow")
-            TotalNumberTmp = 0
-            if not OriginalCounterObj:
+            if CutFlow['eventCounter'] is None:
                 print "Could not find eventCounter histogram in " + str(File) + " !"
                 continue
-            elif not SkimCounterObj:
+            elif CutFlow['cutFlow'] is None:
                 print "Could not find cutFlow histogram in " + str(File) + " !"
-            else:
-                OriginalCounter = OriginalCounterObj.Clone()
-                OriginalCounter.SetDirectory(0)
-                TotalNumberTmp = TotalNumberTmp + OriginalCounter.GetBinContent(1)
-                SkimCounter = SkimCounterObj.Clone()
-                SkimCounter.SetDirectory(0)
-                NumberOfEvents['SkimNumber'][channelName] = NumberOfEvents['SkimNumber'][channelName] + SkimCounter.GetBinContent(SkimCounter.GetXaxis().GetNbins())
-        NumberOfEvents['TotalNumber'] = NumberOfEvents['TotalNumber'] + TotalNumberTmp
+            elif len(CutFlow['cutFlow']):
+                NumberOfEvents['SkimNumber'][channelName] = NumberOfEvents['SkimNumber'][channelName] + CutFlow['cutFlow'][-1]
+        NumberOfEvents['TotalNumber'] = NumberOfEvents['TotalNumber'] + FileSummary['totalEvents']
     return NumberOfEvents
 ###############################################################################
 #                 Produce important files for the skim directory.             #
@@ -235,13 +274,12 @@ def MakeResubmissionScript(badIndices, originalSubmissionScript):
 ###############################################################################
 #                       Determine whether a skim file is valid.               #
 ###############################################################################
-def SkimFileValidator(File):
+def SkimFileValidator(File, Summary = None):
     print "testing ", File
-    FileToTest = TFile(File)
-    Valid = True
-    for TreeToTest in ['MetaData', 'ParameterSets', 'Parentage', 'Events', 'LuminosityBlocks', 'Runs']:
-        Valid = Valid and (FileToTest.Get(TreeToTest) != None)
-    InvalidOrEmpty = not Valid or not FileToTest.Get ("Events").GetEntries ()
+    if Summary is None:
+        Summary = GetCutFlowSummary([File])
+    Valid = Summary['files'][File]['edm']
+    InvalidOrEmpty = not Valid or not Summary['files'][File]['edmEvents']
     return Valid, InvalidOrEmpty
 
 
@@ -299,19 +337,23 @@ def mergeOneDataset(dataSet, IntLumi, CondorDir, OutputDir="", verbose=False):
     # check for any corrupted skim output files
     skimDirs = [member for member in  os.listdir(os.getcwd()) if os.path.isdir(member)]
     FilesToRemove = []
+    SkimFiles = []
     for channel in skimDirs:
         for skimFile in glob.glob(channel+'/*.root'):
             # don't check for good skims of jobs we already know are bad
             index = skimFile.split('.')[0].split('_')[1]
             if index in BadIndices:
                 continue
-            Valid, InvalidOrEmpty = SkimFileValidator(skimFile.rstrip('\n'))
-            if not Valid:
-                BadIndices.append(index)
-                if verbose:
-                    print "  job" + ' ' * (4-len(str(index))) + index + " had bad skim output file"
-            if InvalidOrEmpty:
-                FilesToRemove.append (skimFile)
+            SkimFiles.append((index, skimFile.rstrip('\n')))
+    SkimSummary = GetCutFlowSummary([skimFile for (index, skimFile) in SkimFiles])
+    for (index, skimFile) in SkimFiles:
+        Valid, InvalidOrEmpty = SkimFileValidator(skimFile, SkimSummary)
+        if not Valid and index not in BadIndices:
+            BadIndices.append(index)
+            if verbose:
+                print "  job" + ' ' * (4-len(str(index))) + index + " had bad skim output file"
+        if InvalidOrEmpty:
+            FilesToRemove.append (skimFile)
 
 
     # check for abnormal condor return values
@@ -346,8 +388,9 @@ def mergeOneDataset(dataSet, IntLumi, CondorDir, OutputDir="", verbose=False):
         return
     exec('import datasetInfo_' + dataSet + '_cfg as datasetInfo')
 
-    TotalNumber = GetNumberOfEvents(GoodRootFiles)['TotalNumber']
-    SkimNumber = GetNumberOfEvents(GoodRootFiles)['SkimNumber']
+    NumberOfEvents = GetNumberOfEvents(GoodRootFiles)
+    TotalNumber = NumberOfEvents['TotalNumber']
+    SkimNumber = NumberOfEvents['SkimNumber']
     if verbose:
         print "TotalNumber =", TotalNumber, ", SkimNumber =", SkimNumber
     if not TotalNumber:
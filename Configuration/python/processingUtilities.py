@@ -185,6 +185,18 @@ def get_collections (cuts):
     return sorted (list (collections))
     ############################################################################
 
+def uses_trigger_matching (collections):
+    ############################################################################
+    # Return whether the object producer of any of the given collections is
+    # configured with filters for trigger matching.
+    ############################################################################
+    for collection in collections:
+        producer = getattr (collectionProducer, collection, None)
+        if hasattr (producer, "triggerMatchingFilters") and len (producer.triggerMatchingFilters):
+            return True
+    return False
+    ############################################################################
+
 #def add_channels (process, channels, histogramSets, weights, scalingfactorproducers, collections, variableProducers, skim = True):
 def add_channels (process, channels, histogramSets = None, weights = None, scalingfactorproducers = None, collections = None, variableProducers = None, skim = None):
     ############################################################################
@@ -457,6 +469,14 @@ def add_channels (process, channels, histogramSets = None, weights = None, scali
                 usedCollections.remove (collection)
             if hasattr (collections, collection):
                 usedCollections.insert (0, collection)
+        # Trigger matching in the object producers reads the filter index made
+        # by the trigobj producer, so the trigobjs are produced right after the
+        # collections above if any used collection is matched to them.
+        if hasattr (collections, "trigobjs") and uses_trigger_matching (usedCollections):
+            if "trigobjs" in usedCollections:
+                usedCollections.remove ("trigobjs")
+            usedCollections.insert (len ([a for a in collectionsToProduce if hasattr (collections, a)]), "trigobjs")
+        trigobjProducer = None
         for collection in usedCollections:
             if collection is "uservariables" or collection is "eventvariables":
                 newInputTags = cms.VInputTag()
@@ -509,6 +529,12 @@ def add_channels (process, channels, histogramSets = None, weights = None, scali
                 if collection != "mcparticles" and collection != "mets":
                     label = getattr (collections, "mets").getProductInstanceLabel () if hasattr (collections, "mets") else ""
                     setattr (objectProducer.collections, "mets", cms.InputTag ("objectProducer1", label))
+                # Set the input tag for trigobjs to that produced by the trigobj
+                # producer, whose filter index is needed for trigger matching.
+                if trigobjProducer:
+                    setattr (objectProducer.collections, "trigobjs", cms.InputTag (trigobjProducer, getattr (collections, "trigobjs").getProductInstanceLabel ()))
+                if collection == "trigobjs":
+                    trigobjProducer = "objectProducer" + str (add_channels.producerIndex)
                 channelPath += objectProducer
                 setattr (process, "objectProducer" + str (add_channels.producerIndex), objectProducer)
                 originalInputTag = getattr (collections, collection)
@@ -707,6 +733,95 @@ def set_endPath(process, endPath):
     # add the new endpath at the end of the schedule
     process.schedule.append(endPath)
 
+def enable_timing(process):
+
+    ############################################################################
+    # Turn on the per-module, per-cut, and per-histogram timing in all of the
+    # cut calculators, object selectors, and plotters. The results are written
+    # in a "Timing" directory of each module in the TFileService output. The
+    # time per event of every other module, e.g., the object producers, is
+    # reported at the end of the job by the framework's Timing service.
+    ############################################################################
+
+    for module in process.producers_ ().values () + process.filters_ ().values () + process.analyzers_ ().values ():
+        if module.type_ () == "CutCalculator" or module.type_ () == "Plotter" or module.type_ ().endswith ("ObjectSelector"):
+            module.timing = cms.untracked.bool (True)
+    if not hasattr (process, "Timing"):
+        process.Timing = cms.Service ("Timing",
+            summaryOnly = cms.untracked.bool (True),
+        )
+
+def enable_short_circuit(process):
+
+    ############################################################################
+    # Make all of the cut calculators stop evaluating cuts once the event has
+    # failed the triggers or one of the cuts. The cut flows are unchanged, but
+    # the individual efficiencies of the cuts after the first failing one are
+    # not computed, so the cut flow plotters do not write the "selection"
+    # histogram.
+    ############################################################################
+
+    for module in process.producers_ ().values ():
+        if module.type_ () == "CutCalculator":
+            module.shortCircuit = cms.untracked.bool (True)
+
+def enable_adaptive_ordering(process, warmUp = 1000):
+
+    ############################################################################
+    # Make all of the cut calculators try the cuts which reject the most events
+    # per unit time first, after measuring this on the first warmUp events.
+    # This implies short-circuit mode. The final event selection and the cut
+    # flows are unchanged, since the cuts before the one which rejected an event
+    # are still evaluated in the configured order.
+    ############################################################################
+
+    for module in process.producers_ ().values ():
+        if module.type_ () == "CutCalculator":
+            module.shortCircuit = cms.untracked.bool (True)
+            module.adaptiveOrdering = cms.untracked.bool (True)
+            module.adaptiveOrderingWarmUp = cms.untracked.uint32 (warmUp)
+
+def enable_selection_tree(process):
+
+    ############################################################################
+    # Make all of the cut calculators write a "selection" tree to the
+    # TFileService output, with the run, lumi, and event numbers of every event
+    # and a bitmask of which cuts it passed, cumulatively, so that event lists
+    # can be compared between channels without rerunning cmsRun. The trees are
+    # concatenated by mergeTFileServiceHistograms.
+    ############################################################################
+
+    for module in process.producers_ ().values ():
+        if module.type_ () == "CutCalculator":
+            module.writeSelection = cms.untracked.bool (True)
+
+def write_pu_table(tableName, name, histogram = None):
+
+    ############################################################################
+    # Add the contents of a pileup histogram to a text table, e.g., pu.txt next
+    # to pu.root, replacing any existing line with the same name, or remove that
+    # line if no histogram is given. Each line has the form
+    #   name nBins xMin xMax underflow content_1 ... content_nBins overflow
+    # which PUWeight can read directly, without opening ROOT files.
+    ############################################################################
+
+    lines = []
+    if os.path.exists(tableName):
+        with open(tableName) as table:
+            lines = [line for line in table if line.split() and line.split()[0] != name]
+
+    if histogram is not None:
+        axis = histogram.GetXaxis()
+        if axis.IsVariableBinSize():
+            print "WARNING [write_pu_table]: " + name + " has bins of different widths and will not be added to " + tableName
+        else:
+            nBins = histogram.GetNbinsX()
+            contents = [repr(histogram.GetBinContent(b)) for b in range(nBins + 2)]
+            lines.append(" ".join([name, str(nBins), repr(axis.GetXmin()), repr(axis.GetXmax())] + contents) + "\n")
+
+    with open(tableName, "w") as table:
+        table.writelines(lines)
+
 def set_input(process, input_string):
     from OSUT3Analysis.Configuration.configurationOptions import composite_dataset_definitions
     # N.B. using miniAOD v2 samples by default
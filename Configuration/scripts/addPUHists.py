@@ -32,6 +32,9 @@ parser.add_option("-i", "--inputFile", dest="inputFile", default = "", help="Spe
 parser.add_option("--delete", dest="delete", action="store_true", default=False, help="Delete given datasets in the pu.root")
 (arguments, args) = parser.parse_args()
 
+# the compact text table read by PUWeight, kept next to pu.root
+puTable = os.environ['CMSSW_BASE']+"/src/OSUT3Analysis/Configuration/data/pu.txt"
+
 from ROOT import TFile, gROOT, gStyle, gDirectory, TStyle, THStack, TH1F, TCanvas, TString, TLegend, TArrow, THStack, TIter, TKey, TGraphErrors, Double
 
 def copyOneFile(dataset):
@@ -67,6 +70,7 @@ def copyOneFile(dataset):
         fout.Delete(dataset+";*")
 
     h.Write()
+    write_pu_table(puTable, dataset, h)
 
     fin.Close()
     fout.Close()
@@ -95,6 +99,7 @@ def copyAndRenameOneFile(fout, datasets):
     h2.SetName(Name)
     fout.cd()
     h2.Write()
+    write_pu_table(puTable, Name, h2)
 
 
 def addDataDistribution(fout, inputFile):
@@ -118,11 +123,13 @@ def addDataDistribution(fout, inputFile):
         h1.SetName(str(inputFile.split('.')[0]))
         fout.cd()
         h1.Write()
+        write_pu_table(puTable, str(inputFile.split('.')[0]), h1)
 
 def deletePUDistributions(fout,dataset):
     h = fout.Get(dataset)
     if h:
         fout.Delete(dataset + ";*")
+    write_pu_table(puTable, dataset)
 
 if arguments.localConfig:
     sys.path.append(os.getcwd())
@@ -383,6 +383,10 @@ def getLumiWt(dataset_file):
 def fillTableColumn(table, dataset_file, dataset, hist_name="cutFlow"):
     inputFile = TFile(dataset_file)
     cutFlow = inputFile.Get(table.channel + "/" + hist_name)
+    if not cutFlow:
+        # The "selection" histogram is not written in short-circuit mode.
+        print "WARNING:  no", hist_name, "histogram for channel", table.channel, "in file", dataset_file
+        return
     if cutFlow.GetNbinsX() != len(table.cutNames):
         print "ERROR:  cutFlow.GetNbinsX() = ", cutFlow.GetNbinsX(), " does not equal len(table.cutNames) = ", len(table.cutNames)
         print "Will skip channel", table.channel, " from file ", dataset_file
@@ -22,6 +22,8 @@ from ROOT import TFile, gROOT, gStyle, gDirectory, TStyle, THStack, TH1F, TCanva
 
 gROOT.SetBatch()
 outputFile = TFile(condor_dir + "/pu.root", "RECREATE")
+if os.path.exists(condor_dir + "/pu.txt"):
+    os.remove(condor_dir + "/pu.txt")
 
 processed_datasets = []
 
@@ -54,6 +56,7 @@ for sample in processed_datasets: # loop over different samples as listed in con
         Histogram.SetDirectory(0)
         outputFile.cd()
         Histogram.Write (sample)
+        write_pu_table(condor_dir + "/pu.txt", sample, Histogram)
     else:
         print rootDirectory+"/pileup does not exist in " + condor_dir + "/" + sample + ".root"
         continue
@@ -9,6 +9,7 @@ from math import *
 from array import *
 from decimal import *
 from optparse import OptionParser
+from multiprocessing import Process
 from OSUT3Analysis.Configuration.configurationOptions import *
 from OSUT3Analysis.Configuration.processingUtilities import *
 from OSUT3Analysis.Configuration.formattingUtilities import *
@@ -58,6 +59,8 @@ parser.add_option("-O", "--output-dir", dest="outputDirectory",
                   help="specify an output directory for output file, default is to use the Condor directory")
 parser.add_option("--unique", action="store_true", dest="unique2D",default=False,
                   help="draw 2D plots on unique canvases with the colz option")
+parser.add_option("-j", "--nWorkers", dest="nWorkers",
+                  help="number of parallel processes used to draw the plots, default is 1")
 
 
 (arguments, args) = parser.parse_args()
@@ -437,6 +440,81 @@ def setXAxisRangeUser(hist):
             xAxisMax = float(paperHistogram['setXMax'])
         hist.GetXaxis().SetRangeUser(xAxisMin, xAxisMax)
 
+##########################################################################################################################################
+##########################################################################################################################################
+##########################################################################################################################################
+
+# histograms read from the input files, keyed by (file name, directory, histogram name)
+# each input file is opened only once, and the histograms are detached from it
+histogramCache = {}
+loadedDirectories = set()
+
+def LoadHistograms(datasetFiles, pathsToDirs):
+    # walk each of the requested directories in each dataset file and store
+    # every histogram found there in histogramCache
+    for dataset_file in datasetFiles:
+        pathsToLoad = [pathToDir for pathToDir in pathsToDirs if (dataset_file, pathToDir) not in loadedDirectories]
+        if not pathsToLoad:
+            continue
+        inputFile = TFile(dataset_file)
+        if inputFile.IsZombie():
+            continue
+        for pathToDir in pathsToLoad:
+            loadedDirectories.add((dataset_file, pathToDir))
+            directory = inputFile.GetDirectory(pathToDir)
+            if not directory:
+                continue
+            for key in directory.GetListOfKeys():
+                if not re.match ('TH[12]', key.GetClassName()):
+                    continue
+                HistogramObj = key.ReadObj()
+                HistogramObj.SetDirectory(0)
+                histogramCache[(dataset_file, pathToDir, key.GetName())] = HistogramObj
+        inputFile.Close()
+
+def GetHistogram(dataset_file, pathToDir, histogramName):
+    # return a detached copy of the requested histogram, loading its directory
+    # from the file first if this has not been done already; None if it does
+    # not exist
+    if (dataset_file, pathToDir) not in loadedDirectories:
+        LoadHistograms([dataset_file], [pathToDir])
+    HistogramObj = histogramCache.get((dataset_file, pathToDir, histogramName))
+    if not HistogramObj:
+        return None
+    Histogram = HistogramObj.Clone()
+    Histogram.SetDirectory(0)
+    return Histogram
+
+def MakePlot(plotJob):
+    (pathToDir, histogramName, integrateDir) = plotJob
+    if integrateDir is None:
+        MakeTwoDHist(pathToDir, histogramName)
+    else:
+        MakeOneDHist(pathToDir, histogramName, integrateDir)
+
+def canvasNameForPlot(plotJob):
+    (pathToDir, histogramName, integrateDir) = plotJob
+    if integrateDir is "left":
+        return histogramName + "_CumulativeLeft"
+    if integrateDir is "right":
+        return histogramName + "_CumulativeRight"
+    return histogramName
+
+def RenderPlotsInWorker(workerFileName, plotJobs):
+    # runs in a child process: the canvases are written to a private file
+    # with the same directory structure as the real output file
+    global outputFile
+    outputFile = TFile(workerFileName, "RECREATE")
+    for pathToDir in set([plotJob[0] for plotJob in plotJobs]):
+        parentDir = outputFile
+        for subDir in pathToDir.split("/"):
+            if not parentDir.GetDirectory(subDir):
+                parentDir.mkdir(subDir)
+            parentDir = parentDir.GetDirectory(subDir)
+    for plotJob in plotJobs:
+        MakePlot(plotJob)
+    outputFile.Close()
+
 
 
 def MakeOneDHist(pathToDir,histogramName,integrateDir):
@@ -691,15 +769,10 @@ def MakeOneDHist(pathToDir,histogramName,integrateDir):
     for sample in processed_datasets: # loop over different samples as listed in configurationOptions.py
         dataset_file = "%s/%s.root" % (condor_dir,sample)
         condorDir = condor_dir
-        inputFile = TFile(dataset_file)
-        HistogramObj = inputFile.Get(pathToDir+"/"+histogramName)
-        if not HistogramObj:
+        Histogram = GetHistogram(dataset_file, pathToDir, histogramName)
+        if not Histogram:
             print "WARNING:  Could not find histogram " + pathToDir + "/" + histogramName + " in file " + dataset_file + ".  Will skip it and continue."
             continue
-        Histogram = HistogramObj.Clone()
-        Histogram.SetDirectory(0)
-
-        inputFile.Close()
 
         # correct bin contents of object multiplcity plots
         if Histogram.GetName().startswith("num") and "PV" not in Histogram.GetName():
@@ -1410,14 +1483,10 @@ def MakeTwoDHist(pathToDir,histogramName):
         if arguments.verbose:
             print "Starting to process sample", sample
         dataset_file = "%s/%s.root" % (condor_dir,sample)
-        inputFile = TFile(dataset_file)
-        HistogramObj = inputFile.Get(pathToDir+"/"+histogramName)
-        if not HistogramObj:
+        Histogram = GetHistogram(dataset_file, pathToDir, histogramName)
+        if not Histogram:
             print "WARNING:  Could not find histogram " + pathToDir + "/" + histogramName + " in file " + dataset_file + ".  Will skip it and continue."
             continue
-        Histogram = HistogramObj.Clone()
-        Histogram.SetDirectory(0)
-        inputFile.Close()
         if arguments.rebinFactor:
             RebinFactor = int(arguments.rebinFactor)
             #don't rebin histograms which will have less than 5 bins or any gen-matching histograms
@@ -1652,6 +1721,9 @@ inputFile = TFile(condor_dir + "/" + processed_datasets[0] + ".root")
 inputFile.cd()
 outputFile.cd()
 
+#### walk the template file, making the output directories and collecting the list of plots to make
+plotJobs = []
+
 #get root directory in the first layer, generally "OSUAnalysis"
 for key in inputFile.GetListOfKeys():
     if (key.GetClassName() != "TDirectoryFile"):
@@ -1667,12 +1739,12 @@ for key in inputFile.GetListOfKeys():
 
         if re.match ('TH1', key2.GetClassName()): # found a 1-D histogram
             if arguments.makeSignificancePlots or arguments.makeCumulativePlots:
-                MakeOneDHist(rootDirectory,key2.GetName(),"left")
-                MakeOneDHist(rootDirectory,key2.GetName(),"right")
+                plotJobs.append((rootDirectory,key2.GetName(),"left"))
+                plotJobs.append((rootDirectory,key2.GetName(),"right"))
             else:
-                MakeOneDHist(rootDirectory,key2.GetName(),"none")
+                plotJobs.append((rootDirectory,key2.GetName(),"none"))
         elif re.match ('TH2', key2.GetClassName()) and arguments.draw2DPlots: # found a 2-D histogram
-            MakeTwoDHist(rootDirectory,key2.GetName())
+            plotJobs.append((rootDirectory,key2.GetName(),None))
 
         elif (key2.GetClassName() == "TDirectoryFile"): # found a directory, cd there and look for histograms
             level2Directory = rootDirectory+"/"+key2.GetName()
@@ -1694,12 +1766,12 @@ for key in inputFile.GetListOfKeys():
                     continue
                 if re.match ('TH1', key3.GetClassName()): # found a 1-D histogram
                     if arguments.makeSignificancePlots or arguments.makeCumulativePlots:
-                        MakeOneDHist(level2Directory,key3.GetName(),"left")
-                        MakeOneDHist(level2Directory,key3.GetName(),"right")
+                        plotJobs.append((level2Directory,key3.GetName(),"left"))
+                        plotJobs.append((level2Directory,key3.GetName(),"right"))
                     else:
-                        MakeOneDHist(level2Directory,key3.GetName(),"none")
+                        plotJobs.append((level2Directory,key3.GetName(),"none"))
                 elif re.match ('TH2', key3.GetClassName()) and arguments.draw2DPlots: # found a 2-D histogram
-                    MakeTwoDHist(level2Directory,key3.GetName())
+                    plotJobs.append((level2Directory,key3.GetName(),None))
 
                 elif (key3.GetClassName() == "TDirectoryFile"): # found a directory, cd there and look for histograms
                     level3Directory = level2Directory+"/"+key3.GetName()
@@ -1718,13 +1790,47 @@ for key in inputFile.GetListOfKeys():
                     for key3 in gDirectory.GetListOfKeys():
                         if re.match ('TH1', key3.GetClassName()): # found a 1-D histogram
                             if arguments.makeSignificancePlots or arguments.makeCumulativePlots:
-                                MakeOneDHist(level3Directory,key3.GetName(),"left")
-                                MakeOneDHist(level3Directory,key3.GetName(),"right")
+                                plotJobs.append((level3Directory,key3.GetName(),"left"))
+                                plotJobs.append((level3Directory,key3.GetName(),"right"))
                             else:
-                                MakeOneDHist(level3Directory,key3.GetName(),"none")
+                                plotJobs.append((level3Directory,key3.GetName(),"none"))
                         elif re.match ('TH2', key3.GetClassName()) and arguments.draw2DPlots: # found a 2-D histogram
-                            MakeTwoDHist(level3Directory,key3.GetName())
-
+                            plotJobs.append((level3Directory,key3.GetName(),None))
+
+inputFile.Close()
+
+#### read every histogram that will be needed, opening each input file only once
+LoadHistograms(["%s/%s.root" % (condor_dir,sample) for sample in processed_datasets],
+               sorted(set([plotJob[0] for plotJob in plotJobs])))
+
+#### make the plots, in parallel processes if requested
+nWorkers = min(int(arguments.nWorkers), len(plotJobs)) if arguments.nWorkers else 1
+if nWorkers > 1:
+    outputFile.Close()
+    workerFileNames = [outputDir + "/." + outputFileName + "_worker" + str(i) for i in range(nWorkers)]
+    workers = []
+    for i in range(nWorkers):
+        worker = Process(target=RenderPlotsInWorker, args=(workerFileNames[i], plotJobs[i::nWorkers]))
+        worker.start()
+        workers.append(worker)
+    for worker in workers:
+        worker.join()
+
+    # copy the canvases into the output file in the same order as a serial run
+    outputFile = TFile(outputDir + "/" + outputFileName, "UPDATE")
+    workerFiles = [TFile(workerFileName) for workerFileName in workerFileNames]
+    for i, plotJob in enumerate(plotJobs):
+        canvas = workerFiles[i % nWorkers].Get(plotJob[0] + "/" + canvasNameForPlot(plotJob))
+        if not canvas:
+            continue
+        outputFile.cd(plotJob[0])
+        canvas.Write()
+    for workerFile, workerFileName in zip(workerFiles, workerFileNames):
+        workerFile.Close()
+        os.remove(workerFileName)
+else:
+    for plotJob in plotJobs:
+        MakePlot(plotJob)
 
 outputFile.Close()
 print "Finished writing plots to", str(outputDir + "/" + outputFileName)
@@ -16,6 +16,9 @@ MyVariableProducer::MyVariableProducer(const edm::ParameterSet &cfg) :
     tokens_.pileupinfos = consumes<vector<PileupSummaryInfo> > (collections_.getParameter<edm::InputTag> ("pileupinfos"));
   if (collections_.exists ("triggers"))
     tokens_.triggers = consumes<edm::TriggerResults> (collections_.getParameter<edm::InputTag> ("triggers"));
+
+  // declare the variables this producer adds to the event
+  muonPtSlot_ = declareEventVar ("muonPt");
 }
 
 MyVariableProducer::~MyVariableProducer() {}
@@ -39,7 +42,7 @@ MyVariableProducer::AddVariables (const edm::Event &event) {
     //double value = anatools::getMember(muon1, "pt");
     //addUserVar("muonPt", value, muon1);
   }
-  (*eventvariables)["muonPt"] = muonPt;
+  setEventVar (muonPtSlot_, muonPt);
 }
 
 
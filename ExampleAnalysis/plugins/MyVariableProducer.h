@@ -35,6 +35,7 @@ class MyVariableProducer : public EventVariableProducer
         void getOriginalCollections (const unordered_set<string> &objectsToGet, const edm::Event &event);
         OriginalCollections handles_;
         OriginalTokens tokens_;
+        unsigned muonPtSlot_;
 
     private:
 